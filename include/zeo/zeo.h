@@ -27,6 +27,7 @@
 
 #include <zeo/zeo_mat6d.h>
 #include <zeo/zeo_multishape3d.h>
+#include <zeo/zeo_sdf3d.h>
 #include <zeo/zeo_bv3d.h>
 #include <zeo/zeo_vec3d_profile.h>
 #include <zeo/zeo_voronoi2d.h>
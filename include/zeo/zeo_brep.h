@@ -62,6 +62,63 @@ zListClass( zBREPEdgeList, zBREPEdgeListCell, zBREPEdge );
  */
 __ZEO_EXPORT zBREPEdgeListCell *zBREPEdgeListFind(zBREPEdgeList *elist, zBREPVertListCell *v1, zBREPVertListCell *v2);
 
+/* ********************************************************** */
+/* CLASS: zBREPHash
+ * hash index of B-Rep vertices and edges
+ * ********************************************************** */
+
+typedef struct{
+  void *cell;        /* vertex or edge list cell */
+  unsigned long key; /* hash key */
+  int next;          /* next entry in the same bucket (-1 for the last) */
+} zBREPHashEntry;
+
+typedef struct{
+  int size;              /* number of buckets (a power of two) */
+  int *bucket;           /* head entries of buckets (-1 for an empty bucket) */
+  int num;               /* number of entries */
+  int capacity;          /* size of the entry buffer */
+  zBREPHashEntry *entry; /* entry buffer */
+} zBREPHash;
+
+/* grid size to hash coordinates of vertices */
+#define ZEO_BREP_HASH_GRID ( 1.0e-6 )
+
+/*! \brief hash index of B-Rep vertices and edges.
+ *
+ * zBREPHash is an index of vertex or edge list cells to find a vertex or an edge in a constant
+ * time, instead of walking through the list as zBREPVertListFind() and zBREPEdgeListFind() do.
+ * Vertices are hashed by coordinates quantized with a grid size ZEO_BREP_HASH_GRID, and edges
+ * are hashed by pointers to the terminal vertices. The index has to be updated by the user
+ * whenever a cell is added to the list.
+ *
+ * zBREPHashInit() initializes a hash index \a hash as empty.
+ * zBREPHashDestroy() frees internal buffers of \a hash.
+ *
+ * zBREPVertHashAdd() adds a vertex list cell \a cell to \a hash.
+ * zBREPVertHashFind() finds a vertex list cell which has the same vertex with \a v in the sense
+ * of zVec3DEqual() from \a hash.
+ *
+ * zBREPEdgeHashAdd() adds an edge list cell \a cell to \a hash.
+ * zBREPEdgeHashFind() finds an edge list cell which consists of vertices \a v1 and \a v2 from
+ * \a hash.
+ *
+ * A hash index has to be dedicated either to vertices or to edges.
+ * The buffers of the index grow automatically.
+ * \retval
+ * zBREPHashInit() returns a pointer \a hash.
+ * zBREPVertHashAdd() and zBREPEdgeHashAdd() return the true value if they succeed. If they fail to
+ * allocate memory, the false value is returned.
+ * zBREPVertHashFind() and zBREPEdgeHashFind() return a pointer to the found cell. Otherwise, the
+ * null pointer is returned.
+ */
+__ZEO_EXPORT zBREPHash *zBREPHashInit(zBREPHash *hash);
+__ZEO_EXPORT void zBREPHashDestroy(zBREPHash *hash);
+__ZEO_EXPORT bool zBREPVertHashAdd(zBREPHash *hash, zBREPVertListCell *cell);
+__ZEO_EXPORT zBREPVertListCell *zBREPVertHashFind(const zBREPHash *hash, const zVec3D *v);
+__ZEO_EXPORT bool zBREPEdgeHashAdd(zBREPHash *hash, zBREPEdgeListCell *cell);
+__ZEO_EXPORT zBREPEdgeListCell *zBREPEdgeHashFind(const zBREPHash *hash, const zBREPVertListCell *v1, const zBREPVertListCell *v2);
+
 typedef struct{
   zBREPVertListCell *v[3];
   zBREPEdgeListCell *e[3];
@@ -47,6 +47,9 @@ __ZEO_EXPORT zPH3D *zPH3DTruncBREP(zPH3D *src, zPH3D *cut, zPH3D *dest);
  * \a src1 and \a src2. It is assumed that both \a src1 and
  * \a src2 are convex, or at least, the intersecting part does
  * not contain non-convex shape. If not, anything might happen.
+ * While the conversion to B-Rep and the merge are linear in the
+ * number of faces, the truncation by each other is not (see
+ * zBREPTruncPH3D()).
  * \retval
  * zIntersectPH3DBREP() returns a pointer \a dest if succeeding.
  * Otherwise, the null pointer is returned.
@@ -18,6 +18,9 @@ __BEGIN_DECLS
  *
  * zBREPTruncPH3D() directly truncates \a brep by a polyhedron
  * \a ph. It internally truncate \a brep by all faces of \a ph.
+ * Since each face walks through all vertices, edges and faces
+ * of \a brep, the cost is proportional to the product of the
+ * number of faces of \a ph and the size of \a brep.
  * \return
  * zBREPTrunc() returns a pointer \a brep if it succeeds to create
  * a truncated shape. If it fails to allocate internal workspace,
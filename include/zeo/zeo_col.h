@@ -8,6 +8,7 @@
 #define __ZEO_COL_H__
 
 #include <zeo/zeo_bv3d.h>
+#include <zeo/zeo_shape3d.h>
 
 __BEGIN_DECLS
 
@@ -105,8 +106,14 @@ __END_DECLS
 
 #include <zeo/zeo_col_box.h> /* axis-aligned bounding box (AABB) and oriented bounding box (OBB) */
 #include <zeo/zeo_col_minkowski.h> /* Minkowski sum */
+#include <zeo/zeo_col_support.h> /* support map of convex objects */
 #include <zeo/zeo_col_gjk.h> /* Gilbert-Johnson-Keerthi algorithm */
 #include <zeo/zeo_col_mpr.h> /* Minkowski Portal Refinement algorithm */
 #include <zeo/zeo_col_ph.h>  /* polyhedra */
+#include <zeo/zeo_col_broadphase.h> /* broad-phase culling */
+#include <zeo/zeo_col_batch.h> /* batched narrow-phase checking */
+#include <zeo/zeo_col_toi.h> /* time of impact */
+#include <zeo/zeo_col_shape.h> /* pairwise kernels of shapes */
+#include <zeo/zeo_col_manifold.h> /* contact manifold */
 
 #endif /* __ZEO_COL_H__ */
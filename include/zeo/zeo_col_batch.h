@@ -0,0 +1,62 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_batch - collision checking: batched narrow-phase checking.
+ */
+
+#ifndef __ZEO_COL_BATCH_H__
+#define __ZEO_COL_BATCH_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/*! \brief narrow-phase algorithm identifiers */
+typedef int8_t zColMethod;
+enum{
+  ZEO_COL_GJK=0,    /* GJK algorithm (closest points) */
+  ZEO_COL_MPR,      /* MPR algorithm (intersection only) */
+  ZEO_COL_MPR_DEPTH /* MPR algorithm with penetration depth */
+};
+
+/* ********************************************************** */
+/*! \brief result of narrow-phase collision checking of a pair.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColResult ){
+  bool flag;    /*!< true if the pair collides */
+  zVec3D c1;    /*!< closest point on the first body (ZEO_COL_GJK) */
+  zVec3D c2;    /*!< closest point on the second body (ZEO_COL_GJK) */
+  double depth; /*!< penetration depth (ZEO_COL_MPR_DEPTH) */
+  zVec3D pos;   /*!< contact point (ZEO_COL_MPR_DEPTH) */
+  zVec3D dir;   /*!< direction of penetration (ZEO_COL_MPR_DEPTH) */
+};
+
+/*! \brief batched narrow-phase collision checking.
+ *
+ * zColBatchPH3D() checks collisions of all pairs of convex polyhedra listed in \a ps, which is
+ * typically found by a broad-phase culling such as zColSAPPair() and zColAABBTreePair().
+ * The identifiers of each pair are indices of an array of polyhedra \a ph. \a frame is an array
+ * of frames in which polyhedra are placed. The null pointer can be given for \a frame if all
+ * polyhedra are placed in the identity frame.
+ *
+ * zColBatchShape3D() does the same with zColBatchPH3D() for an array of 3D shapes \a shape.
+ * If ZEO_COL_GJK is specified and \a frame is the null pointer, each pair is checked by
+ * zColShape3D() instead of zGJKSupport(), which uses a closed-form kernel for the pair of types.
+ *
+ * \a method specifies the narrow-phase algorithm, namely, ZEO_COL_GJK for zGJKSupport(),
+ * ZEO_COL_MPR for zMPRSupport(), or ZEO_COL_MPR_DEPTH for zMPRDepthSupport(). The result of the
+ * \a i th pair of \a ps is stored in the \a i th element of \a result, whose size has to be
+ * larger than or equal to the number of pairs. Only members relevant to \a method are set.
+ *
+ * Pairs are checked by \a thread_num threads in parallel (see zParallelFor()). If a non-positive
+ * value is given for \a thread_num, the number of online processors is used. The bodies are
+ * only read, so that one body can appear in multiple pairs.
+ * \return
+ * zColBatchPH3D() and zColBatchShape3D() return the number of colliding pairs.
+ */
+__ZEO_EXPORT int zColBatchPH3D(const zPH3D ph[], const zFrame3D frame[], const zColPairSet *ps, zColMethod method, zColResult result[], int thread_num);
+__ZEO_EXPORT int zColBatchShape3D(const zShape3D shape[], const zFrame3D frame[], const zColPairSet *ps, zColMethod method, zColResult result[], int thread_num);
+
+__END_DECLS
+
+#endif /* __ZEO_COL_BATCH_H__ */
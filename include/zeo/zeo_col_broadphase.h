@@ -0,0 +1,186 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_broadphase - collision checking: broad-phase culling.
+ */
+
+#ifndef __ZEO_COL_BROADPHASE_H__
+#define __ZEO_COL_BROADPHASE_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/*! \brief a set of candidate pairs of colliding bodies.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColPair ){
+  int id1; /*!< identifier of the first body (always smaller than id2) */
+  int id2; /*!< identifier of the second body */
+};
+
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColPairSet ){
+  int num;       /*!< number of pairs */
+  int capacity;  /*!< size of the allocated buffer */
+  zColPair *buf; /*!< buffer of pairs */
+};
+
+#define zColPairSetNum(ps)    (ps)->num
+#define zColPairSetElem(ps,i) ( &(ps)->buf[i] )
+
+/*! \brief initialize, clear, and destroy a set of candidate pairs.
+ *
+ * zColPairSetInit() initializes a set of candidate pairs \a ps.
+ * zColPairSetClear() makes \a ps empty without freeing the internal buffer, so that the buffer
+ * is reused in the next broad-phase query.
+ * zColPairSetDestroy() frees the internal buffer of \a ps.
+ *
+ * zColPairSetAdd() adds a pair of identifiers \a id1 and \a id2 to \a ps. The smaller identifier
+ * is always stored in id1 member. The buffer is doubled when it runs out.
+ * \return
+ * zColPairSetInit() and zColPairSetClear() return a pointer \a ps.
+ * zColPairSetAdd() returns the true value if it succeeds, or the false value if it fails to
+ * allocate memory.
+ */
+__ZEO_EXPORT zColPairSet *zColPairSetInit(zColPairSet *ps);
+#define zColPairSetClear(ps) ( (ps)->num = 0, (ps) )
+__ZEO_EXPORT void zColPairSetDestroy(zColPairSet *ps);
+__ZEO_EXPORT bool zColPairSetAdd(zColPairSet *ps, int id1, int id2);
+
+/* ********************************************************** */
+/*! \brief sweep-and-prune over axis-aligned bounding boxes.
+ *
+ * zColSAP keeps axis-aligned bounding boxes of bodies and the order of them sorted along
+ * a sweep axis. Since the order hardly changes between successive frames, it is updated by
+ * insertion sort, which runs almost linearly with respect to the number of bodies.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColSAP ){
+  int num;        /*!< number of bodies */
+  zAABox3D *box;  /*!< bounding boxes of bodies */
+  int *order;     /*!< identifiers of bodies sorted along the sweep axis */
+  zAxis axis;     /*!< sweep axis */
+};
+
+#define zColSAPNum(sap)   (sap)->num
+#define zColSAPBox(sap,i) ( &(sap)->box[i] )
+
+/*! \brief create and destroy a sweep-and-prune instance.
+ *
+ * zColSAPAlloc() allocates internal buffers of a sweep-and-prune instance \a sap for \a num bodies.
+ * All boxes are initialized to be degenerated at the origin.
+ *
+ * zColSAPDestroy() frees internal buffers of \a sap.
+ * \return
+ * zColSAPAlloc() returns a pointer \a sap if it succeeds. Otherwise, the null pointer is returned.
+ */
+__ZEO_EXPORT zColSAP *zColSAPAlloc(zColSAP *sap, int num);
+__ZEO_EXPORT void zColSAPDestroy(zColSAP *sap);
+
+/*! \brief set a bounding box of a body in sweep-and-prune.
+ *
+ * zColSAPSetBox() sets the axis-aligned bounding box of the \a i th body of \a sap for \a box.
+ * zColSAPSetData() sets the axis-aligned bounding box of a set of 3D points \a data for the
+ * \a i th body of \a sap.
+ * zColSAPSetPH3D() sets the axis-aligned bounding box of a polyhedron \a ph for the \a i th body
+ * of \a sap.
+ * These functions do not re-sort bodies. The order is updated in zColSAPUpdate().
+ * \return
+ * zColSAPSetBox(), zColSAPSetData() and zColSAPSetPH3D() return a pointer to the box stored in
+ * \a sap, or the null pointer if \a i is out of range.
+ */
+__ZEO_EXPORT zAABox3D *zColSAPSetBox(zColSAP *sap, int i, const zAABox3D *box);
+__ZEO_EXPORT zAABox3D *zColSAPSetData(zColSAP *sap, int i, zVec3DData *data);
+__ZEO_EXPORT zAABox3D *zColSAPSetPH3D(zColSAP *sap, int i, const zPH3D *ph);
+
+/*! \brief update sweep-and-prune and find candidate pairs.
+ *
+ * zColSAPUpdate() chooses the axis along which the centers of boxes are the most scattered as
+ * the sweep axis, and incrementally sorts bodies along the axis.
+ *
+ * zColSAPPair() finds all pairs of bodies in \a sap whose bounding boxes overlap with each other
+ * and stores them into \a ps. Previous contents of \a ps are cleared. zColSAPUpdate() is called
+ * internally.
+ * \return
+ * zColSAPPair() returns the number of found pairs, or -1 if it fails to allocate memory.
+ */
+__ZEO_EXPORT void zColSAPUpdate(zColSAP *sap);
+__ZEO_EXPORT int zColSAPPair(zColSAP *sap, zColPairSet *ps);
+
+/* ********************************************************** */
+/*! \brief dynamic AABB tree.
+ *
+ * zColAABBTree is a binary tree of axis-aligned bounding boxes, which can be incrementally
+ * modified. Each leaf keeps a box that is fattened by a margin, so that a body that moves
+ * within the margin does not need to be re-inserted. The tree is kept balanced by local
+ * rotations on insertion and removal.
+ * Nodes are stored in a flat array that grows on demand, and removed nodes are reused.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColAABBTreeNode ){
+  zAABox3D box; /*!< fattened bounding box */
+  int parent;   /*!< index of parent node (-1 for the root) or the next free node */
+  int child[2]; /*!< indices of children (-1 for a leaf) */
+  int height;   /*!< height of the node (0 for a leaf, -1 for a free node) */
+  int id;       /*!< identifier of the body (only valid for a leaf) */
+};
+
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColAABBTree ){
+  int root;                /*!< index of the root node */
+  int capacity;            /*!< size of the allocated node buffer */
+  int freenode;            /*!< head of the list of free nodes */
+  zColAABBTreeNode *node;  /*!< node buffer */
+  double margin;           /*!< margin to fatten leaf boxes */
+};
+
+#define ZEO_COL_AABBTREE_DEFAULT_MARGIN ( 1.0e-2 )
+
+/*! \brief initialize and destroy a dynamic AABB tree.
+ *
+ * zColAABBTreeInit() initializes a dynamic AABB tree \a tree. \a margin is the margin to fatten
+ * boxes of leaves. If a non-positive value is given, ZEO_COL_AABBTREE_DEFAULT_MARGIN is used.
+ *
+ * zColAABBTreeDestroy() frees internal buffer of \a tree.
+ * \return
+ * zColAABBTreeInit() returns a pointer \a tree.
+ */
+__ZEO_EXPORT zColAABBTree *zColAABBTreeInit(zColAABBTree *tree, double margin);
+__ZEO_EXPORT void zColAABBTreeDestroy(zColAABBTree *tree);
+
+/*! \brief insert, remove, and move a body in a dynamic AABB tree.
+ *
+ * zColAABBTreeInsert() inserts a body identified by \a id, which is bounded by a box \a box, into
+ * a dynamic AABB tree \a tree.
+ *
+ * zColAABBTreeRemove() removes the leaf \a leaf from \a tree.
+ *
+ * zColAABBTreeMove() updates the box of the leaf \a leaf for \a box. Only if \a box gets out of
+ * the fattened box stored in \a tree, the leaf is re-inserted.
+ * \return
+ * zColAABBTreeInsert() returns the index of the created leaf, which is required to remove or move
+ * the body, or -1 if it fails to allocate memory.
+ * zColAABBTreeMove() returns the true value if the leaf is re-inserted. Otherwise, the false value
+ * is returned.
+ */
+__ZEO_EXPORT int zColAABBTreeInsert(zColAABBTree *tree, const zAABox3D *box, int id);
+__ZEO_EXPORT void zColAABBTreeRemove(zColAABBTree *tree, int leaf);
+__ZEO_EXPORT bool zColAABBTreeMove(zColAABBTree *tree, int leaf, const zAABox3D *box);
+
+/*! \brief query a dynamic AABB tree.
+ *
+ * zColAABBTreeQuery() finds all bodies in a dynamic AABB tree \a tree whose boxes overlap with
+ * a box \a box, and stores identifiers of them into an array \a id with the size \a size.
+ *
+ * zColAABBTreePair() finds all pairs of bodies in \a tree whose boxes overlap with each other,
+ * and stores them into \a ps. Previous contents of \a ps are cleared.
+ * \return
+ * zColAABBTreeQuery() returns the number of found bodies, which could be larger than \a size.
+ * In such a case, only the first \a size bodies are stored.
+ * zColAABBTreePair() returns the number of found pairs, or -1 if it fails to allocate memory.
+ * \notes
+ * Since the boxes are fattened, the found pairs are conservative candidates of colliding pairs.
+ */
+__ZEO_EXPORT int zColAABBTreeQuery(const zColAABBTree *tree, const zAABox3D *box, int id[], int size);
+__ZEO_EXPORT int zColAABBTreePair(const zColAABBTree *tree, zColPairSet *ps);
+
+__END_DECLS
+
+#endif /* __ZEO_COL_BROADPHASE_H__ */
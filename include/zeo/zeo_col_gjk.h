@@ -24,8 +24,67 @@ __BEGIN_DECLS
  */
 __ZEO_EXPORT bool zGJK(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2);
 __ZEO_EXPORT bool zGJKDepth(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2);
+
+/*! \brief GJK algorithm for convex objects given by support maps.
+ *
+ * zGJKSupport() and zGJKDepthSupport() are the generic versions of zGJK() and zGJKDepth(),
+ * respectively, which accept two convex objects represented by support maps \a support1 and
+ * \a support2.
+ *
+ * zGJKShape3D() and zGJKDepthShape3D() accept two 3D shapes \a shape1 and \a shape2, which are
+ * placed in frames \a frame1 and \a frame2, respectively. The null pointer can be given for
+ * \a frame1 and \a frame2 if the shapes are placed in the identity frame. Primitive shapes are
+ * processed through their analytic support maps without being converted to polyhedra.
+ * \return
+ * The return values of these functions are the same with zGJK() and zGJKDepth().
+ * \sa
+ * zColSupportAssignShape3D
+ */
+__ZEO_EXPORT bool zGJKSupport(zColSupport *support1, zColSupport *support2, zVec3D *c1, zVec3D *c2);
+__ZEO_EXPORT bool zGJKDepthSupport(zColSupport *support1, zColSupport *support2, zVec3D *c1, zVec3D *c2);
+__ZEO_EXPORT bool zGJKShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2, zVec3D *c1, zVec3D *c2);
+__ZEO_EXPORT bool zGJKDepthShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2, zVec3D *c1, zVec3D *c2);
 __ZEO_EXPORT bool zGJKPoint(zVec3DData *data, zVec3D *p, zVec3D *c);
 
+/* ********************************************************** */
+/*! \brief cache of GJK algorithm for temporal coherence.
+ *
+ * zGJKCache memorizes the directions of the support maps that produced vertices of the final
+ * simplex and the last separating axis of a pair of convex objects. Since two objects that move
+ * continuously have similar simplices in successive queries, the next query of the same pair
+ * starts from the simplex re-evaluated at the memorized directions, and converges in a few
+ * iterations in most cases.
+ * Since directions instead of points are memorized, the cache stays valid even if the objects
+ * move between queries.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zGJKCache ){
+  int n;         /*!< number of memorized directions (0 for an empty cache) */
+  zVec3D dir[4]; /*!< directions of support maps for vertices of the last simplex */
+  zVec3D axis;   /*!< last separating axis */
+};
+
+/*! \brief initialize a cache of GJK algorithm.
+ *
+ * zGJKCacheInit() initializes a cache \a cache as empty. A cache has to be initialized before
+ * being used for the first time, and should be re-initialized when it is assigned to another
+ * pair of objects.
+ * \return
+ * zGJKCacheInit() returns a pointer \a cache.
+ */
+__ZEO_EXPORT zGJKCache *zGJKCacheInit(zGJKCache *cache);
+
+/*! \brief warm-started GJK algorithm.
+ *
+ * zGJKWarmStart() and zGJKSupportWarmStart() are the same with zGJK() and zGJKSupport(),
+ * respectively, except that the simplex is seeded from a cache \a cache memorized in the
+ * previous query of the same pair, and the final simplex is memorized to \a cache again.
+ * If \a cache is empty, they work in the same way with zGJK() and zGJKSupport().
+ * \return
+ * The return values of these functions are the same with zGJK().
+ */
+__ZEO_EXPORT bool zGJKWarmStart(zVec3DData *data1, zVec3DData *data2, zGJKCache *cache, zVec3D *c1, zVec3D *c2);
+__ZEO_EXPORT bool zGJKSupportWarmStart(zColSupport *support1, zColSupport *support2, zGJKCache *cache, zVec3D *c1, zVec3D *c2);
+
 __END_DECLS
 
 #endif /* __ZEO_COL_GJK_H__ */
@@ -0,0 +1,102 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_manifold - collision checking: contact manifold.
+ */
+
+#ifndef __ZEO_COL_MANIFOLD_H__
+#define __ZEO_COL_MANIFOLD_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/*! \brief maximum number of contact points in a contact manifold */
+#define ZEO_COL_MANIFOLD_NUM         4
+/*! \brief number of tilted directions to sample a contact feature */
+#define ZEO_COL_MANIFOLD_SAMPLE_NUM  8
+/*! \brief tilt angle of directions to sample a contact feature */
+#define ZEO_COL_MANIFOLD_SAMPLE_TILT ( 1.0e-1 )
+/*! \brief tolerance of heights of points regarded to be on a contact feature relative to the size of an object */
+#define ZEO_COL_MANIFOLD_FEATURE_TOL ( 1.0e-3 )
+/*! \brief distance over which a persistent contact point is discarded */
+#define ZEO_COL_MANIFOLD_BREAK_TOL   ( 1.0e-2 )
+
+/* ********************************************************** */
+/*! \struct zColContact
+ * \brief contact point of two convex objects.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColContact ){
+  zVec3D pos;     /*!< contact point */
+  zVec3D p1;      /*!< contact point on the first object in its frame */
+  zVec3D p2;      /*!< contact point on the second object in its frame */
+  double depth;   /*!< penetration depth along the normal */
+  zVec3D impulse; /*!< accumulated impulse for warm start of a contact solver */
+  int lifetime;   /*!< number of steps for which the contact persists */
+};
+
+/* ********************************************************** */
+/*! \struct zColManifold
+ * \brief contact manifold of two convex objects.
+ *
+ * zColManifold keeps at most ZEO_COL_MANIFOLD_NUM contact points of two convex objects which
+ * share a common normal.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColManifold ){
+  zVec3D normal; /*!< contact normal directing from the first object to the second */
+  int num;       /*!< number of contact points */
+  zColContact contact[ZEO_COL_MANIFOLD_NUM]; /*!< contact points */
+};
+
+#define zColManifoldNum(m)       (m)->num
+#define zColManifoldNormal(m)    ( &(m)->normal )
+#define zColManifoldContact(m,i) ( &(m)->contact[i] )
+
+/*! \brief initialize a contact manifold.
+ *
+ * zColManifoldInit() initializes a contact manifold \a manifold as empty.
+ * \return
+ * zColManifoldInit() returns a pointer \a manifold.
+ */
+__ZEO_EXPORT zColManifold *zColManifoldInit(zColManifold *manifold);
+
+/*! \brief contact manifold of two convex objects.
+ *
+ * zColManifoldSupport() computes the contact manifold of two convex objects represented by support
+ * maps \a support1 and \a support2, and stores it into \a manifold.
+ * The contact normal and the penetration depth are found by zMPRDepthSupport(). Then, the contact
+ * features of the objects, namely, faces, edges or vertices facing each other, are found by sampling
+ * the support maps in ZEO_COL_MANIFOLD_SAMPLE_NUM directions tilted from the normal by
+ * ZEO_COL_MANIFOLD_SAMPLE_TILT. Points on the features are those whose heights along the normal are
+ * within ZEO_COL_MANIFOLD_FEATURE_TOL times the size of the object from the extreme. The features
+ * are projected onto a plane perpendicular to the normal, and one is clipped by the other. The depth
+ * of each clipped point is measured from the plane of the feature which clips the other. If more
+ * than ZEO_COL_MANIFOLD_NUM points remain, the deepest one and others which span the largest area
+ * are chosen.
+ * Hence, polyhedra and boxes in face-to-face contact have up to four contact points, while a
+ * curved object has a single contact point.
+ *
+ * \a manifold is persistent across steps of a simulation. Contact points newly found inherit the
+ * accumulated impulses and lifetimes of those in \a manifold at the previous step within the
+ * distance ZEO_COL_MANIFOLD_BREAK_TOL. If only one contact point is found, the previous points
+ * are also kept as long as they are, being moved with the objects, neither separated nor slid
+ * further than ZEO_COL_MANIFOLD_BREAK_TOL, so that a manifold of a curved object grows over
+ * steps.
+ *
+ * zColManifoldPH3D() accepts two convex polyhedra \a ph1 and \a ph2 placed in frames \a frame1
+ * and \a frame2, respectively.
+ * zColManifoldShape3D() accepts two 3D shapes \a shape1 and \a shape2 placed in frames \a frame1
+ * and \a frame2, respectively.
+ * The null pointer can be given for \a frame1 and \a frame2 if the objects are placed in the
+ * identity frame.
+ * \return
+ * These functions return the true value if the objects are in collision. Otherwise, the false
+ * value is returned, and \a manifold is emptied.
+ */
+__ZEO_EXPORT bool zColManifoldSupport(zColSupport *support1, zColSupport *support2, zColManifold *manifold);
+__ZEO_EXPORT bool zColManifoldPH3D(const zPH3D *ph1, const zFrame3D *frame1, const zPH3D *ph2, const zFrame3D *frame2, zColManifold *manifold);
+__ZEO_EXPORT bool zColManifoldShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2, zColManifold *manifold);
+
+__END_DECLS
+
+#endif /* __ZEO_COL_MANIFOLD_H__ */
@@ -23,11 +23,30 @@ __BEGIN_DECLS
  * in \a depth, \a pos and \a dir, respectively.
  * \return
  * zMPR() and zMPRDepth() return the true value if the two objects are in collisiond.
- * Otherwise, the false value is returned.
+ * Otherwise, the false value is returned. The false value is also returned if a support map
+ * of either object fails, e.g. for an empty object, or if the portal does not converge within
+ * Z_MAX_ITER_NUM iterations.
  */
 __ZEO_EXPORT bool zMPR(zVec3DData *data1, zVec3DData *data2);
 __ZEO_EXPORT bool zMPRDepth(zVec3DData *data1, zVec3DData *data2, double *depth, zVec3D *pos, zVec3D *dir);
 
+/*! \brief MPR algorithm for convex objects given by support maps.
+ *
+ * zMPRSupport() and zMPRDepthSupport() are the generic versions of zMPR() and zMPRDepth(),
+ * respectively, which accept two convex objects represented by support maps \a support1 and
+ * \a support2.
+ *
+ * zMPRShape3D() and zMPRDepthShape3D() accept two 3D shapes \a shape1 and \a shape2, which are
+ * placed in frames \a frame1 and \a frame2, respectively. The null pointer can be given for
+ * \a frame1 and \a frame2 if the shapes are placed in the identity frame.
+ * \return
+ * The return values of these functions are the same with zMPR() and zMPRDepth().
+ */
+__ZEO_EXPORT bool zMPRSupport(zColSupport *support1, zColSupport *support2);
+__ZEO_EXPORT bool zMPRDepthSupport(zColSupport *support1, zColSupport *support2, double *depth, zVec3D *pos, zVec3D *dir);
+__ZEO_EXPORT bool zMPRShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2);
+__ZEO_EXPORT bool zMPRDepthShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2, double *depth, zVec3D *pos, zVec3D *dir);
+
 __END_DECLS
 
 #endif /* __ZEO_COL_MPR_H__ */
@@ -0,0 +1,52 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_shape - collision checking: pairwise kernels of 3D shapes.
+ */
+
+#ifndef __ZEO_COL_SHAPE_H__
+#define __ZEO_COL_SHAPE_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/*! \brief closest points between primitive 3D shapes.
+ *
+ * zColSphere3D() finds the closest points of two 3D spheres \a s1 and \a s2.
+ * zColSphereCapsule3D() finds the closest points of a 3D sphere \a sphere and a 3D capsule \a capsule.
+ * zColCapsule3D() finds the closest points of two 3D capsules \a c1 and \a c2.
+ * zColSphereBox3D() finds the closest points of a 3D sphere \a sphere and a 3D box \a box.
+ * The closest points on the first and second shapes are stored into \a p1 and \a p2, respectively.
+ * If the shapes intersect, a common point of them is stored into both \a p1 and \a p2.
+ * They are analytically computed in closed forms.
+ * \return
+ * These functions return the true value if the shapes are in collision. Otherwise, the false
+ * value is returned.
+ */
+__ZEO_EXPORT bool zColSphere3D(const zSphere3D *s1, const zSphere3D *s2, zVec3D *p1, zVec3D *p2);
+__ZEO_EXPORT bool zColSphereCapsule3D(const zSphere3D *sphere, const zCapsule3D *capsule, zVec3D *p1, zVec3D *p2);
+__ZEO_EXPORT bool zColCapsule3D(const zCapsule3D *c1, const zCapsule3D *c2, zVec3D *p1, zVec3D *p2);
+__ZEO_EXPORT bool zColSphereBox3D(const zSphere3D *sphere, const zBox3D *box, zVec3D *p1, zVec3D *p2);
+
+/*! \brief collision checking of two 3D shapes dispatched by types.
+ *
+ * zColShape3D() finds the closest points of two 3D shapes \a shape1 and \a shape2, and stores
+ * them into \a c1 and \a c2, respectively, in the same way with zGJKShape3D().
+ *
+ * zColChkShape3D() only checks if \a shape1 and \a shape2 are in collision with each other.
+ *
+ * A kernel specialized for the pair of types of the shapes is chosen from a dispatch table, namely,
+ * sphere-sphere, sphere-capsule, capsule-capsule and sphere-box pairs are processed in closed
+ * forms, and a box-box pair is checked by the separating axis test (zColChkBox3D()) in
+ * zColChkShape3D(). The other pairs fall back to zGJKShape3D().
+ * \return
+ * zColShape3D() and zColChkShape3D() return the true value if the shapes are in collision.
+ * Otherwise, the false value is returned.
+ */
+__ZEO_EXPORT bool zColShape3D(const zShape3D *shape1, const zShape3D *shape2, zVec3D *c1, zVec3D *c2);
+__ZEO_EXPORT bool zColChkShape3D(const zShape3D *shape1, const zShape3D *shape2);
+
+__END_DECLS
+
+#endif /* __ZEO_COL_SHAPE_H__ */
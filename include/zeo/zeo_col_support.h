@@ -0,0 +1,76 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_support - collision checking: support map of convex objects.
+ */
+
+#ifndef __ZEO_COL_SUPPORT_H__
+#define __ZEO_COL_SUPPORT_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/*! \brief support map of a convex object.
+ *
+ * zColSupport abstracts a convex object in GJK and MPR algorithms. A convex object is accessed
+ * only through the support map, which returns the farthest point of the object in a given
+ * direction, and a point inside of the object.
+ * The object is placed in a frame, which is applied to the support map on the fly. Hence,
+ * the object itself does not have to be transformed.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zColSupport ){
+  void *body;            /*!< convex object */
+  const zFrame3D *frame; /*!< frame of the object (the null pointer for the identity frame) */
+  zVec3D *(* _supportmap)(void*,const zVec3D*,zVec3D*); /*!< support map in the object frame */
+  zVec3D *(* _center)(void*,zVec3D*); /*!< a point inside of the object in the object frame */
+};
+
+/*! \brief assign a convex object to a support map.
+ *
+ * zColSupportAssignVec3DData() assigns the convex hull of a set of 3D points \a data to a support
+ * map \a support.
+ *
+ * zColSupportAssignPH3D() assigns the convex hull of a 3D polyhedron \a ph to \a support.
+ *
+ * zColSupportAssignPH3DAdj() assigns a convex polyhedron with vertex adjacency \a adj to
+ * \a support. The support map is found by hill-climbing from the vertex found in the previous
+ * query (see zPH3DAdjSupportMap()), which is much faster than zColSupportAssignPH3D() for a
+ * polyhedron with many vertices, e.g., a convex hull of a large set of points.
+ *
+ * zColSupportAssignShape3D() assigns a 3D shape \a shape to \a support. For primitive shapes, the
+ * support map is analytically computed without converting them to polyhedra.
+ *
+ * For zColSupportAssignPH3D(), zColSupportAssignPH3DAdj() and zColSupportAssignShape3D(), \a frame is a frame in which the
+ * object is placed. If the null pointer is given for \a frame, the object is supposed to be
+ * placed in the identity frame.
+ * \return
+ * zColSupportAssignVec3DData(), zColSupportAssignPH3D(), zColSupportAssignPH3DAdj() and
+ * zColSupportAssignShape3D() return a pointer \a support.
+ * \notes
+ * \a support refers \a data, \a ph, \a adj, \a shape and \a frame directly. They have to be kept alive
+ * while \a support is used.
+ */
+__ZEO_EXPORT zColSupport *zColSupportAssignVec3DData(zColSupport *support, zVec3DData *data);
+__ZEO_EXPORT zColSupport *zColSupportAssignPH3D(zColSupport *support, const zPH3D *ph, const zFrame3D *frame);
+__ZEO_EXPORT zColSupport *zColSupportAssignPH3DAdj(zColSupport *support, zPH3DAdj *adj, const zFrame3D *frame);
+__ZEO_EXPORT zColSupport *zColSupportAssignShape3D(zColSupport *support, const zShape3D *shape, const zFrame3D *frame);
+
+/*! \brief support map and inner point of a convex object.
+ *
+ * zColSupportMap() finds the farthest point of a convex object assigned to \a support in a
+ * direction \a dir, and puts it into \a sp.
+ *
+ * zColSupportCenter() finds a point inside of the convex object assigned to \a support, and puts
+ * it into \a center. The barycenter of the object is chosen if it is available.
+ * \return
+ * zColSupportMap() returns a pointer \a sp, or the null pointer if it fails.
+ * zColSupportCenter() returns a pointer \a center, or the null pointer if the support map fails.
+ */
+__ZEO_EXPORT zVec3D *zColSupportMap(const zColSupport *support, const zVec3D *dir, zVec3D *sp);
+__ZEO_EXPORT zVec3D *zColSupportCenter(const zColSupport *support, zVec3D *center);
+
+__END_DECLS
+
+#endif /* __ZEO_COL_SUPPORT_H__ */
@@ -0,0 +1,55 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_toi - collision checking: time of impact of moving convex objects.
+ */
+
+#ifndef __ZEO_COL_TOI_H__
+#define __ZEO_COL_TOI_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/*! \brief distance regarded as contact in time of impact computation */
+#define ZEO_COL_TOI_TOL     ( 1.0e-6 )
+/*! \brief maximum number of iterations of conservative advancement */
+#define ZEO_COL_TOI_MAXITER 100
+
+/*! \brief time of impact of two moving convex objects.
+ *
+ * zColTOISupport() finds the earliest time when two convex objects represented by support maps
+ * \a support1 and \a support2 get into contact while they move from frames \a frame1_start and
+ * \a frame2_start to \a frame1_end and \a frame2_end, respectively. Each object is supposed to
+ * move in a unit time with a constant linear velocity and a constant angular velocity, namely,
+ * its position is linearly interpolated and its attitude rotates about a fixed axis.
+ * The time is normalized in [0, 1] and is stored into \a toi. The closest points of the objects
+ * at the time are stored into \a c1 and \a c2.
+ * The frames assigned to \a support1 and \a support2 are ignored, and restored on return.
+ *
+ * The time is found by the conservative advancement, which repeatedly advances the time by the
+ * distance between the objects found by zGJKSupport() divided by an upper bound of the
+ * approaching speed. Hence, the objects never pass through each other between sampled times,
+ * unlike repeated static tests at discrete times. The iteration stops when the distance gets
+ * less than ZEO_COL_TOI_TOL.
+ *
+ * zColTOIVec3DData() accepts the convex hulls of two sets of 3D points \a data1 and \a data2,
+ * which are given in their own frames.
+ * zColTOIPH3D() accepts two convex polyhedra \a ph1 and \a ph2 given in their own frames.
+ * zColTOIShape3D() accepts two 3D shapes \a shape1 and \a shape2 given in their own frames.
+ * \return
+ * These functions return the true value if the objects get into contact in the motion. If they
+ * are already in contact at the start, zero is stored into \a toi. If the iteration does not
+ * converge in ZEO_COL_TOI_MAXITER steps, the time reached is returned as the time of impact,
+ * which is not later than the true one.
+ * If the objects do not contact each other, the false value is returned. \a toi, \a c1 and \a c2
+ * are not modified in this case.
+ */
+__ZEO_EXPORT bool zColTOISupport(zColSupport *support1, const zFrame3D *frame1_start, const zFrame3D *frame1_end, zColSupport *support2, const zFrame3D *frame2_start, const zFrame3D *frame2_end, double *toi, zVec3D *c1, zVec3D *c2);
+__ZEO_EXPORT bool zColTOIVec3DData(zVec3DData *data1, const zFrame3D *frame1_start, const zFrame3D *frame1_end, zVec3DData *data2, const zFrame3D *frame2_start, const zFrame3D *frame2_end, double *toi, zVec3D *c1, zVec3D *c2);
+__ZEO_EXPORT bool zColTOIPH3D(const zPH3D *ph1, const zFrame3D *frame1_start, const zFrame3D *frame1_end, const zPH3D *ph2, const zFrame3D *frame2_start, const zFrame3D *frame2_end, double *toi, zVec3D *c1, zVec3D *c2);
+__ZEO_EXPORT bool zColTOIShape3D(const zShape3D *shape1, const zFrame3D *frame1_start, const zFrame3D *frame1_end, const zShape3D *shape2, const zFrame3D *frame2_start, const zFrame3D *frame2_end, double *toi, zVec3D *c1, zVec3D *c2);
+
+__END_DECLS
+
+#endif /* __ZEO_COL_TOI_H__ */
@@ -394,6 +394,20 @@ __ZEO_EXPORT double zTri3DSignedClosest(const zTri3D *tri, const zVec3D *point,
 /*! \brief signed distance from a 3D point to a 3D triangle. */
 __ZEO_EXPORT double zTri3DSignedDistFromPoint(const zTri3D *tri, const zVec3D *point);
 
+/*! \brief ray casting on a 3D triangle.
+ *
+ * zTri3DRaycast() finds the intersection of a ray from \a org in a direction \a dir with a 3D
+ * triangle \a tri based on Moller-Trumbore algorithm. The intersection point is org + t dir, where
+ * t is the ray parameter in [0, \a tmax]. t and the normal vector of \a tri are stored into \a t
+ * and \a normal, respectively. The null pointer is accepted for \a normal. The triangle is hit
+ * from both sides.
+ * A segment from p1 to p2 is tested by giving p2 - p1 for \a dir and 1 for \a tmax.
+ * \return
+ * zTri3DRaycast() returns the true value if the ray hits \a tri. Otherwise, the false value is
+ * returned.
+ */
+__ZEO_EXPORT bool zTri3DRaycast(const zTri3D *tri, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief check if a point is inside of a triangle.
  *
  * zTri3DPointIsInside() checks if the given point \a point is inside of a triangle \a tri.
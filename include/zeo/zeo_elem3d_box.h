@@ -95,6 +95,28 @@ __ZEO_EXPORT double zAABox3DSqrDistFromPoint(const zAABox3D *box, const zVec3D *
 /*! \brief check if a point is inside of a 3D axis-aligned box. */
 __ZEO_EXPORT bool zAABox3DPointIsInside(const zAABox3D *box, const zVec3D *point, double margin);
 
+/*! \brief ray casting on a 3D axis-aligned box.
+ *
+ * zAABox3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with the
+ * surface of a 3D axis-aligned box \a box. The intersection point is org + t dir, where t is the
+ * ray parameter in [0, \a tmax]. t and the outward normal vector of \a box at the intersection are
+ * stored into \a t and \a normal, respectively. The null pointer is accepted for \a normal.
+ * If \a org is inside of \a box, the exit point is found.
+ *
+ * zAABox3DRayIsIntersect() checks if the segment of the ray in [0, \a tmax] passes through \a box,
+ * including the case where \a org is inside of \a box. The ray parameter at which the ray enters
+ * \a box (0 if \a org is inside) is stored into \a tnear.
+ *
+ * A segment from p1 to p2 is tested by giving p2 - p1 for \a dir and 1 for \a tmax.
+ * \return
+ * zAABox3DRaycast() returns the true value if the ray hits \a box. Otherwise, the false value is
+ * returned.
+ * zAABox3DRayIsIntersect() returns the true value if the ray passes through \a box. Otherwise, the
+ * false value is returned.
+ */
+__ZEO_EXPORT bool zAABox3DRaycast(const zAABox3D *box, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+__ZEO_EXPORT bool zAABox3DRayIsIntersect(const zAABox3D *box, const zVec3D *org, const zVec3D *dir, double tmax, double *tnear);
+
 /*! \brief compute volume of a 3D axis-aligned box. */
 __ZEO_EXPORT double zAABox3DVolume(const zAABox3D *box);
 
@@ -104,11 +126,77 @@ __ZEO_EXPORT zVec3D *zAABox3DVert(const zAABox3D *box, int i, zVec3D *v);
 /*! \brief enlarge a 3D axis-aligned box. */
 __ZEO_EXPORT zAABox3D *zAABox3DEnlarge(zAABox3D *aabox, const zVec3D *v);
 
+/*! \brief the axis along the longest side of a 3D axis-aligned box. */
+__ZEO_EXPORT zAxis zAABox3DLongestAxis(const zAABox3D *box);
+
 /*! \brief print out a 3D axis-aligned box to a file. */
 __ZEO_EXPORT void zAABox3DFPrint(FILE *fp, const zAABox3D *box);
 /*! \brief print out a 3D axis-aligned box to a file in a gnuplot-friendly format. */
 __ZEO_EXPORT void zAABox3DValueFPrint(FILE *fp, const zAABox3D *box);
 
+/* ********************************************************** */
+/*! \struct zAABox3DTree
+ * \brief balanced binary tree of 3D axis-aligned boxes on a flat array.
+ *
+ * zAABox3DTree is a static tree built at once over a set of primitives, each of which is given
+ * by an axis-aligned bounding box and a center point. A node is split at the median of centers
+ * along the longest side of the box of centers in it, until the number of primitives gets less
+ * than or equal to the size of leaf buckets.
+ * All nodes are stored in a single array, and indices of primitives are sorted by leaves, so
+ * that each leaf refers a contiguous range of them. It is the common base of zVec3DFlatTree,
+ * zPH3DBVH and zMultiShape3DRaycaster.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zAABox3DTreeNode ){
+  zAABox3D box;  /*!< bounding box of primitives in the node */
+  int child[2];  /*!< indices of children (-1 for a leaf) */
+  int start;     /*!< index of the first primitive in the node */
+  int num;       /*!< number of primitives in the node */
+};
+
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zAABox3DTree ){
+  int node_num;            /*!< number of nodes */
+  int node_capacity;       /*!< size of node buffer */
+  zAABox3DTreeNode *node;  /*!< node buffer (the first is the root) */
+  int *index;              /*!< indices of primitives sorted by leaves */
+};
+
+/*! \brief check if a node of a tree of 3D axis-aligned boxes is a leaf. */
+#define zAABox3DTreeNodeIsLeaf(node) ( (node)->child[0] < 0 )
+
+/*! \brief initialize, create, and destroy a tree of 3D axis-aligned boxes.
+ *
+ * zAABox3DTreeInit() initializes a tree of 3D axis-aligned boxes \a tree as empty.
+ *
+ * zAABox3DTreeCreate() builds \a tree over \a num primitives, the i-th of which has a bounding
+ * box \a box[i] and a center \a center[i]. If the null pointer is given for \a box, the primitives
+ * are regarded as points at \a center. \a leafsize is the maximum number of primitives in a leaf.
+ *
+ * zAABox3DTreeDestroy() frees internal arrays of \a tree.
+ * \return
+ * zAABox3DTreeInit() returns a pointer \a tree.
+ * zAABox3DTreeCreate() returns a pointer \a tree if it succeeds. If it fails to allocate memory,
+ * the null pointer is returned.
+ */
+__ZEO_EXPORT zAABox3DTree *zAABox3DTreeInit(zAABox3DTree *tree);
+__ZEO_EXPORT zAABox3DTree *zAABox3DTreeCreate(zAABox3DTree *tree, const zAABox3D box[], const zVec3D center[], int num, int leafsize);
+__ZEO_EXPORT void zAABox3DTreeDestroy(zAABox3DTree *tree);
+
+/*! \brief ray casting on a tree of 3D axis-aligned boxes.
+ *
+ * zAABox3DTreeRaycast() finds the first primitive hit by a ray from \a org in a direction \a dir
+ * in a tree of 3D axis-aligned boxes \a tree. Only leaves whose boxes the ray passes through are
+ * visited, and the child that the ray enters first is visited first. For each primitive in a
+ * visited leaf, \a raycast is called with the index of the primitive, \a org, \a dir, the ray
+ * parameter of the current first hit (initially \a tmax), a pointer to store the ray parameter
+ * at the hit point and \a util. It has to return the true value only if the ray hits the
+ * primitive within the given range, and can store information of the hit in \a util.
+ * The ray parameter of the first hit is stored into \a t.
+ * \return
+ * zAABox3DTreeRaycast() returns the true value if the ray hits a primitive. Otherwise, the false
+ * value is returned.
+ */
+__ZEO_EXPORT bool zAABox3DTreeRaycast(const zAABox3DTree *tree, const zVec3D *org, const zVec3D *dir, double tmax, double *t, bool (* raycast)(int, const zVec3D *, const zVec3D *, double, double *, void *), void *util);
+
 __END_DECLS
 
 #ifdef __cplusplus
@@ -251,6 +339,25 @@ __ZEO_EXPORT double zBox3DClosest(const zBox3D *box, const zVec3D *p, zVec3D *cp
 __ZEO_EXPORT double zBox3DDistFromPoint(const zBox3D *box, const zVec3D *p);
 __ZEO_EXPORT bool zBox3DPointIsInside(const zBox3D *box, const zVec3D *p, double margin);
 
+/*! \brief support map of a 3D box.
+ *
+ * zBox3DSupportMap() finds the farthest point of a 3D box \a box in a direction \a dir,
+ * and puts it into \a sp.
+ * \return
+ * zBox3DSupportMap() returns a pointer \a sp.
+ */
+__ZEO_EXPORT zVec3D *zBox3DSupportMap(const zBox3D *box, const zVec3D *dir, zVec3D *sp);
+
+/*! \brief ray casting on a 3D box.
+ *
+ * zBox3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with the
+ * surface of a 3D box \a box in the same way with zAABox3DRaycast().
+ * \return
+ * zBox3DRaycast() returns the true value if the ray hits \a box. Otherwise, the false value is
+ * returned.
+ */
+__ZEO_EXPORT bool zBox3DRaycast(const zBox3D *box, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief volume of a box.
  *
  * zBox3DVolume() calculates the volume of a box \a box.
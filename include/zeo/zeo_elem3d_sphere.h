@@ -99,6 +99,28 @@ __ZEO_EXPORT double zSphere3DClosest(const zSphere3D *sphere, const zVec3D *poin
 __ZEO_EXPORT double zSphere3DDistFromPoint(const zSphere3D *sphere, const zVec3D *point);
 __ZEO_EXPORT bool zSphere3DPointIsInside(const zSphere3D *sphere, const zVec3D *point, double margin);
 
+/*! \brief support map of a 3D sphere.
+ *
+ * zSphere3DSupportMap() finds the farthest point of a 3D sphere \a sphere in a direction \a dir,
+ * and puts it into \a sp.
+ * \return
+ * zSphere3DSupportMap() returns a pointer \a sp.
+ */
+__ZEO_EXPORT zVec3D *zSphere3DSupportMap(const zSphere3D *sphere, const zVec3D *dir, zVec3D *sp);
+
+/*! \brief ray casting on a 3D sphere.
+ *
+ * zSphere3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with
+ * the surface of a 3D sphere \a sphere. The intersection point is org + t dir, where t is the ray
+ * parameter in [0, \a tmax]. t and the outward normal vector at the intersection are stored into
+ * \a t and \a normal, respectively. The null pointer is accepted for \a normal. If \a org is
+ * inside of \a sphere, the exit point is found.
+ * \return
+ * zSphere3DRaycast() returns the true value if the ray hits \a sphere. Otherwise, the false value
+ * is returned.
+ */
+__ZEO_EXPORT bool zSphere3DRaycast(const zSphere3D *sphere, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief create a 3D sphere from two points at both ends of diameter. */
 __ZEO_EXPORT zSphere3D *zSphere3DFrom2(zSphere3D *sphere, const zVec3D *v1, const zVec3D *v2);
 
@@ -76,6 +76,7 @@
 
 #define ZEO_ERR_VEC3DDATA_SIZEMISMATCH        "size mismatch between two sets of 3D points %d / %d"
 #define ZEO_ERR_VEC3DDATA_IDENTFRAME_TOOFEWPOINTS "too few points to identify the transformation: %d"
+#define ZEO_ERR_VEC3DDATA_VOXEL_INVALIDPITCH  "invalid size of voxels: %g"
 
 #define ZEO_ERR_STL_UNREADABLE                "unreadable file. probably not a STL file."
 #define ZEO_ERR_STL_INCOMPLETE                "incomplete STL file"
@@ -129,12 +130,23 @@
 
 #define ZEO_ERR_BREP_CONV                     "cannot convert polyhedron to B-Rep solid"
 
+#define ZEO_ERR_COL_BROADPHASE_INVALID_ID     "%d: invalid identifier of a body specified."
+#define ZEO_ERR_COL_BROADPHASE_INVALID_LEAF   "%d: invalid leaf of AABB tree specified."
+#define ZEO_ERR_COL_BATCH_INVALID_METHOD      "%d: invalid narrow-phase method specified."
+
 #define ZEO_ERR_COLCHK_LINE_PARALLEL          "lines are parallel"
 #define ZEO_ERR_COLCHK_PLANE_IDENT            "planes are identical"
 #define ZEO_ERR_COLCHK_PLANE_PARALLEL         "planes are parallel"
 
 #define ZEO_ERR_OCTREE_POINT_OUTOFREGION      "point out of region"
 
+/* signed distance field */
+#define ZEO_ERR_SDF3D_INVALID_SIZE            "invalid size of a signed distance field: %d x %d x %d"
+#define ZEO_ERR_SDF3D_INVALID_PITCH           "invalid pitch of a signed distance field: %g"
+#define ZEO_ERR_SDF3D_EMPTY                   "empty shape assigned for a signed distance field"
+#define ZEO_ERR_SDF3D_UNREADABLE              "unreadable file. probably not a signed distance field file."
+#define ZEO_ERR_SDF3D_INCOMPLETE              "incomplete signed distance field file"
+
 #define ZEO_ERR_TERRA_INVALIDGRIDSIZE         "grid size unspecified"
 #define ZEO_ERR_TERRA_INVALIDRESOLUTION       "too fine (or negative) grid resolution"
 #define ZEO_ERR_TERRA_OUTOFREGION             "out of region (%g,%g): cannot estimate ground height"
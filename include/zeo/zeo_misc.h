@@ -77,6 +77,39 @@ __ZEO_EXPORT zDir zDirFromStr(const char *str);
  */
 __ZEO_EXPORT zDir zDirRev(zDir dir);
 
+/*! \brief real roots of a quadratic equation for ray casting.
+ *
+ * zQuadraticRealRoots() finds real roots of a quadratic equation a t^2 + 2 b t + c = 0 with respect
+ * to t, and stores them into \a t in ascending order. If \a a is tiny, the equation is solved as a
+ * linear equation. It is a common subroutine to intersect a ray with quadric surfaces.
+ * \return
+ * zQuadraticRealRoots() returns the number of real roots, which is 0, 1 or 2.
+ */
+__ZEO_EXPORT int zQuadraticRealRoots(double a, double b, double c, double t[2]);
+
+/*! \brief parallel loop.
+ *
+ * zParallelThreadNum() returns the number of threads to be used. If a positive value is given
+ * for \a thread_num, it is returned as is. Otherwise, the number of online processors is returned.
+ *
+ * zParallelFor() divides a loop over indices from 0 to \a num-1 into chunks, and processes them
+ * by \a thread_num threads in parallel. Each chunk is processed by \a func as
+ *   func( util, id, start, end )
+ * where \a util is a pointer to an arbitrary data shared by all threads, \a id is the identifier
+ * of the thread that is always less than zParallelThreadNum( \a thread_num ), and \a start and
+ * \a end are the first index and the next to the last index of the chunk, respectively. Chunks are
+ * assigned to threads dynamically, so that the load is balanced even if the cost of each index
+ * varies. \a func can use \a id to access working memory prepared for each thread in advance.
+ *
+ * Threads are available only if the library is compiled with the option CONFIG_USE_PTHREAD.
+ * Otherwise, or if \a num is too small to be divided, the whole loop is processed by the caller
+ * thread as func( util, 0, 0, num ).
+ * \return
+ * zParallelFor() returns the number of threads actually used.
+ */
+__ZEO_EXPORT int zParallelThreadNum(int thread_num);
+__ZEO_EXPORT int zParallelFor(int num, int thread_num, void (* func)(void*,int,int,int), void *util);
+
 __END_DECLS
 
 #endif /* __ZEO_MISC_H__ */
@@ -177,4 +177,6 @@ inline zMultiShape3D *zMultiShape3D::readZTK(const char filename[]){ return zMul
 inline bool zMultiShape3D::writeZTK(const char filename[]){ return zMultiShape3DWriteZTK( this, filename ); }
 #endif /* __cplusplus */
 
+#include <zeo/zeo_multishape3d_raycast.h>
+
 #endif /* __ZEO_MULTISHAPE3D_H__ */
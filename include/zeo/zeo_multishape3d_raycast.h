@@ -0,0 +1,84 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_multishape3d_raycast - ray casting on multiple 3D shapes.
+ */
+
+#ifndef __ZEO_MULTISHAPE3D_RAYCAST_H__
+#define __ZEO_MULTISHAPE3D_RAYCAST_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/*! \brief result of ray casting on multiple 3D shapes.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zMultiShape3DRayHit ){
+  int shape;     /*!< index of the hit shape (-1 if the ray hits nothing) */
+  double t;      /*!< ray parameter at the hit point */
+  zVec3D pos;    /*!< hit point */
+  zVec3D normal; /*!< outward normal vector of the surface at the hit point */
+};
+
+/* ********************************************************** */
+/*! \struct zMultiShape3DRaycaster
+ * \brief ray caster on multiple 3D shapes.
+ *
+ * zMultiShape3DRaycaster accelerates ray casting on a scene of multiple 3D shapes. It keeps an
+ * axis-aligned bounding box of each shape, and a binary tree of those boxes (see zAABox3DTree).
+ * For a polyhedron, a bounding volume hierarchy of faces is also built.
+ * A NURBS surface is tessellated into a polyhedron in advance, and is treated as a polyhedron.
+ * Other primitive shapes are tested analytically.
+ * The shapes are not copied. Once created, the ray caster is not modified by queries, so that it
+ * can be shared by multiple threads.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zMultiShape3DRaycaster ){
+  const zMultiShape3D *ms;  /*!< multiple shapes */
+  zAABox3D *box;            /*!< bounding boxes of shapes */
+  zPH3D *ph;                /*!< tessellated NURBS surfaces (empty for other shapes) */
+  zPH3DBVH *bvh;            /*!< hierarchies of faces of polyhedra (empty for other shapes) */
+  zAABox3DTree boxtree;     /*!< tree of boxes of shapes */
+};
+
+/*! \brief default number of shapes in a leaf of a ray caster */
+#define ZEO_MULTISHAPE3D_RAYCASTER_LEAFSIZE 2
+
+/*! \brief create and destroy a ray caster on multiple 3D shapes.
+ *
+ * zMultiShape3DRaycasterCreate() creates a ray caster \a rc on multiple 3D shapes \a ms.
+ *
+ * zMultiShape3DRaycasterDestroy() frees internal arrays of \a rc.
+ * \return
+ * zMultiShape3DRaycasterCreate() returns a pointer \a rc if it succeeds. If it fails to allocate
+ * memory, the null pointer is returned.
+ * \notes
+ * \a rc refers \a ms directly. It has to be kept alive and unchanged while \a rc is used. If
+ * shapes in \a ms are moved, \a rc has to be re-created.
+ */
+__ZEO_EXPORT zMultiShape3DRaycaster *zMultiShape3DRaycasterCreate(zMultiShape3DRaycaster *rc, const zMultiShape3D *ms);
+__ZEO_EXPORT void zMultiShape3DRaycasterDestroy(zMultiShape3DRaycaster *rc);
+
+/*! \brief ray casting on multiple 3D shapes.
+ *
+ * zMultiShape3DRaycasterRaycast() finds the first shape hit by a ray from \a org in a direction
+ * \a dir by a ray caster \a rc. The hit point is org + t dir, where t is the ray parameter in
+ * [0, \a tmax]. The index of the hit shape, t, the hit point and the outward normal vector at the
+ * point are stored into \a hit. A segment from p1 to p2 is tested with \a org = p1,
+ * \a dir = p2 - p1 and \a tmax = 1.
+ *
+ * zMultiShape3DRaycasterRaycastBatch() casts \a num rays from \a org[i] in directions \a dir[i]
+ * (i=0, ..., \a num-1), and stores the results into \a hit[i]. The rays are processed by
+ * \a thread_num threads in parallel (see zParallelFor()). If a non-positive value is given for
+ * \a thread_num, the number of online processors is used.
+ * \return
+ * zMultiShape3DRaycasterRaycast() returns the true value if the ray hits a shape. Otherwise, the
+ * false value is returned and the shape member of \a hit is set for -1.
+ * zMultiShape3DRaycasterRaycastBatch() returns the number of rays that hit shapes.
+ */
+__ZEO_EXPORT bool zMultiShape3DRaycasterRaycast(const zMultiShape3DRaycaster *rc, const zVec3D *org, const zVec3D *dir, double tmax, zMultiShape3DRayHit *hit);
+__ZEO_EXPORT int zMultiShape3DRaycasterRaycastBatch(const zMultiShape3DRaycaster *rc, const zVec3D org[], const zVec3D dir[], int num, double tmax, zMultiShape3DRayHit hit[], int thread_num);
+
+__END_DECLS
+
+#endif /* __ZEO_MULTISHAPE3D_RAYCAST_H__ */
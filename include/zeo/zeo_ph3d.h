@@ -177,6 +177,67 @@ __ZEO_EXPORT zPH3D *zPH3DXformInv(const zPH3D *src, const zFrame3D *frame, zPH3D
  */
 __ZEO_EXPORT const zVec3D *zPH3DContigVert(const zPH3D *ph, const zVec3D *point, double *distance);
 
+/*! \brief support map of a 3D polyhedron.
+ *
+ * zPH3DSupportMap() finds the farthest vertex of a 3D polyhedron \a ph in a direction \a dir.
+ * \return
+ * zPH3DSupportMap() returns a pointer to the found vertex of \a ph, or the null pointer if \a ph
+ * has no vertices.
+ */
+__ZEO_EXPORT const zVec3D *zPH3DSupportMap(const zPH3D *ph, const zVec3D *dir);
+
+/* ********************************************************** */
+/*! \brief vertex adjacency of a convex polyhedron.
+ *
+ * zPH3DAdj keeps the list of adjacent vertices of each vertex of a convex polyhedron in the
+ * compressed row form, namely, the vertices adjacent to the i-th vertex are stored in
+ * index[offset[i]] ... index[offset[i+1]-1].
+ * It also memorizes the vertex found in the latest query of the support map, from which the
+ * next query starts hill-climbing.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zPH3DAdj ){
+  const zPH3D *ph; /*!< polyhedron */
+  int *offset;     /*!< offsets of adjacent vertices of each vertex */
+  int *index;      /*!< indices of adjacent vertices */
+  int hint;        /*!< vertex found in the latest query */
+};
+
+/*! \brief create and destroy vertex adjacency of a convex polyhedron.
+ *
+ * zPH3DAdjInit() initializes vertex adjacency \a adj.
+ *
+ * zPH3DAdjCreate() creates vertex adjacency \a adj of a convex polyhedron \a ph from its faces.
+ * \a adj refers \a ph directly, so that \a ph has to be kept alive while \a adj is used. \a adj
+ * has to be re-created if the topology of \a ph changes, while coordinates of vertices can be
+ * changed freely.
+ *
+ * zPH3DAdjDestroy() frees internal arrays of \a adj.
+ * \return
+ * zPH3DAdjInit() returns a pointer \a adj.
+ * zPH3DAdjCreate() returns a pointer \a adj if it succeeds. If it fails to allocate memory or
+ * \a ph has an invalid face, the null pointer is returned.
+ */
+__ZEO_EXPORT zPH3DAdj *zPH3DAdjInit(zPH3DAdj *adj);
+__ZEO_EXPORT zPH3DAdj *zPH3DAdjCreate(zPH3DAdj *adj, const zPH3D *ph);
+__ZEO_EXPORT void zPH3DAdjDestroy(zPH3DAdj *adj);
+
+/*! \brief support map of a convex polyhedron by hill-climbing.
+ *
+ * zPH3DAdjSupportMap() finds the farthest vertex of a convex polyhedron in a direction \a dir
+ * with the help of vertex adjacency \a adj. It starts from the vertex found in the previous
+ * query, or from a vertex referred by a face if that is unavailable or isolated, and climbs up
+ * to the adjacent vertex which is the farthest in \a dir until no farther vertex is found. Since the objective is linear, the local maximum is the global maximum on
+ * a convex polyhedron. The cost is roughly proportional to the square root of the number of
+ * vertices, and is almost constant when successive directions are close to each other.
+ * If \a adj has no adjacency, it falls back to zPH3DSupportMap().
+ * \return
+ * zPH3DAdjSupportMap() returns a pointer to the found vertex, or the null pointer if the
+ * polyhedron has no vertices.
+ * \notes
+ * The result is not guaranteed to be the farthest for a non-convex polyhedron.
+ */
+__ZEO_EXPORT const zVec3D *zPH3DAdjSupportMap(zPH3DAdj *adj, const zVec3D *dir);
+
 /*! \brief check if a point is inside of a 3D polyhedron.
  *
  * zPH3DClosest() finds the closest point from a point \a point on a 3D polyhedron \a ph. The result is
@@ -195,6 +256,19 @@ __ZEO_EXPORT double zPH3DClosest(const zPH3D *ph, const zVec3D *point, zVec3D *c
 __ZEO_EXPORT double zPH3DDistFromPoint(const zPH3D *ph, const zVec3D *point);
 __ZEO_EXPORT bool zPH3DPointIsInside(const zPH3D *ph, const zVec3D *point, double margin);
 
+/*! \brief ray casting on a 3D polyhedron.
+ *
+ * zPH3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with faces
+ * of a 3D polyhedron \a ph. The intersection point is org + t dir, where t is the ray parameter in
+ * [0, \a tmax]. t and the normal vector of the hit face are stored into \a t and \a normal,
+ * respectively. The null pointer is accepted for \a normal. The index of the hit face is stored
+ * into \a face unless the null pointer is given.
+ * It tests all faces one by one. See zPH3DBVHRaycast() for a large polyhedron.
+ * \return
+ * zPH3DRaycast() returns the true value if the ray hits \a ph. Otherwise, the false value is returned.
+ */
+__ZEO_EXPORT bool zPH3DRaycast(const zPH3D *ph, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal, int *face);
+
 /*! \brief volume of a 3D polyhedron.
  *
  * zPH3DVolume() calculates the volume of a polyhedron \a ph.
@@ -354,6 +428,9 @@ inline void zPH3D::fprintZTK(FILE *fp){ zPH3DFPrintZTK( fp, this ); }
 #include <zeo/zeo_ph3d_ply.h>
 #include <zeo/zeo_ph3d_obj.h>
 
+#include <zeo/zeo_ph3d_bvh.h>
+#include <zeo/zeo_ph3d_halfspace.h>
+
 #ifdef __ZEO_USE_DAE
 #include <zeo/zeo_ph3d_dae.h>
 #endif /* __ZEO_USE_DAE */
@@ -0,0 +1,95 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_ph3d_bvh - bounding volume hierarchy of faces of a polyhedron.
+ */
+
+#ifndef __ZEO_PH3D_BVH_H__
+#define __ZEO_PH3D_BVH_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/*! \struct zPH3DBVH
+ * \brief bounding volume hierarchy of faces of a 3D polyhedron.
+ *
+ * zPH3DBVH is a binary tree of axis-aligned bounding boxes built over faces of a 3D polyhedron,
+ * which accelerates proximity queries on a large mesh. Faces are split at the median of their
+ * centroids along the longest side of the box of a node (see zAABox3DTree). The polyhedron is
+ * not copied, and is not required to be convex.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zPH3DBVH ){
+  const zPH3D *ph;       /*!< polyhedron */
+  zAABox3DTree boxtree;  /*!< tree of boxes of faces */
+  int leafsize;          /*!< maximum number of faces in a leaf */
+};
+
+/*! \brief default size of leaf buckets of a bounding volume hierarchy */
+#define ZEO_PH3D_BVH_DEFAULT_LEAFSIZE 4
+
+/*! \brief the i-th face in a bounding volume hierarchy. */
+#define zPH3DBVHFace(bvh,i) zPH3DFace( (bvh)->ph, (bvh)->boxtree.index[i] )
+
+/*! \brief initialize, create, and destroy a bounding volume hierarchy of a polyhedron.
+ *
+ * zPH3DBVHInit() initializes a bounding volume hierarchy \a bvh as empty.
+ *
+ * zPH3DBVHCreate() builds \a bvh over faces of a 3D polyhedron \a ph. \a leafsize is the maximum
+ * number of faces in a leaf. If a non-positive value is given, ZEO_PH3D_BVH_DEFAULT_LEAFSIZE is used.
+ *
+ * zPH3DBVHDestroy() frees internal arrays of \a bvh.
+ * \return
+ * zPH3DBVHInit() returns a pointer \a bvh.
+ * zPH3DBVHCreate() returns a pointer \a bvh if it succeeds. If it fails to allocate memory, the
+ * null pointer is returned.
+ * \notes
+ * \a bvh refers \a ph directly. It has to be kept alive and unchanged while \a bvh is used.
+ */
+__ZEO_EXPORT zPH3DBVH *zPH3DBVHInit(zPH3DBVH *bvh);
+__ZEO_EXPORT zPH3DBVH *zPH3DBVHCreate(zPH3DBVH *bvh, const zPH3D *ph, int leafsize);
+__ZEO_EXPORT void zPH3DBVHDestroy(zPH3DBVH *bvh);
+
+/*! \brief closest point and distance from a point to a polyhedron by a bounding volume hierarchy.
+ *
+ * zPH3DBVHClosest() finds the closest point on the surface of a polyhedron that a bounding volume
+ * hierarchy \a bvh is built over from a point \a point, and puts it into \a closestpoint. The index
+ * of the face on which the closest point lies is stored into \a face unless the null pointer is
+ * given for it.
+ *
+ * zPH3DBVHSignedClosest() does the same with zPH3DBVHClosest(), but the distance is negative if
+ * \a point is inside of the polyhedron. The inside and outside are distinguished by the normal
+ * vector of the closest face, where the face that faces \a point the most squarely is chosen
+ * among faces that share the closest point, e.g., at an edge or a vertex.
+ *
+ * zPH3DBVHDistFromPoint() and zPH3DBVHSignedDistFromPoint() return the distance and the signed
+ * distance from \a point to the polyhedron, respectively.
+ *
+ * Unlike zPH3DClosest(), they give the exact closest point of a non-convex polyhedron. The
+ * polyhedron is supposed to be closed and the normal vectors of all faces to direct outward for
+ * signed distance.
+ * \return
+ * zPH3DBVHClosest() and zPH3DBVHDistFromPoint() return the distance from \a point to the
+ * polyhedron.
+ * zPH3DBVHSignedClosest() and zPH3DBVHSignedDistFromPoint() return the signed distance.
+ * If \a bvh is empty, HUGE_VAL is returned and \a point is copied to \a closestpoint.
+ */
+__ZEO_EXPORT double zPH3DBVHClosest(const zPH3DBVH *bvh, const zVec3D *point, zVec3D *closestpoint, int *face);
+__ZEO_EXPORT double zPH3DBVHSignedClosest(const zPH3DBVH *bvh, const zVec3D *point, zVec3D *closestpoint, int *face);
+__ZEO_EXPORT double zPH3DBVHDistFromPoint(const zPH3DBVH *bvh, const zVec3D *point);
+__ZEO_EXPORT double zPH3DBVHSignedDistFromPoint(const zPH3DBVH *bvh, const zVec3D *point);
+
+/*! \brief ray casting on a polyhedron by a bounding volume hierarchy.
+ *
+ * zPH3DBVHRaycast() does the same with zPH3DRaycast() for the polyhedron that a bounding volume
+ * hierarchy \a bvh is built over, while only faces in boxes that the ray passes through are tested.
+ * \return
+ * zPH3DBVHRaycast() returns the true value if the ray hits the polyhedron. Otherwise, the false
+ * value is returned.
+ */
+__ZEO_EXPORT bool zPH3DBVHRaycast(const zPH3DBVH *bvh, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal, int *face);
+
+__END_DECLS
+
+#endif /* __ZEO_PH3D_BVH_H__ */
@@ -0,0 +1,81 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_ph3d_halfspace - half-space representation of a convex polyhedron.
+ */
+
+#ifndef __ZEO_PH3D_HALFSPACE_H__
+#define __ZEO_PH3D_HALFSPACE_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/*! \struct zPH3DHalfSpace
+ * \brief half-space representation of a convex polyhedron.
+ *
+ * zPH3DHalfSpace represents a convex polyhedron as the intersection of half-spaces
+ * nx x + ny y + nz z <= d, which are supporting planes of faces. Coplanar faces share one
+ * plane. Components of normal vectors and offsets are stored in separate arrays
+ * (structure of arrays), so that a point test over planes and points is evaluated in a loop
+ * vectorized by the compiler.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zPH3DHalfSpace ){
+  int num;    /*!< number of planes */
+  double *nx; /*!< x-components of outward normals */
+  double *ny; /*!< y-components of outward normals */
+  double *nz; /*!< z-components of outward normals */
+  double *d;  /*!< offsets of planes */
+};
+
+#define zPH3DHalfSpaceNum(hs) (hs)->num
+
+/*! \brief number of points processed at once in batched tests */
+#define ZEO_PH3D_HALFSPACE_BLOCK 64
+
+/*! \brief initialize, create, and destroy a half-space representation of a convex polyhedron.
+ *
+ * zPH3DHalfSpaceInit() initializes a half-space representation \a hs as empty.
+ *
+ * zPH3DHalfSpaceCreate() creates \a hs of a convex polyhedron \a ph from supporting planes of its
+ * faces. Faces whose normal vectors and offsets coincide within zTOL are merged into one plane.
+ *
+ * zPH3DHalfSpaceDestroy() frees internal arrays of \a hs.
+ * \return
+ * zPH3DHalfSpaceInit() returns a pointer \a hs.
+ * zPH3DHalfSpaceCreate() returns a pointer \a hs if it succeeds. If it fails to allocate memory,
+ * the null pointer is returned.
+ * \notes
+ * zPH3DHalfSpaceCreate() assumes that \a ph is convex, \a ph is closed, and the normal vectors of
+ * all facets of \a ph direct outward, as well as zPH3DPointIsInside().
+ */
+__ZEO_EXPORT zPH3DHalfSpace *zPH3DHalfSpaceInit(zPH3DHalfSpace *hs);
+__ZEO_EXPORT zPH3DHalfSpace *zPH3DHalfSpaceCreate(zPH3DHalfSpace *hs, const zPH3D *ph);
+__ZEO_EXPORT void zPH3DHalfSpaceDestroy(zPH3DHalfSpace *hs);
+
+/*! \brief check if points are inside of a convex polyhedron in a half-space representation.
+ *
+ * zPH3DHalfSpacePointIsInside() checks if a point \a point is inside of a convex polyhedron
+ * represented by half-spaces \a hs. \a margin is a margin of the inside area outward from the
+ * boundary, as well as zPH3DPointIsInside().
+ *
+ * zPH3DHalfSpacePointIsInsideBatch() checks \a num points \a point in the same way, and stores
+ * the results into \a inside, whose size has to be larger than or equal to \a num. The null
+ * pointer can be given for \a inside if only the number of inside points is needed.
+ * Points are processed in blocks of ZEO_PH3D_HALFSPACE_BLOCK, for each of which the maximum
+ * signed distance from planes is accumulated plane by plane. The inner loop over points in a
+ * block is free from branches, and is vectorized by the compiler. Blocks are processed by
+ * \a thread_num threads in parallel (see zParallelFor()). If a non-positive value is given for
+ * \a thread_num, the number of online processors is used.
+ * \return
+ * zPH3DHalfSpacePointIsInside() returns the true value if \a point is inside. Otherwise, the
+ * false value is returned.
+ * zPH3DHalfSpacePointIsInsideBatch() returns the number of points inside.
+ */
+__ZEO_EXPORT bool zPH3DHalfSpacePointIsInside(const zPH3DHalfSpace *hs, const zVec3D *point, double margin);
+__ZEO_EXPORT int zPH3DHalfSpacePointIsInsideBatch(const zPH3DHalfSpace *hs, const zVec3D point[], int num, double margin, bool inside[], int thread_num);
+
+__END_DECLS
+
+#endif /* __ZEO_PH3D_HALFSPACE_H__ */
@@ -0,0 +1,119 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_sdf3d - signed distance field on a voxel grid.
+ */
+
+#ifndef __ZEO_SDF3D_H__
+#define __ZEO_SDF3D_H__
+
+#include <zeo/zeo_multishape3d.h>
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/*! \struct zSDF3D
+ * \brief signed distance field on a voxel grid.
+ *
+ * zSDF3D keeps signed distances from 3D shapes sampled at points of a regular grid, which are
+ * negative inside of the shapes. The distance and its gradient at an arbitrary point are
+ * approximated by trilinear interpolation of the values at the eight surrounding grid points,
+ * so that a query takes a constant time regardless of the complexity of the shapes.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zSDF3D ){
+  zVec3D origin; /*!< position of the grid point (0,0,0) */
+  double pitch;  /*!< interval of grid points */
+  int num[3];    /*!< numbers of grid points along x, y and z axes */
+  double *val;   /*!< signed distances at grid points (x runs the fastest) */
+};
+
+#define zSDF3DNum(sdf,axis)    (sdf)->num[(int)(axis)]
+#define zSDF3DPitch(sdf)       (sdf)->pitch
+#define zSDF3DOrigin(sdf)      ( &(sdf)->origin )
+#define zSDF3DIndex(sdf,i,j,k) ( ( (k)*(sdf)->num[zY] + (j) )*(sdf)->num[zX] + (i) )
+#define zSDF3DVal(sdf,i,j,k)   (sdf)->val[zSDF3DIndex(sdf,i,j,k)]
+
+/*! \brief initialize, allocate, and destroy a signed distance field.
+ *
+ * zSDF3DInit() initializes a signed distance field \a sdf as empty.
+ *
+ * zSDF3DAlloc() allocates a grid of \a nx x \a ny x \a nz points for \a sdf, which are arranged
+ * at intervals \a pitch from \a origin. Each number of grid points has to be more than one, and
+ * the size of the grid in bytes has to be within the range of int.
+ * All values are initialized to be zero.
+ *
+ * zSDF3DDestroy() frees the internal array of \a sdf.
+ * \return
+ * zSDF3DInit() returns a pointer \a sdf.
+ * zSDF3DAlloc() returns a pointer \a sdf if it succeeds. If the given size is invalid or it fails
+ * to allocate memory, the null pointer is returned.
+ */
+__ZEO_EXPORT zSDF3D *zSDF3DInit(zSDF3D *sdf);
+__ZEO_EXPORT zSDF3D *zSDF3DAlloc(zSDF3D *sdf, const zVec3D *origin, double pitch, int nx, int ny, int nz);
+__ZEO_EXPORT void zSDF3DDestroy(zSDF3D *sdf);
+
+/*! \brief bake a signed distance field of 3D shapes.
+ *
+ * zSDF3DFromShape3D() creates a signed distance field \a sdf of a 3D shape \a shape. The grid
+ * covers the axis-aligned bounding box of \a shape expanded by \a margin at intervals \a pitch.
+ *
+ * zSDF3DFromMultiShape3D() creates \a sdf of multiple 3D shapes \a ms in the same way. The value
+ * at each grid point is the minimum of signed distances from all shapes.
+ *
+ * Grid points are evaluated by \a thread_num threads in parallel (see zParallelFor()). If a
+ * non-positive value is given for \a thread_num, the number of online processors is used.
+ * The distance from a polyhedron is computed with zPH3DBVHSignedDistFromPoint(). The distance
+ * outside of a primitive shape is computed analytically, while the depth inside of it is computed
+ * from a polyhedron converted from the shape. A NURBS surface is not supposed to be closed, and
+ * the unsigned distance from it is stored.
+ * \return
+ * zSDF3DFromShape3D() and zSDF3DFromMultiShape3D() return a pointer \a sdf if they succeed.
+ * If \a pitch is non-positive, the shapes are empty, or they fail to allocate memory, the null
+ * pointer is returned.
+ */
+__ZEO_EXPORT zSDF3D *zSDF3DFromShape3D(zSDF3D *sdf, const zShape3D *shape, double pitch, double margin, int thread_num);
+__ZEO_EXPORT zSDF3D *zSDF3DFromMultiShape3D(zSDF3D *sdf, const zMultiShape3D *ms, double pitch, double margin, int thread_num);
+
+/*! \brief signed distance and its gradient in a signed distance field.
+ *
+ * zSDF3DDist() computes the signed distance at a point \a point by trilinear interpolation of a
+ * signed distance field \a sdf.
+ *
+ * zSDF3DGrad() computes the signed distance at \a point and its gradient with respect to \a point,
+ * and puts the gradient into \a grad. The gradient is that of the interpolated field, and is not
+ * normalized.
+ *
+ * If \a point is out of the grid, the value at the closest point on the boundary of the grid plus
+ * the distance to it is returned, which is an upper bound of the true distance.
+ * \return
+ * zSDF3DDist() and zSDF3DGrad() return the signed distance. If \a sdf is empty, HUGE_VAL is
+ * returned.
+ */
+__ZEO_EXPORT double zSDF3DDist(const zSDF3D *sdf, const zVec3D *point);
+__ZEO_EXPORT double zSDF3DGrad(const zSDF3D *sdf, const zVec3D *point, zVec3D *grad);
+
+/*! \brief read and write a signed distance field from/to a binary file.
+ *
+ * zSDF3DFWrite() writes a signed distance field \a sdf to the current position of a file \a fp in
+ * a binary format. zSDF3DWriteFile() writes \a sdf to a file \a filename.
+ *
+ * zSDF3DFRead() reads a signed distance field from the current position of \a fp, and stores it
+ * into \a sdf. zSDF3DReadFile() reads \a sdf from a file \a filename.
+ *
+ * The file begins with an identifier "ZSDF3D", which is followed by the numbers of grid points,
+ * the origin, the pitch and all the values in the native byte order. The numbers and the pitch
+ * are validated by zSDF3DAlloc() before the values are read.
+ * \return
+ * zSDF3DFWrite() and zSDF3DWriteFile() return the true value if they succeed. Otherwise, the
+ * false value is returned.
+ * zSDF3DFRead() and zSDF3DReadFile() return a pointer \a sdf if they succeed. Otherwise, the null
+ * pointer is returned.
+ */
+__ZEO_EXPORT bool zSDF3DFWrite(FILE *fp, const zSDF3D *sdf);
+__ZEO_EXPORT zSDF3D *zSDF3DFRead(FILE *fp, zSDF3D *sdf);
+__ZEO_EXPORT bool zSDF3DWriteFile(const zSDF3D *sdf, const char filename[]);
+__ZEO_EXPORT zSDF3D *zSDF3DReadFile(zSDF3D *sdf, const char filename[]);
+
+__END_DECLS
+
+#endif /* __ZEO_SDF3D_H__ */
@@ -27,6 +27,8 @@ ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zShape3DCom ){
   double (* _closest)(void*,const zVec3D*,zVec3D*);
   double (* _distfrompoint)(void*,const zVec3D*);
   bool (* _pointisinside)(void*,const zVec3D*,double);
+  zVec3D *(* _supportmap)(void*,const zVec3D*,zVec3D*);
+  bool (* _raycast)(void*,const zVec3D*,const zVec3D*,double,double*,zVec3D*);
   double (* _volume)(void*);
   zVec3D *(* _barycenter)(void*,zVec3D*);
   zMat3D *(* _baryinertia_m)(void*,double,zMat3D*);
@@ -64,6 +66,8 @@ ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zShape3D ){
   double distanceFromPoint(const zVec3D &point);
   bool pointIsInside(const zVec3D *point, double margin);
   bool pointIsInside(const zVec3D &point, double margin);
+  zVec3D *supportMap(const zVec3D *dir, zVec3D *sp);
+  bool raycast(const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
   double volume();
   zVec3D *barycenter(zVec3D *center);
   zVec3D barycenter();
@@ -153,6 +157,40 @@ __ZEO_EXPORT double zShape3DClosest(const zShape3D *shape, const zVec3D *point,
 __ZEO_EXPORT double zShape3DDistFromPoint(const zShape3D *shape, const zVec3D *point);
 __ZEO_EXPORT bool zShape3DPointIsInside(const zShape3D *shape, const zVec3D *point, double margin);
 
+/*! \brief support map of a 3D shape.
+ *
+ * zShape3DSupportMap() finds the farthest point of a 3D shape \a shape in a direction \a dir, and puts
+ * it into \a sp. It is analytically computed for primitive shapes without converting them to polyhedra.
+ * For a NURBS surface, the farthest control point is found, so that the result is a conservative
+ * support map of the surface.
+ * \return
+ * zShape3DSupportMap() returns a pointer \a sp, or the null pointer if \a shape is empty.
+ */
+__ZEO_EXPORT zVec3D *zShape3DSupportMap(const zShape3D *shape, const zVec3D *dir, zVec3D *sp);
+
+/*! \brief axis-aligned bounding box of a 3D shape.
+ *
+ * zShape3DAABB() computes the axis-aligned bounding box of a 3D shape \a shape from support maps
+ * in six directions along the axes, and puts it into \a box. It is conservative for a NURBS surface.
+ * \return
+ * zShape3DAABB() returns a pointer \a box, or the null pointer if \a shape is empty.
+ */
+__ZEO_EXPORT zAABox3D *zShape3DAABB(const zShape3D *shape, zAABox3D *box);
+
+/*! \brief ray casting against a 3D shape.
+ *
+ * zShape3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with
+ * a 3D shape \a shape in the same way with zSphere3DRaycast(). The intersection point is at
+ * \a org + \a t \a dir, where \a t is within [0, \a tmax]. The outward normal vector of the
+ * surface at the intersection point is stored in \a normal unless the null pointer is given.
+ * It is analytically computed for primitive shapes. A NURBS surface is tessellated into a
+ * polyhedron at every call, which is slow.
+ * \return
+ * zShape3DRaycast() returns the true value if the ray intersects with \a shape. Otherwise,
+ * the false value is returned.
+ */
+__ZEO_EXPORT bool zShape3DRaycast(const zShape3D *shape, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief volume of a 3D shape. */
 __ZEO_EXPORT double zShape3DVolume(const zShape3D *shape);
 /*! \brief barycenter of a 3D shape. */
@@ -318,6 +356,8 @@ inline double zShape3D::distanceFromPoint(const zVec3D *point){ return zShape3DD
 inline double zShape3D::distanceFromPoint(const zVec3D &point){ return zShape3DDistFromPoint( this, &point ); }
 inline bool zShape3D::pointIsInside(const zVec3D *point, double margin = zTOL){ return zShape3DPointIsInside( this, point, margin ); }
 inline bool zShape3D::pointIsInside(const zVec3D &point, double margin = zTOL){ return zShape3DPointIsInside( this, &point, margin ); }
+inline zVec3D *zShape3D::supportMap(const zVec3D *dir, zVec3D *sp){ return zShape3DSupportMap( this, dir, sp ); }
+inline bool zShape3D::raycast(const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){ return zShape3DRaycast( this, org, dir, tmax, t, normal ); }
 inline double zShape3D::volume(){ return zShape3DVolume( this ); }
 inline zVec3D *zShape3D::barycenter(zVec3D *center){ return zShape3DBarycenter( this, center ); }
 inline zVec3D zShape3D::barycenter(){ zVec3D center; zShape3DBarycenter( this, &center ); return center; }
@@ -76,6 +76,25 @@ __ZEO_EXPORT double zCapsule3DClosest(const zCapsule3D *capsule, const zVec3D *p
 __ZEO_EXPORT double zCapsule3DDistFromPoint(const zCapsule3D *capsule, const zVec3D *point);
 __ZEO_EXPORT bool zCapsule3DPointIsInside(const zCapsule3D *capsule, const zVec3D *point, double margin);
 
+/*! \brief support map of a 3D capsule.
+ *
+ * zCapsule3DSupportMap() finds the farthest point of a 3D capsule \a capsule in a direction \a dir,
+ * and puts it into \a sp.
+ * \return
+ * zCapsule3DSupportMap() returns a pointer \a sp.
+ */
+__ZEO_EXPORT zVec3D *zCapsule3DSupportMap(const zCapsule3D *capsule, const zVec3D *dir, zVec3D *sp);
+
+/*! \brief ray casting on a 3D capsule.
+ *
+ * zCapsule3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with
+ * the surface of a 3D capsule \a capsule in the same way with zSphere3DRaycast().
+ * \return
+ * zCapsule3DRaycast() returns the true value if the ray hits \a capsule. Otherwise, the false value is
+ * returned.
+ */
+__ZEO_EXPORT bool zCapsule3DRaycast(const zCapsule3D *capsule, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief axis vector and height of a 3D capsule.
  *
  * zCapsule3DAxis() calculates the axis vector of a 3D capsule \a capsule;
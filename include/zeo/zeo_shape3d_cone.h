@@ -80,6 +80,25 @@ __ZEO_EXPORT double zCone3DClosest(const zCone3D *cone, const zVec3D *point, zVe
 __ZEO_EXPORT double zCone3DDistFromPoint(const zCone3D *cone, const zVec3D *point);
 __ZEO_EXPORT bool zCone3DPointIsInside(const zCone3D *cone, const zVec3D *point, double margin);
 
+/*! \brief support map of a 3D cone.
+ *
+ * zCone3DSupportMap() finds the farthest point of a 3D cone \a cone in a direction \a dir,
+ * and puts it into \a sp.
+ * \return
+ * zCone3DSupportMap() returns a pointer \a sp.
+ */
+__ZEO_EXPORT zVec3D *zCone3DSupportMap(const zCone3D *cone, const zVec3D *dir, zVec3D *sp);
+
+/*! \brief ray casting on a 3D cone.
+ *
+ * zCone3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with
+ * the surface of a 3D cone \a cone in the same way with zSphere3DRaycast().
+ * \return
+ * zCone3DRaycast() returns the true value if the ray hits \a cone. Otherwise, the false value is
+ * returned.
+ */
+__ZEO_EXPORT bool zCone3DRaycast(const zCone3D *cone, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief axis vector and height of a 3D cone.
  *
  * zCone3DAxis() calculates the axis vector of a 3D cone \a cone; the axis
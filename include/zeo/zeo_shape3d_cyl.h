@@ -80,6 +80,25 @@ __ZEO_EXPORT double zCyl3DClosest(const zCyl3D *cyl, const zVec3D *point, zVec3D
 __ZEO_EXPORT double zCyl3DDistFromPoint(const zCyl3D *cyl, const zVec3D *point);
 __ZEO_EXPORT bool zCyl3DPointIsInside(const zCyl3D *cyl, const zVec3D *point, double margin);
 
+/*! \brief support map of a 3D cylinder.
+ *
+ * zCyl3DSupportMap() finds the farthest point of a 3D cylinder \a cyl in a direction \a dir,
+ * and puts it into \a sp.
+ * \return
+ * zCyl3DSupportMap() returns a pointer \a sp.
+ */
+__ZEO_EXPORT zVec3D *zCyl3DSupportMap(const zCyl3D *cyl, const zVec3D *dir, zVec3D *sp);
+
+/*! \brief ray casting on a 3D cylinder.
+ *
+ * zCyl3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with
+ * the surface of a 3D cylinder \a cyl in the same way with zSphere3DRaycast().
+ * \return
+ * zCyl3DRaycast() returns the true value if the ray hits \a cyl. Otherwise, the false value is
+ * returned.
+ */
+__ZEO_EXPORT bool zCyl3DRaycast(const zCyl3D *cyl, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief axis vector and height of a 3D cylinder.
  *
  * zCyl3DAxis() calculates the axis vector of a 3D cylinder \a cyl;
@@ -61,6 +61,25 @@ __ZEO_EXPORT double zECyl3DDistFromPoint(const zECyl3D *cyl, const zVec3D *point
 /*! \brief check if a point is inside of an elliptic cylinder. */
 __ZEO_EXPORT bool zECyl3DPointIsInside(const zECyl3D *ecyl, const zVec3D *point, double margin);
 
+/*! \brief support map of a 3D elliptic cylinder.
+ *
+ * zECyl3DSupportMap() finds the farthest point of a 3D elliptic cylinder \a ecyl in a direction \a dir,
+ * and puts it into \a sp.
+ * \return
+ * zECyl3DSupportMap() returns a pointer \a sp.
+ */
+__ZEO_EXPORT zVec3D *zECyl3DSupportMap(const zECyl3D *ecyl, const zVec3D *dir, zVec3D *sp);
+
+/*! \brief ray casting on a 3D elliptic cylinder.
+ *
+ * zECyl3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with
+ * the surface of a 3D elliptic cylinder \a ecyl in the same way with zSphere3DRaycast().
+ * \return
+ * zECyl3DRaycast() returns the true value if the ray hits \a ecyl. Otherwise, the false value is
+ * returned.
+ */
+__ZEO_EXPORT bool zECyl3DRaycast(const zECyl3D *ecyl, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief axis vector a 3D elliptic cylinder. */
 #define zECyl3DAxis(cyl,axis) \
   zVec3DSub( zECyl3DCenter(cyl,1), zECyl3DCenter(cyl,0), axis )
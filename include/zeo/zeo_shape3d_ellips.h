@@ -85,6 +85,16 @@ __ZEO_EXPORT zEllips3D *zEllips3DXformInv(const zEllips3D *src, const zFrame3D *
  * zEllips3DClosest() calculates the closest point from a 3D
  * point \a p to a 3D ellipsoid \a ellips, and puts it into \a cp.
  * When \a p is inside of \a ellips, it copies \a p to \a cp.
+ * The closest point is found by Newton's method on a scalar equation,
+ * which needs no memory allocation.
+ *
+ * zEllips3DClosestBatch() calculates the closest points from \a num
+ * 3D points \a p to \a ellips, and puts them into \a cp. The
+ * distances are put into \a dist. Either of \a cp and \a dist can
+ * be the null pointer if it is not needed. The points are processed
+ * by \a thread_num threads in parallel (see zParallelFor()). If a
+ * non-positive value is given for \a thread_num, the number of online
+ * processors is used.
  *
  * zEllips3DDistFromPoint() calculates the distance from a 3D point
  * \a p to a 3D ellipsoid \a ellips.
@@ -102,9 +112,29 @@ __ZEO_EXPORT zEllips3D *zEllips3DXformInv(const zEllips3D *src, const zFrame3D *
  * inside of \a ellips, or the false value otherwise.
  */
 __ZEO_EXPORT double zEllips3DClosest(const zEllips3D *ellips, const zVec3D *p, zVec3D *cp);
+__ZEO_EXPORT void zEllips3DClosestBatch(const zEllips3D *ellips, const zVec3D p[], int num, zVec3D cp[], double dist[], int thread_num);
 __ZEO_EXPORT double zEllips3DDistFromPoint(const zEllips3D *ellips, const zVec3D *p);
 __ZEO_EXPORT bool zEllips3DPointIsInside(const zEllips3D *ellips, const zVec3D *p, double margin);
 
+/*! \brief support map of a 3D ellipsoid.
+ *
+ * zEllips3DSupportMap() finds the farthest point of a 3D ellipsoid \a ellips in a direction \a dir,
+ * and puts it into \a sp.
+ * \return
+ * zEllips3DSupportMap() returns a pointer \a sp.
+ */
+__ZEO_EXPORT zVec3D *zEllips3DSupportMap(const zEllips3D *ellips, const zVec3D *dir, zVec3D *sp);
+
+/*! \brief ray casting on a 3D ellipsoid.
+ *
+ * zEllips3DRaycast() finds the first intersection of a ray from \a org in a direction \a dir with
+ * the surface of a 3D ellipsoid \a ellips in the same way with zSphere3DRaycast().
+ * \return
+ * zEllips3DRaycast() returns the true value if the ray hits \a ellips. Otherwise, the false value is
+ * returned.
+ */
+__ZEO_EXPORT bool zEllips3DRaycast(const zEllips3D *ellips, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal);
+
 /*! \brief calculate volume a 3D ellipsoid.
  *
  * zEllips3DVolume() calculates the volume of a 3D ellipsoid
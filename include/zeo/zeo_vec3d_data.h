@@ -74,6 +74,53 @@ __ZEO_EXPORT ZEO_VECXD_DATA_FPRINT_PROTOTYPE( 3D );
 __ZEO_EXPORT ZEO_VECXD_DATA_VALUE_FPRINT_PROTOTYPE( 3D );
 #define zVec3DDataValuePrint(data) zVecXDDataValuePrint( 3D, data )
 
+/* ********************************************************** */
+/*! \struct zVec3DKNN
+ * \brief bounded priority queue for k-nearest neighbor search.
+ *
+ * zVec3DKNN keeps at most k candidates of nearest neighbors sorted in ascending order of the
+ * distances. Buffers of neighbors and distances are supplied by the caller, so that no memory
+ * is allocated during a search. While searching, squared distances are stored in the buffer.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DKNN ){
+  int k;        /*!< maximum number of neighbors */
+  int num;      /*!< number of found neighbors */
+  zVec3D **nn;  /*!< buffer of neighbors */
+  double *dist; /*!< buffer of (squared) distances */
+};
+
+/*! \brief the current bound of squared distance of a k-nearest neighbor search. */
+#define zVec3DKNNBound(knn) ( (knn)->num < (knn)->k ? HUGE_VAL : (knn)->num > 0 ? (knn)->dist[(knn)->num-1] : -HUGE_VAL )
+
+/*! \brief initialize, update, and finalize a bounded priority queue of k-nearest neighbors.
+ *
+ * zVec3DKNNInit() initializes a bounded priority queue \a knn to find \a k nearest neighbors.
+ * \a nn and \a dist are arrays supplied by the caller, which have to have at least \a k elements.
+ *
+ * zVec3DKNNAdd() tries to push a point \a v at the squared distance \a d_sqr into \a knn.
+ * If \a knn is full and \a d_sqr is not less than the current bound, \a v is discarded.
+ *
+ * zVec3DKNNFinish() converts squared distances stored in \a knn to distances.
+ * \return
+ * zVec3DKNNInit() returns a pointer \a knn.
+ * zVec3DKNNAdd() returns the true value if \a v is pushed. Otherwise, the false value is returned.
+ * zVec3DKNNFinish() returns the number of found neighbors.
+ */
+__ZEO_EXPORT zVec3DKNN *zVec3DKNNInit(zVec3DKNN *knn, int k, zVec3D *nn[], double dist[]);
+__ZEO_EXPORT bool zVec3DKNNAdd(zVec3DKNN *knn, const zVec3D *v, double d_sqr);
+__ZEO_EXPORT int zVec3DKNNFinish(zVec3DKNN *knn);
+
+/*! \brief a naive algorithm to find k-nearest neighbors in a set of 3D vectors.
+ *
+ * zVec3DDataKNN() finds \a k nearest neighbors of a point \a point in a set of 3D vectors \a data.
+ * The pointers to the neighbors and the distances to them are stored into \a nn and \a dist in
+ * ascending order of the distances, respectively. Both have to have at least \a k elements.
+ * \return
+ * zVec3DDataKNN() returns the number of found neighbors, which is less than \a k if \a data has
+ * less than \a k points.
+ */
+__ZEO_EXPORT int zVec3DDataKNN(zVec3DData *data, const zVec3D *point, int k, zVec3D *nn[], double dist[]);
+
 __END_DECLS
 
 #include <zeo/zeo_vec3d_tree.h>   /* kd-tree with k=3 */
@@ -99,9 +99,81 @@ __ZEO_EXPORT double zVec3DOctreeNN(const zVec3DOctree *octree, const zVec3D *poi
 /*! \brief find vicinity of a point in 3D octree. */
 __ZEO_EXPORT zVec3DData *zVec3DOctreeVicinity(const zVec3DOctree *octree, const zVec3D *point, double radius, zVec3DData *vicinity);
 
+/*! \brief find k-nearest neighbors of a 3D point in a 3D octree (see zVec3DTreeKNN()). */
+__ZEO_EXPORT int zVec3DOctreeKNN(const zVec3DOctree *octree, const zVec3D *point, int k, zVec3D *nn[], double dist[]);
+
 /*! \brief convert a 3D octree to a list of axis-aligned boxes. */
 __ZEO_EXPORT int zVec3DOctreeToAABox3DList(const zVec3DOctree *octree, zAABox3DList *list);
 
+/* ********************************************************** */
+/*! \brief flat octree of 3D points.
+ *
+ * zVec3DFlatOctree is a static variant of zVec3DOctree built at once from a set of points.
+ * All nodes are stored in a single array, in which children of a node are placed contiguously,
+ * and all points are stored in a single array sorted by leaves, so that each leaf refers a
+ * contiguous range of it. The variance-covariance matrix and the normal vector are kept only
+ * at leaves. Hence, building and destroying a flat octree need only a few allocations regardless
+ * of the number of points.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DFlatOctreeNode ){
+  zAABox3D region; /*!< \brief region to cover */
+  int child;       /*!< \brief index of the first child node */
+  int child_num;   /*!< \brief number of child nodes (0 for a leaf) */
+  int leaf;        /*!< \brief index of the leaf (-1 for a non-leaf node) */
+};
+
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DFlatOctreeLeaf ){
+  int start;   /*!< \brief index of the first point */
+  int num;     /*!< \brief number of points */
+  zVec3D norm; /*!< \brief unit normal vector */
+  zMat3D ncov; /*!< \brief variance-covariance matrix multiplied by the number of points */
+};
+
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DFlatOctree ){
+  double resolution;           /*!< \brief spatial resolution */
+  int node_num;                /*!< \brief number of nodes */
+  int node_capacity;           /*!< \brief size of node buffer */
+  zVec3DFlatOctreeNode *node;  /*!< \brief node buffer (the first is the root) */
+  int leaf_num;                /*!< \brief number of leaves */
+  int leaf_capacity;           /*!< \brief size of leaf buffer */
+  zVec3DFlatOctreeLeaf *leaf;  /*!< \brief leaf buffer */
+  int point_num;               /*!< \brief number of points */
+  zVec3D *point;               /*!< \brief points sorted by leaves */
+};
+
+#define zVec3DFlatOctreeLeafPoint(tree,leaf,i) ( &(tree)->point[(leaf)->start+(i)] )
+
+/*! \brief initialize a flat octree. */
+__ZEO_EXPORT zVec3DFlatOctree *zVec3DFlatOctreeInit(zVec3DFlatOctree *tree);
+
+/*! \brief destroy a flat octree. */
+__ZEO_EXPORT void zVec3DFlatOctreeDestroy(zVec3DFlatOctree *tree);
+
+/*! \brief convert a set of 3D vectors to a flat octree.
+ *
+ * zVec3DDataToFlatOctree() builds a flat octree \a tree of a set of 3D points \a pointdata,
+ * which covers a region [\a xmin, \a xmax] x [\a ymin, \a ymax] x [\a zmin, \a zmax] and is
+ * divided until the size of leaves gets less than \a resolution. The points are copied to \a tree.
+ * Covariance matrices and normal vectors of leaves are also computed. Each normal vector is
+ * oriented outward, namely, away from the center of the region.
+ * \return
+ * zVec3DDataToFlatOctree() returns a pointer \a tree if it succeeds. If it fails to allocate
+ * memory or a point is out of the region, the null pointer is returned.
+ */
+__ZEO_EXPORT zVec3DFlatOctree *zVec3DDataToFlatOctree(zVec3DData *pointdata, zVec3DFlatOctree *tree, double xmin, double ymin, double zmin, double xmax, double ymax, double zmax, double resolution);
+
+/*! \brief find a leaf that contains a 3D point in a flat octree. */
+__ZEO_EXPORT const zVec3DFlatOctreeLeaf *zVec3DFlatOctreeFindContainer(const zVec3DFlatOctree *tree, const zVec3D *point);
+
+/*! \brief find nearest neighbor of a 3D point in a flat octree. */
+__ZEO_EXPORT double zVec3DFlatOctreeNN(const zVec3DFlatOctree *tree, const zVec3D *point, zVec3D **nn);
+
+/*! \brief find vicinity of a point in a flat octree. */
+__ZEO_EXPORT zVec3DData *zVec3DFlatOctreeVicinity(const zVec3DFlatOctree *tree, const zVec3D *point, double radius, zVec3DData *vicinity);
+
+/*! \brief find k-nearest neighbors of a 3D point in a flat octree (see zVec3DTreeKNN()). */
+__ZEO_EXPORT int zVec3DFlatOctreeKNN(const zVec3DFlatOctree *tree, const zVec3D *point, int k, zVec3D *nn[], double dist[]);
+
 __END_DECLS
 
 #ifdef __cplusplus
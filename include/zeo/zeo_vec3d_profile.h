@@ -23,12 +23,88 @@ __BEGIN_DECLS
  * zVec3DDataNormalVec_Tree() and zVec3DDataNormalVec_Octree() find the vicinities by using kd-tree and
  * octree, respectively.
  * zVec3DDataNormalVec() uses the latter by default.
+ *
+ * zVec3DDataNormalVec_KNN() approximates the \a k nearest neighbors of each point instead of the
+ * points within a radius, so that the cost is kept constant regardless of density of points.
  * \return
  * zVec3DDataNormalVec() returns the pointer \a normaldata.
+ * zVec3DDataNormalVec_KNN() returns the pointer \a normaldata if it succeeds. If it fails to allocate
+ * memory, the null pointer is returned.
  */
 __ZEO_EXPORT zVec3DData *zVec3DDataNormalVec_Tree(zVec3DData *pointdata, double radius, zVec3DData *normaldata);
 __ZEO_EXPORT zVec3DData *zVec3DDataNormalVec_Octree(zVec3DData *pointdata, double radius, zVec3DData *normaldata);
 __ZEO_EXPORT zVec3DData *(* zVec3DDataNormalVec)(zVec3DData*, double, zVec3DData*);
+__ZEO_EXPORT zVec3DData *zVec3DDataNormalVec_KNN(zVec3DData *pointdata, int k, zVec3DData *normaldata);
+
+/*! \brief normal vector cloud of a 3D point cloud computed in parallel.
+ *
+ * zVec3DDataNormalVec_Parallel() computes normal vectors of a 3D point cloud \a pointdata by
+ * \a thread_num threads (see zParallelFor()). The normal vector at each point is identified from
+ * at most \a k nearest neighbors within a radius \a radius. If a non-positive value is given for
+ * \a k, ZEO_VEC3DDATA_NORMALVEC_NUM_MAX is used. If a non-positive value is given for \a radius,
+ * the neighbors are not limited by the distance.
+ * The result is stored in an array \a normalarray, which is allocated internally, in the
+ * corresponding order with \a pointdata. Since neighbors are stored in fixed-size working
+ * buffers prepared for each thread, no memory is allocated during the computation.
+ * \return
+ * zVec3DDataNormalVec_Parallel() returns the pointer \a normalarray if it succeeds. If it fails to
+ * allocate memory, the null pointer is returned.
+ */
+__ZEO_EXPORT zVec3DArray *zVec3DDataNormalVec_Parallel(zVec3DData *pointdata, double radius, int k, zVec3DArray *normalarray, int thread_num);
+
+/*! \brief voxel-grid downsampling of a 3D point cloud.
+ *
+ * zVec3DDataVoxelDownsample() divides the space into cubic voxels of size \a pitch, and
+ * represents points of a 3D point cloud \a src in each voxel by one point. If the true value is
+ * given for \a centroid, the representative is the centroid of the points in the voxel. Otherwise,
+ * it is the first point in the voxel in the order of \a src.
+ * The result is stored into \a dest, which is initialized as an array internally. Voxels are
+ * ordered by their first points in \a src.
+ * Voxels are identified through a hash table, so that the computation takes O(N) time for N
+ * points, without any tree. Voxel coordinates of points and representatives of voxels are
+ * computed by \a thread_num threads in parallel (see zParallelFor()). If a non-positive value
+ * is given for \a thread_num, the number of online processors is used. The result does not
+ * depend on the number of threads.
+ * \return
+ * zVec3DDataVoxelDownsample() returns the pointer \a dest if it succeeds. If \a pitch is
+ * non-positive or too small for the extent of \a src, or it fails to allocate memory, the
+ * null pointer is returned.
+ */
+__ZEO_EXPORT zVec3DData *zVec3DDataVoxelDownsample(zVec3DData *src, double pitch, bool centroid, zVec3DData *dest, int thread_num);
+
+/*! \brief default number of neighbors for statistical outlier removal */
+#define ZEO_VEC3DDATA_OUTLIER_NUM 20
+
+/*! \brief outlier removal of a 3D point cloud.
+ *
+ * zVec3DDataStatisticalOutlierMask() computes the mean distance from each point of a 3D point
+ * cloud \a data to its \a k nearest neighbors, and regards a point as an outlier if the mean
+ * distance is larger than m + \a std_ratio s, where m and s are the mean and the standard
+ * deviation of the mean distances over all points, respectively. If a non-positive value is
+ * given for \a k, ZEO_VEC3DDATA_OUTLIER_NUM is used.
+ *
+ * zVec3DDataRadiusOutlierMask() regards a point of \a data as an outlier if it has less than
+ * \a min_num neighbors within a radius \a radius.
+ *
+ * For both functions, a point itself is not counted as its neighbor. The results are stored into
+ * \a inlier in the order of \a data, namely, the true value for an inlier and the false value for
+ * an outlier. The size of \a inlier has to be larger than or equal to the number of points of
+ * \a data. Neighbors are found in a flat kd-tree (see zVec3DDataToFlatTree()) by \a thread_num
+ * threads in parallel (see zParallelFor()) without memory allocation in each thread. If a
+ * non-positive value is given for \a thread_num, the number of online processors is used.
+ *
+ * zVec3DDataMask() copies points of a 3D point cloud \a src for which \a mask is true to another
+ * \a dest, which is initialized as an array internally. This is used to filter \a src by the
+ * results of the above functions.
+ * \return
+ * zVec3DDataStatisticalOutlierMask() and zVec3DDataRadiusOutlierMask() return the number of
+ * inliers. If they fail to allocate memory, -1 is returned.
+ * zVec3DDataMask() returns a pointer \a dest if it succeeds. If it fails to allocate memory, the
+ * null pointer is returned.
+ */
+__ZEO_EXPORT int zVec3DDataStatisticalOutlierMask(zVec3DData *data, int k, double std_ratio, bool inlier[], int thread_num);
+__ZEO_EXPORT int zVec3DDataRadiusOutlierMask(zVec3DData *data, double radius, int min_num, bool inlier[], int thread_num);
+__ZEO_EXPORT zVec3DData *zVec3DDataMask(zVec3DData *src, const bool mask[], zVec3DData *dest);
 
 #define ZEO_VEC3DDATA_IDENT_FRAME_MINSIZ 3
 
@@ -56,13 +132,272 @@ __ZEO_EXPORT zFrame3D *zVec3DDataIdentFrame(zVec3DData *src, zVec3DData *dest, z
  * \a sample_rate is the rate of samples to be evaluated at each iteration.
  * \a tol is the tolerance of the maximum distance between corresponding points of \a src and \a dest
  * to stop iterations.
+ * zVec3DDataICP() uses an engine of the method (see zVec3DICPCreate()) seeded by zRandI(), and
+ * initializes the frame so that barycenters of \a src and \a dest coincide. Nearest neighbors
+ * are found by a single thread.
  * \return
- * zVec3DDataICP() returns the pointer \a frame.
+ * zVec3DDataICP() returns the pointer \a frame if it succeeds. If \a dest has too few points,
+ * if too few pairs of points remain at an iteration, or if it fails to allocate memory, the null
+ * pointer is returned.
  * \sa
  * zVec3DDataIdentFrame
  */
 __ZEO_EXPORT zFrame3D *zVec3DDataICP(zVec3DData *src, zVec3DData *dest, zFrame3D *frame, double sample_rate, double tol);
 
+/* ********************************************************** */
+/*! \struct zVec3DICPStat
+ * \brief statistics of an iteration of the iterative closest point method.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DICPStat ){
+  int num;          /*!< number of sampled pairs of points */
+  int inlier_num;   /*!< number of pairs not rejected */
+  double rms;       /*!< root mean square of distances between inlier pairs */
+  double error_max; /*!< maximum distance between inlier pairs */
+};
+
+/* ********************************************************** */
+/*! \struct zVec3DICP
+ * \brief engine of the iterative closest point method.
+ *
+ * zVec3DICP keeps a kd-tree of a destination point cloud and arrays of corresponding points,
+ * so that a source point cloud is registered to the destination repeatedly without rebuilding
+ * the tree, and without memory allocation at each iteration.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DICP ){
+  zVec3DFlatTree tree; /*!< kd-tree of the destination point cloud */
+  int capacity;        /*!< capacity of arrays of corresponding points */
+  zVec3D *src;         /*!< sampled source points */
+  zVec3D *dest;        /*!< destination points corresponding to source points */
+  double *dist;        /*!< distances between corresponding points */
+  double reject_dist;  /*!< distance over which a pair is rejected */
+  int thread_num;      /*!< number of threads */
+  zRandMT rand;        /*!< random number generator for sampling */
+  int iter_num;        /*!< number of iterations at the last run */
+  zVec3DICPStat stat[ZEO_VEC3DDATA_ICP_MAXITERNUM]; /*!< statistics of iterations */
+};
+
+#define zVec3DICPSetSeed(icp,seed)     zRandInitMT( &(icp)->rand, seed )
+#define zVec3DICPSetRejectDist(icp,d)  ( (icp)->reject_dist = (d) )
+#define zVec3DICPIterNum(icp)          (icp)->iter_num
+#define zVec3DICPIterStat(icp,i)       ( &(icp)->stat[i] )
+
+/*! \brief create, run and destroy an engine of the iterative closest point method.
+ *
+ * zVec3DICPInit() initializes an ICP engine \a icp.
+ *
+ * zVec3DICPCreate() creates \a icp for a destination point cloud \a dest. The nearest neighbors
+ * of sampled source points are found by \a thread_num threads in parallel (see zParallelFor()).
+ * If a non-positive value is given for \a thread_num, the number of online processors is used.
+ *
+ * zVec3DICPRun() finds a transformation frame that gets a set of 3D points \a src the closest to
+ * the destination point cloud of \a icp, in the same way with zVec3DDataICP(). \a frame is the
+ * initial guess, and the result is stored where \a frame points.
+ * Source points are sampled at a rate \a sample_rate by the random number generator of \a icp,
+ * which is seeded by zVec3DICPSetSeed(), so that the result is reproducible for the same seed
+ * regardless of the number of threads. Pairs of points farther than a distance set by
+ * zVec3DICPSetRejectDist() are rejected. If a non-positive value is set, which is the default,
+ * no pair is rejected. Iterations stop when the maximum distance between inlier pairs is less
+ * than \a tol. The number of iterations and statistics of each iteration are obtained by
+ * zVec3DICPIterNum() and zVec3DICPIterStat(), respectively.
+ * Arrays of corresponding points are allocated only if \a src has more points than ever.
+ *
+ * zVec3DICPDestroy() destroys \a icp.
+ * \return
+ * zVec3DICPInit() returns a pointer \a icp.
+ * zVec3DICPCreate() returns a pointer \a icp if it succeeds. If \a dest has too few points or it
+ * fails to allocate memory, the null pointer is returned.
+ * zVec3DICPRun() returns a pointer \a frame if it succeeds. If too few pairs of points remain or
+ * it fails to allocate memory, the null pointer is returned.
+ */
+__ZEO_EXPORT zVec3DICP *zVec3DICPInit(zVec3DICP *icp);
+__ZEO_EXPORT zVec3DICP *zVec3DICPCreate(zVec3DICP *icp, zVec3DData *dest, int thread_num);
+__ZEO_EXPORT void zVec3DICPDestroy(zVec3DICP *icp);
+__ZEO_EXPORT zFrame3D *zVec3DICPRun(zVec3DICP *icp, zVec3DData *src, zFrame3D *frame, double sample_rate, double tol);
+
+/*! \brief coarse-to-fine iterative closest point method.
+ *
+ * zVec3DDataICPPyramid() finds a transformation frame that gets a set of 3D points \a src the
+ * closest to another \a dest in the same way with zVec3DDataICP(), but through a pyramid of
+ * \a level_num levels. At the i-th level from the finest (i > 0), both \a src and \a dest are
+ * downsampled to centroids of voxels of size \a pitch times 2^(i-1) by zVec3DDataVoxelDownsample(),
+ * and all of the downsampled points are registered. The finest level (i = 0) registers the
+ * original points sampled at a rate \a sample_rate. The frame is initialized so that barycenters
+ * of \a src and \a dest coincide, and is passed from coarser levels to finer ones.
+ * Iterations at each level stop when the maximum distance between corresponding points gets
+ * less than \a tol plus the size of voxels at the level, so that coarse levels, which are cheap
+ * and tolerant to a far initial guess, are not iterated more than their resolution deserves.
+ * Levels with too few voxels are skipped. Downsampling and nearest neighbor search are run by
+ * \a thread_num threads in parallel (see zParallelFor()).
+ * If 1 is given for \a level_num, it is the same with zVec3DDataICP().
+ * The result is stored where \a frame points.
+ * \return
+ * zVec3DDataICPPyramid() returns the pointer \a frame if it succeeds. If \a pitch is invalid or it
+ * fails to allocate memory, the null pointer is returned.
+ * \sa
+ * zVec3DDataICP, zVec3DDataVoxelDownsample
+ */
+__ZEO_EXPORT zFrame3D *zVec3DDataICPPyramid(zVec3DData *src, zVec3DData *dest, zFrame3D *frame, double pitch, int level_num, double sample_rate, double tol, int thread_num);
+
+/*! \brief robust kernels of point-to-plane iterative closest point method */
+typedef enum{
+  ZEO_VEC3DDATA_ICP_KERNEL_NONE = 0,
+  ZEO_VEC3DDATA_ICP_KERNEL_HUBER,
+  ZEO_VEC3DDATA_ICP_KERNEL_TUKEY,
+} zVec3DDataICPKernel;
+
+/*! \brief point-to-plane iterative closest point method.
+ *
+ * zVec3DDataICPPointToPlane() finds a transformation frame that gets a set of 3D points \a src the
+ * closest to another \a dest in the same way with zVec3DDataICP(), except that it minimizes the sum
+ * of squared distances from transformed points of \a src to tangent planes of \a dest at their
+ * closest points, as originally proposed by Chen and Medioni (see zVec3DDataICP()).
+ * \a normal is a set of normal vectors of \a dest in the same order, which are computed by, for
+ * example, zVec3DDataNormalVec(). The frame is updated by the Gauss-Newton method with respect to
+ * a small rotation and translation at each iteration, which typically converges in fewer iterations
+ * than zVec3DDataICP() does.
+ * Each residual is weighted by a robust kernel \a kernel with a width \a width, which is either
+ * ZEO_VEC3DDATA_ICP_KERNEL_NONE (no weighting), ZEO_VEC3DDATA_ICP_KERNEL_HUBER (Huber's function)
+ * or ZEO_VEC3DDATA_ICP_KERNEL_TUKEY (Tukey's biweight function). If a non-positive value is given
+ * for \a width, residuals are not weighted.
+ * Corresponding pairs of points farther than \a reject_dist are rejected. If a non-positive value
+ * is given for \a reject_dist, no pair is rejected.
+ * \a tol is the tolerance of the norm of the update of the frame to stop iterations.
+ * The result is stored where \a frame points.
+ * \return
+ * zVec3DDataICPPointToPlane() returns the pointer \a frame if it succeeds. If the sizes of \a dest
+ * and \a normal mismatch, too few pairs of points remain, or it fails to allocate memory, the null
+ * pointer is returned.
+ * \sa
+ * zVec3DDataICP
+ */
+__ZEO_EXPORT zFrame3D *zVec3DDataICPPointToPlane(zVec3DData *src, zVec3DData *dest, zVec3DData *normal, zFrame3D *frame, zVec3DDataICPKernel kernel, double width, double reject_dist, double tol);
+
+/*! \brief minimum number of points in a cell of an NDT map */
+#define ZEO_VEC3DDATA_NDT_CELL_MINSIZ 5
+/*! \brief minimum ratio of eigenvalues of a covariance matrix of a cell of an NDT map */
+#define ZEO_VEC3DDATA_NDT_EIG_RATIO   ( 1.0e-2 )
+/*! \brief maximum number of iterations of NDT registration */
+#define ZEO_VEC3DDATA_NDT_MAXITERNUM  100
+
+/*! \brief cell of a map of the normal distributions transform */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DNDTCell ){
+  zVec3D mean; /*!< mean of points */
+  zMat3D icov; /*!< inverse of the variance-covariance matrix of points */
+  bool valid;  /*!< flag to be used for registration */
+};
+
+/* ********************************************************** */
+/*! \struct zVec3DNDT
+ * \brief map of the normal distributions transform.
+ *
+ * zVec3DNDT represents a destination point cloud by normal distributions of points in leaves
+ * of a flat octree (see zVec3DDataToFlatOctree()), namely, cells:
+ * Peter Biber and Wolfgang Strasser, "The Normal Distributions Transform: A New Approach to Laser
+ * Scan Matching," Proceedings of the 2003 IEEE/RSJ International Conference on Intelligent Robots
+ * and Systems, pp. 2743-2748, 2003.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DNDT ){
+  zVec3DFlatOctree tree; /*!< octree of the destination point cloud */
+  zVec3DNDTCell *cell;   /*!< cells corresponding to leaves of the octree */
+  int thread_num;        /*!< number of threads */
+  int iter_num;          /*!< number of iterations at the last run */
+  int num;               /*!< number of source points in valid cells at the last iteration */
+  double score;          /*!< score at the last iteration */
+};
+
+/*! \brief registration of a 3D point cloud by the normal distributions transform.
+ *
+ * zVec3DNDTInit() initializes an NDT map \a ndt.
+ *
+ * zVec3DNDTCreate() creates \a ndt of a destination point cloud \a dest. \a dest is divided into
+ * cells by a flat octree with a resolution \a resolution, and the mean and the covariance of points
+ * in each cell are computed. The covariance is derived from the one kept by a leaf of the octree.
+ * Cells with less than ZEO_VEC3DDATA_NDT_CELL_MINSIZ points, or whose covariance fails to be
+ * diagonalized, are not used. Eigenvalues of the
+ * covariance are bounded below by ZEO_VEC3DDATA_NDT_EIG_RATIO times the maximum eigenvalue, so
+ * that flat distributions of points on surfaces are regularized.
+ *
+ * zVec3DNDTRun() finds a transformation frame that gets a set of 3D points \a src fit the
+ * distributions of \a ndt. \a frame is the initial guess, and the result is stored where \a frame
+ * points. The score, namely, the sum of exp(-q^T S^-1 q / 2) over source points, where q is the
+ * deviation of a transformed point from the mean of the cell containing it and S is the covariance,
+ * is maximized by Newton steps with respect to a small rotation and translation, where the Hessian
+ * is approximated by the Gauss-Newton method. The cell is found directly by the octree, so that no
+ * nearest-neighbor search is needed. The Hessian and the gradient are accumulated by \a thread_num
+ * threads given to zVec3DNDTCreate() in parallel (see zParallelFor()). If a non-positive value is
+ * given for \a thread_num, the number of online processors is used.
+ * Iterations stop when the norm of the update of the frame gets less than \a tol.
+ *
+ * zVec3DNDTDestroy() destroys \a ndt.
+ * \return
+ * zVec3DNDTInit() returns a pointer \a ndt.
+ * zVec3DNDTCreate() returns a pointer \a ndt if it succeeds. If \a dest has too few points or it
+ * fails to allocate memory, the null pointer is returned.
+ * zVec3DNDTRun() returns a pointer \a frame if it succeeds. If too few points are in valid cells or
+ * it fails to allocate memory, the null pointer is returned.
+ */
+__ZEO_EXPORT zVec3DNDT *zVec3DNDTInit(zVec3DNDT *ndt);
+__ZEO_EXPORT zVec3DNDT *zVec3DNDTCreate(zVec3DNDT *ndt, zVec3DData *dest, double resolution, int thread_num);
+__ZEO_EXPORT void zVec3DNDTDestroy(zVec3DNDT *ndt);
+__ZEO_EXPORT zFrame3D *zVec3DNDTRun(zVec3DNDT *ndt, zVec3DData *src, zFrame3D *frame, double tol);
+
+/*! \brief default number of neighbors to compute a covariance for the generalized ICP */
+#define ZEO_VEC3DDATA_GICP_NUM        20
+/*! \brief variance of a point along the normal of a local plane for the generalized ICP */
+#define ZEO_VEC3DDATA_GICP_EPSILON    ( 1.0e-3 )
+/*! \brief maximum number of iterations of the generalized ICP */
+#define ZEO_VEC3DDATA_GICP_MAXITERNUM 100
+
+/* ********************************************************** */
+/*! \struct zVec3DGICPCloud
+ * \brief point cloud with covariances for the generalized iterative closest point method.
+ *
+ * zVec3DGICPCloud keeps a kd-tree of a point cloud and covariances of points in the order of
+ * the tree. Once created, it is reused in any number of registrations, for example, as a map
+ * to which scans are aligned.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DGICPCloud ){
+  zVec3DFlatTree tree; /*!< kd-tree of points */
+  zMat3D *cov;         /*!< regularized covariances of points */
+};
+
+/*! \brief generalized iterative closest point method.
+ *
+ * zVec3DGICPCloudInit() initializes a point cloud \a cloud for the generalized ICP.
+ *
+ * zVec3DGICPCloudCreate() creates \a cloud from a set of 3D points \a data. The covariance of each
+ * point is computed from its \a k nearest neighbors in the same way with zVec3DDataCov() about
+ * their barycenter, and is regularized to that of a point on a local plane, namely, its eigenvalues
+ * are replaced by 1, 1 and ZEO_VEC3DDATA_GICP_EPSILON for the normal direction. If a non-positive
+ * value is given for \a k, ZEO_VEC3DDATA_GICP_NUM is used. The covariances are computed by
+ * \a thread_num threads in parallel (see zParallelFor()).
+ *
+ * zVec3DGICPCloudDestroy() destroys \a cloud.
+ *
+ * zVec3DGICPRun() finds a transformation frame that gets a point cloud \a src the closest to
+ * another \a dest based on the generalized iterative closest point (plane-to-plane) method:
+ * Aleksandr V. Segal, Dirk Haehnel and Sebastian Thrun, "Generalized-ICP," Proceedings of
+ * Robotics: Science and Systems, 2009.
+ * The sum of squared Mahalanobis distances between transformed points of \a src and their closest
+ * points of \a dest under the sum of their covariances is minimized by the Gauss-Newton method
+ * with respect to a small rotation and translation. The Hessian and the gradient are accumulated
+ * by \a thread_num threads in parallel. Pairs of points farther than \a reject_dist are rejected.
+ * If a non-positive value is given for \a reject_dist, no pair is rejected. \a frame is the initial
+ * guess, and the result is stored where \a frame points. Iterations stop when the norm of the
+ * update of the frame gets less than \a tol.
+ * If a non-positive value is given for \a thread_num, the number of online processors is used.
+ * \return
+ * zVec3DGICPCloudInit() returns a pointer \a cloud.
+ * zVec3DGICPCloudCreate() returns a pointer \a cloud if it succeeds. If it fails to allocate memory,
+ * the null pointer is returned.
+ * zVec3DGICPRun() returns a pointer \a frame if it succeeds. If too few pairs of points remain or it
+ * fails to allocate memory, the null pointer is returned.
+ */
+__ZEO_EXPORT zVec3DGICPCloud *zVec3DGICPCloudInit(zVec3DGICPCloud *cloud);
+__ZEO_EXPORT zVec3DGICPCloud *zVec3DGICPCloudCreate(zVec3DGICPCloud *cloud, zVec3DData *data, int k, int thread_num);
+__ZEO_EXPORT void zVec3DGICPCloudDestroy(zVec3DGICPCloud *cloud);
+__ZEO_EXPORT zFrame3D *zVec3DGICPRun(const zVec3DGICPCloud *src, const zVec3DGICPCloud *dest, zFrame3D *frame, double reject_dist, double tol, int thread_num);
+
 __END_DECLS
 
 #endif /* __ZEO_VEC3D_PROFILE_H__ */
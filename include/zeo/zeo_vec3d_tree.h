@@ -66,6 +66,19 @@ __ZEO_EXPORT double zVec3DTreeNN(const zVec3DTree *tree, const zVec3D *point, zV
  */
 __ZEO_EXPORT zVec3DData *zVec3DTreeVicinity(const zVec3DTree *tree, const zVec3D *point, double radius, zVec3DData *vicinity);
 
+/*! \brief find k-nearest neighbors of a 3D point in a 3D vector tree.
+ *
+ * zVec3DTreeKNN() finds \a k nearest neighbors of a 3D point \a point in a 3D vector tree \a tree.
+ * The pointers to the neighbors and the distances to them are stored into \a nn and \a dist in
+ * ascending order of the distances, respectively. Both have to have at least \a k elements.
+ * \return
+ * zVec3DTreeKNN() returns the number of found neighbors, which is less than \a k if \a tree has
+ * less than \a k points.
+ * \sa
+ * zVec3DKNN
+ */
+__ZEO_EXPORT int zVec3DTreeKNN(const zVec3DTree *tree, const zVec3D *point, int k, zVec3D *nn[], double dist[]);
+
 /*! \brief convert an array of 3D vectors to a 3D vector tree. */
 __ZEO_EXPORT zVec3DTree *zVec3DArrayToTree(const zVec3DArray *array, zVec3DTree *tree);
 
@@ -91,6 +104,77 @@ __ZEO_EXPORT void zVec3DTreeFPrint(FILE *fp, const zVec3DTree *tree);
 /*! \brief print out values of a 3D vector tree. */
 __ZEO_EXPORT void zVec3DTreeValueFPrint(FILE *fp, const zVec3DTree *tree);
 
+/* ********************************************************** */
+/*! \struct zVec3DFlatTree
+ * \brief balanced kd-tree of 3D vectors on a flat array
+ *
+ * zVec3DFlatTree is a static kd-tree built at once from a set of 3D points. Unlike zVec3DTree,
+ * which depends on the order of insertions, it is always balanced by splitting a node at the
+ * median along the longest side of the bounding box of points in it, until the number of points
+ * gets less than or equal to the size of leaf buckets (see zAABox3DTree). Points are copied
+ * in the order of leaves, and the original index of each point in the source set is also kept.
+ *//* ******************************************************* */
+ZDEF_STRUCT( __ZEO_CLASS_EXPORT, zVec3DFlatTree ){
+  zAABox3DTree boxtree;  /*!< tree of boxes of points (indices are original ones of points) */
+  int point_num;         /*!< number of points */
+  zVec3D *point;         /*!< points sorted by leaves */
+  int leafsize;          /*!< maximum number of points in a leaf */
+};
+
+/*! \brief default size of leaf buckets of a flat kd-tree */
+#define ZEO_VEC3D_FLATTREE_DEFAULT_LEAFSIZE 8
+
+/*! \brief original index of a point in a flat kd-tree. */
+#define zVec3DFlatTreePointID(tree,p) (tree)->boxtree.index[(p)-(tree)->point]
+
+/*! \brief initialize and destroy a flat kd-tree.
+ *
+ * zVec3DFlatTreeInit() initializes a flat kd-tree \a tree as empty.
+ *
+ * zVec3DFlatTreeDestroy() frees internal arrays of \a tree.
+ * \return
+ * zVec3DFlatTreeInit() returns a pointer \a tree.
+ */
+__ZEO_EXPORT zVec3DFlatTree *zVec3DFlatTreeInit(zVec3DFlatTree *tree);
+__ZEO_EXPORT void zVec3DFlatTreeDestroy(zVec3DFlatTree *tree);
+
+/*! \brief build a balanced kd-tree from a set of 3D vectors.
+ *
+ * zVec3DDataToFlatTree() builds a balanced kd-tree \a tree from a set of 3D points \a pointdata.
+ * \a leafsize is the maximum number of points in a leaf. If a non-positive value is given,
+ * ZEO_VEC3D_FLATTREE_DEFAULT_LEAFSIZE is used. Points are copied to \a tree, and the index of
+ * each point in \a pointdata is obtained by zVec3DFlatTreePointID().
+ * \return
+ * zVec3DDataToFlatTree() returns a pointer \a tree if it succeeds. If it fails to allocate
+ * memory, the null pointer is returned.
+ */
+__ZEO_EXPORT zVec3DFlatTree *zVec3DDataToFlatTree(zVec3DData *pointdata, zVec3DFlatTree *tree, int leafsize);
+
+/*! \brief find the nearest neighbor and vicinity of a 3D point in a flat kd-tree.
+ *
+ * zVec3DFlatTreeNN() finds the nearest neighbor in a flat kd-tree \a tree to a 3D point \a point.
+ * The pointer to the found point in \a tree is stored into \a nn.
+ *
+ * zVec3DFlatTreeVicinity() finds vicinity of \a point in \a tree, which is a sphere with the
+ * radius \a radius. The result is stored in a list of addresses of 3D vectors \a vicinity.
+ * \return
+ * zVec3DFlatTreeNN() returns the distance from \a point to the nearest neighbor. If \a tree is
+ * empty, HUGE_VAL is returned and the null pointer is stored into \a nn.
+ * zVec3DFlatTreeVicinity() returns the pointer \a vicinity, if it succeeds. If it fails to
+ * allocate memory for the list to store the result, it returns the null pointer.
+ */
+__ZEO_EXPORT double zVec3DFlatTreeNN(const zVec3DFlatTree *tree, const zVec3D *point, zVec3D **nn);
+__ZEO_EXPORT zVec3DData *zVec3DFlatTreeVicinity(const zVec3DFlatTree *tree, const zVec3D *point, double radius, zVec3DData *vicinity);
+
+/*! \brief find k-nearest neighbors of a 3D point in a flat kd-tree.
+ *
+ * zVec3DFlatTreeKNN() finds \a k nearest neighbors of a 3D point \a point in a flat kd-tree \a tree.
+ * The results are stored in the same way with zVec3DTreeKNN().
+ * \return
+ * zVec3DFlatTreeKNN() returns the number of found neighbors.
+ */
+__ZEO_EXPORT int zVec3DFlatTreeKNN(const zVec3DFlatTree *tree, const zVec3D *point, int k, zVec3D *nn[], double dist[]);
+
 __END_DECLS
 
 #endif /* __ZEO_VEC3D_TREE_H__ */
@@ -22,17 +22,18 @@ zBREPVertListCell *zBREPVertListFind(zBREPVertList *vlist, zVec3D *v)
 }
 
 /* find or register a vertex list cell. */
-static zBREPVertListCell *_zBREPVertListFindnReg(zBREPVertList *vlist, zVec3D *v)
+static zBREPVertListCell *_zBREPVertListFindnReg(zBREPVertList *vlist, zBREPHash *vhash, zVec3D *v)
 {
   zBREPVertListCell *vp;
 
-  if( ( vp = zBREPVertListFind( vlist, v ) ) ) return vp;
+  if( ( vp = zBREPVertHashFind( vhash, v ) ) ) return vp;
   if( !( vp = zAlloc( zBREPVertListCell, 1 ) ) ){
     ZALLOCERROR();
     return NULL;
   }
   zBREPVertListCellInit( vp, v );
   zListInsertHead( vlist, vp );
+  if( !zBREPVertHashAdd( vhash, vp ) ) return NULL;
   return vp;
 }
 
@@ -48,22 +49,23 @@ zBREPEdgeListCell *zBREPEdgeListFind(zBREPEdgeList *elist, zBREPVertListCell *v1
 }
 
 /* find or register an edge list cell. */
-static zBREPEdgeListCell *_zBREPEdgeListFindnReg(zBREPEdgeList *elist, zBREPVertListCell *v1, zBREPVertListCell *v2)
+static zBREPEdgeListCell *_zBREPEdgeListFindnReg(zBREPEdgeList *elist, zBREPHash *ehash, zBREPVertListCell *v1, zBREPVertListCell *v2)
 {
   zBREPEdgeListCell *ep;
 
-  if( ( ep = zBREPEdgeListFind( elist, v1, v2 ) ) ) return ep;
+  if( ( ep = zBREPEdgeHashFind( ehash, v1, v2 ) ) ) return ep;
   if( !( ep = zAlloc( zBREPEdgeListCell, 1 ) ) ){
     ZALLOCERROR();
     return NULL;
   }
   zBREPEdgeListCellInit( ep, v1, v2 );
   zListInsertHead( elist, ep );
+  if( !zBREPEdgeHashAdd( ehash, ep ) ) return NULL;
   return ep;
 }
 
 /* insert face list cell. */
-static bool _zBREPFaceInsert(zTri3D *face, zBREPFaceList *flist, zBREPEdgeList *elist, zBREPVertList *vlist)
+static bool _zBREPFaceInsert(zTri3D *face, zBREP *brep, zBREPHash *vhash, zBREPHash *ehash)
 {
   zBREPFaceListCell *f;
   int i;
@@ -72,56 +74,202 @@ static bool _zBREPFaceInsert(zTri3D *face, zBREPFaceList *flist, zBREPEdgeList *
     ZALLOCERROR();
     return false;
   }
+  zListInsertHead( &brep->flist, f );
   for( i=0; i<3; i++ )
-    f->data.v[i] = _zBREPVertListFindnReg( vlist, zTri3DVert(face,i) );
+    if( !( f->data.v[i] = _zBREPVertListFindnReg( &brep->vlist, vhash, zTri3DVert(face,i) ) ) )
+      return false;
   for( i=0; i<3; i++ )
-    f->data.e[i] = _zBREPEdgeListFindnReg( elist, f->data.v[(i+1)%3], f->data.v[(i+2)%3] );
+    if( !( f->data.e[i] = _zBREPEdgeListFindnReg( &brep->elist, ehash, f->data.v[(i+1)%3], f->data.v[(i+2)%3] ) ) )
+      return false;
   zVec3DCopy( zTri3DNorm(face), &f->data.norm );
-  zListInsertHead( flist, f );
   return true;
 }
 
+/* ********************************************************** */
+/* CLASS: zBREPHash
+ * hash index of B-Rep vertices and edges
+ * ********************************************************** */
+
+/* initial number of buckets of a hash index */
+#define Z_BREP_HASH_INIT_SIZE 64
+
+/* initialize a hash index. */
+zBREPHash *zBREPHashInit(zBREPHash *hash)
+{
+  hash->size = hash->num = hash->capacity = 0;
+  hash->bucket = NULL;
+  hash->entry = NULL;
+  return hash;
+}
+
+/* destroy a hash index. */
+void zBREPHashDestroy(zBREPHash *hash)
+{
+  zFree( hash->bucket );
+  zFree( hash->entry );
+  zBREPHashInit( hash );
+}
+
+/* rehash entries into a larger number of buckets. */
+static bool _zBREPHashRehash(zBREPHash *hash, int size)
+{
+  int i, *bucket;
+
+  if( !( bucket = zAlloc( int, size ) ) ){
+    ZALLOCERROR();
+    return false;
+  }
+  zFree( hash->bucket );
+  hash->bucket = bucket;
+  hash->size = size;
+  for( i=0; i<size; i++ ) hash->bucket[i] = -1;
+  for( i=0; i<hash->num; i++ ){
+    hash->entry[i].next = hash->bucket[hash->entry[i].key & (size-1)];
+    hash->bucket[hash->entry[i].key & (size-1)] = i;
+  }
+  return true;
+}
+
+/* add a cell with a hash key to a hash index. */
+static bool _zBREPHashAdd(zBREPHash *hash, void *cell, unsigned long key)
+{
+  zBREPHashEntry *entry;
+  int b;
+
+  if( hash->num >= hash->capacity ){
+    if( !( entry = zRealloc( hash->entry, zBREPHashEntry, hash->capacity == 0 ? Z_BREP_HASH_INIT_SIZE : hash->capacity*2 ) ) ){
+      ZALLOCERROR();
+      return false;
+    }
+    hash->entry = entry;
+    hash->capacity = hash->capacity == 0 ? Z_BREP_HASH_INIT_SIZE : hash->capacity*2;
+  }
+  hash->entry[hash->num].cell = cell;
+  hash->entry[hash->num].key = key;
+  hash->num++;
+  if( hash->num > hash->size ) /* keep the load factor less than one */
+    return _zBREPHashRehash( hash, hash->size == 0 ? Z_BREP_HASH_INIT_SIZE : hash->size*2 );
+  b = key & (hash->size-1);
+  hash->entry[hash->num-1].next = hash->bucket[b];
+  hash->bucket[b] = hash->num - 1;
+  return true;
+}
+
+/* hash key of a grid cell. */
+static unsigned long _zBREPVertHashKey(long ix, long iy, long iz)
+{
+  return (unsigned long)ix * 73856093UL ^ (unsigned long)iy * 19349663UL ^ (unsigned long)iz * 83492791UL;
+}
+
+/* grid cell of a vertex. */
+#define _zBREPVertHashGrid(x) ( (long)floor( (x) / ZEO_BREP_HASH_GRID ) )
+
+/* add a vertex list cell to a hash index. */
+bool zBREPVertHashAdd(zBREPHash *hash, zBREPVertListCell *cell)
+{
+  return _zBREPHashAdd( hash, cell, _zBREPVertHashKey( _zBREPVertHashGrid(cell->data.p.c.x), _zBREPVertHashGrid(cell->data.p.c.y), _zBREPVertHashGrid(cell->data.p.c.z) ) );
+}
+
+/* range of grid cells that possibly contain vertices equal to a value. */
+static void _zBREPVertHashRange(double x, long *imin, long *imax)
+{
+  *imin = *imax = _zBREPVertHashGrid( x );
+  if( x - *imin * ZEO_BREP_HASH_GRID <= zTOL ) (*imin)--;
+  if( ( *imax + 1 ) * ZEO_BREP_HASH_GRID - x <= zTOL ) (*imax)++;
+}
+
+/* find a vertex list cell from a hash index. */
+zBREPVertListCell *zBREPVertHashFind(const zBREPHash *hash, const zVec3D *v)
+{
+  long ix, iy, iz, ixmin, ixmax, iymin, iymax, izmin, izmax;
+  int i;
+  zBREPVertListCell *vp;
+
+  if( hash->size == 0 ) return NULL;
+  _zBREPVertHashRange( v->c.x, &ixmin, &ixmax );
+  _zBREPVertHashRange( v->c.y, &iymin, &iymax );
+  _zBREPVertHashRange( v->c.z, &izmin, &izmax );
+  for( ix=ixmin; ix<=ixmax; ix++ )
+    for( iy=iymin; iy<=iymax; iy++ )
+      for( iz=izmin; iz<=izmax; iz++ )
+        for( i=hash->bucket[_zBREPVertHashKey(ix,iy,iz) & (hash->size-1)]; i>=0; i=hash->entry[i].next ){
+          vp = (zBREPVertListCell *)hash->entry[i].cell;
+          if( zVec3DEqual( &vp->data.p, v ) ) return vp;
+        }
+  return NULL;
+}
+
+/* hash key of a pair of vertices (independent of the order). */
+static unsigned long _zBREPEdgeHashKey(const zBREPVertListCell *v1, const zBREPVertListCell *v2)
+{
+  unsigned long k1, k2;
+
+  k1 = (unsigned long)(size_t)v1 >> 4;
+  k2 = (unsigned long)(size_t)v2 >> 4;
+  return ( k1 < k2 ? k1 * 2654435761UL + k2 : k2 * 2654435761UL + k1 ) * 40503UL;
+}
+
+/* add an edge list cell to a hash index. */
+bool zBREPEdgeHashAdd(zBREPHash *hash, zBREPEdgeListCell *cell)
+{
+  return _zBREPHashAdd( hash, cell, _zBREPEdgeHashKey( cell->data.v[0], cell->data.v[1] ) );
+}
+
+/* find an edge list cell from a hash index. */
+zBREPEdgeListCell *zBREPEdgeHashFind(const zBREPHash *hash, const zBREPVertListCell *v1, const zBREPVertListCell *v2)
+{
+  int i;
+  zBREPEdgeListCell *ep;
+
+  if( hash->size == 0 ) return NULL;
+  for( i=hash->bucket[_zBREPEdgeHashKey(v1,v2) & (hash->size-1)]; i>=0; i=hash->entry[i].next ){
+    ep = (zBREPEdgeListCell *)hash->entry[i].cell;
+    if( ( ep->data.v[0] == v1 && ep->data.v[1] == v2 ) ||
+        ( ep->data.v[0] == v2 && ep->data.v[1] == v1 ) ) return ep;
+  }
+  return NULL;
+}
+
 /* ********************************************************** */
 /* CLASS: zBREP
  * B-Rep class
  * ********************************************************** */
 
-/* convert polyhedron to B-Rep solid. */
-zBREP *zPH3D2BREP(zPH3D *ph, zBREP *brep)
+/* convert polyhedron (restricted in a box if given) to B-Rep solid. */
+static zBREP *_zPH3D2BREP(zPH3D *ph, zAABox3D *box, zBREP *brep)
 {
+  zBREPHash vhash, ehash;
   int i;
 
   zListInit( &brep->vlist );
   zListInit( &brep->elist );
   zListInit( &brep->flist );
-  for( i=0; i<zPH3DFaceNum(ph); i++ )
-    if( !_zBREPFaceInsert( zPH3DFace(ph,i), &brep->flist, &brep->elist, &brep->vlist ) ){
+  zBREPHashInit( &vhash );
+  zBREPHashInit( &ehash );
+  for( i=0; i<zPH3DFaceNum(ph); i++ ){
+    if( box && !zColChkTriAABox3D( zPH3DFace(ph,i), box ) ) continue;
+    if( !_zBREPFaceInsert( zPH3DFace(ph,i), brep, &vhash, &ehash ) ){
       ZRUNERROR( ZEO_ERR_BREP_CONV );
       zBREPDestroy( brep );
-      return NULL;
+      brep = NULL;
+      break;
     }
+  }
+  zBREPHashDestroy( &vhash );
+  zBREPHashDestroy( &ehash );
   return brep;
 }
 
+/* convert polyhedron to B-Rep solid. */
+zBREP *zPH3D2BREP(zPH3D *ph, zBREP *brep)
+{
+  return _zPH3D2BREP( ph, NULL, brep );
+}
+
 /* convert polyhedron restricted in a box to B-Rep solid. */
 zBREP *zPH3D2BREPInBox(zPH3D *ph, zAABox3D *box, zBREP *brep)
 {
-  zTri3D *tri;
-  int i;
-
-  zListInit( &brep->vlist );
-  zListInit( &brep->elist );
-  zListInit( &brep->flist );
-  for( i=0; i<zPH3DFaceNum(ph); i++ ){
-    if( zColChkTriAABox3D( ( tri = zPH3DFace(ph,i) ), box ) ){
-      if( !_zBREPFaceInsert( zPH3DFace(ph,i), &brep->flist, &brep->elist, &brep->vlist ) ){
-        ZRUNERROR( ZEO_ERR_BREP_CONV );
-        zBREPDestroy( brep );
-        return NULL;
-      }
-    }
-  }
-  return brep;
+  return _zPH3D2BREP( ph, box, brep );
 }
 
 /* convert B-Rep solid to polyhedron. */
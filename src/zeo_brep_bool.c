@@ -6,31 +6,63 @@
 
 #include <zeo/zeo_brep.h>
 
-/* merge a B-Rep to another (destructive). */
-zBREP *zBREPMerge(zBREP *target, zBREP *sub)
+/* create hash indices of vertices and edges of a B-Rep. */
+static bool _zBREPMergeIndex(zBREP *brep, zBREPHash *vhash, zBREPHash *ehash)
+{
+  zBREPVertListCell *vp;
+  zBREPEdgeListCell *ep;
+
+  zListForEach( &brep->vlist, vp )
+    if( !zBREPVertHashAdd( vhash, vp ) ) return false;
+  zListForEach( &brep->elist, ep )
+    if( !zBREPEdgeHashAdd( ehash, ep ) ) return false;
+  return true;
+}
+
+/* mark vertices and ridges of a B-Rep shared with another. */
+static bool _zBREPMergeMark(zBREP *target, zBREP *sub, zBREPHash *vhash, zBREPHash *ehash)
 {
   zBREPVertListCell *vp;
   zBREPEdgeListCell *ep, *en;
-  zBREPFaceListCell *fp;
-  int i;
 
+  if( !_zBREPMergeIndex( target, vhash, ehash ) ) return false;
   /* mark vertices */
   zListForEach( &sub->vlist, vp )
-    vp->data._p = (void *)zBREPVertListFind( &target->vlist, &vp->data.p );
+    vp->data._p = (void *)zBREPVertHashFind( vhash, &vp->data.p );
   /* mark ridges */
   zListForEach( &sub->elist, ep ){
     ep->data._v = NULL;
     if( ep->data.v[0]->data._p && ep->data.v[1]->data._p )
-      if( !( ep->data._v = (void *)zBREPEdgeListFind( &target->elist, (zBREPVertListCell *)ep->data.v[0]->data._p, (zBREPVertListCell *)ep->data.v[1]->data._p ) ) ){
+      if( !( ep->data._v = (void *)zBREPEdgeHashFind( ehash, (zBREPVertListCell *)ep->data.v[0]->data._p, (zBREPVertListCell *)ep->data.v[1]->data._p ) ) ){
         if( !( en = zAlloc( zBREPEdgeListCell, 1 ) ) ){
           ZALLOCERROR();
-          return NULL;
+          return false;
         }
         zBREPEdgeListCellInit( en, ep->data.v[0]->data._p, ep->data.v[1]->data._p );
         ep->data._v = en;
         zListInsertHead( &target->elist, en );
+        if( !zBREPEdgeHashAdd( ehash, en ) ) return false;
       }
   }
+  return true;
+}
+
+/* merge a B-Rep to another (destructive). */
+zBREP *zBREPMerge(zBREP *target, zBREP *sub)
+{
+  zBREPVertListCell *vp;
+  zBREPEdgeListCell *ep;
+  zBREPFaceListCell *fp;
+  zBREPHash vhash, ehash;
+  bool ret;
+  int i;
+
+  zBREPHashInit( &vhash );
+  zBREPHashInit( &ehash );
+  ret = _zBREPMergeMark( target, sub, &vhash, &ehash );
+  zBREPHashDestroy( &vhash );
+  zBREPHashDestroy( &ehash );
+  if( !ret ) return NULL;
   /* reassign boundaries of faces */
   zListForEach( &sub->flist, fp )
     for( i=0; i<3; i++ ){
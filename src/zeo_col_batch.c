@@ -0,0 +1,105 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_batch - collision checking: batched narrow-phase checking.
+ */
+
+#include <zeo/zeo_col.h>
+
+typedef struct{
+  const zPH3D *ph;
+  const zShape3D *shape;
+  const zFrame3D *frame;
+  const zColPairSet *ps;
+  zColMethod method;
+  zColResult *result;
+} _zColBatch;
+
+/* assign the i-th body to a support map. */
+static void _zColBatchAssign(_zColBatch *batch, int i, zColSupport *support)
+{
+  const zFrame3D *frame;
+
+  frame = batch->frame ? &batch->frame[i] : NULL;
+  if( batch->ph )
+    zColSupportAssignPH3D( support, &batch->ph[i], frame );
+  else
+    zColSupportAssignShape3D( support, &batch->shape[i], frame );
+}
+
+/* check collisions of a chunk of pairs. */
+static void _zColBatchChunk(void *util, int id, int start, int end)
+{
+  _zColBatch *batch;
+  zColPair *pair;
+  zColResult *result;
+  zColSupport sup1, sup2;
+  int i;
+
+  batch = (_zColBatch *)util;
+  for( i=start; i<end; i++ ){
+    pair = zColPairSetElem( batch->ps, i );
+    result = &batch->result[i];
+    _zColBatchAssign( batch, pair->id1, &sup1 );
+    _zColBatchAssign( batch, pair->id2, &sup2 );
+    switch( batch->method ){
+    case ZEO_COL_GJK:
+      result->flag = batch->shape && !batch->frame ?
+        zColShape3D( &batch->shape[pair->id1], &batch->shape[pair->id2], &result->c1, &result->c2 ) :
+        zGJKSupport( &sup1, &sup2, &result->c1, &result->c2 );
+      break;
+    case ZEO_COL_MPR:
+      result->flag = zMPRSupport( &sup1, &sup2 );
+      break;
+    case ZEO_COL_MPR_DEPTH:
+      result->depth = 0;
+      result->flag = zMPRDepthSupport( &sup1, &sup2, &result->depth, &result->pos, &result->dir );
+      break;
+    default:
+      result->flag = false;
+    }
+  }
+}
+
+/* batched narrow-phase collision checking. */
+static int _zColBatch(_zColBatch *batch, int thread_num)
+{
+  int i, count = 0;
+
+  if( batch->method < ZEO_COL_GJK || batch->method > ZEO_COL_MPR_DEPTH ){
+    ZRUNERROR( ZEO_ERR_COL_BATCH_INVALID_METHOD, batch->method );
+    return 0;
+  }
+  zParallelFor( zColPairSetNum(batch->ps), thread_num, _zColBatchChunk, batch );
+  for( i=0; i<zColPairSetNum(batch->ps); i++ )
+    if( batch->result[i].flag ) count++;
+  return count;
+}
+
+/* batched narrow-phase collision checking of convex polyhedra. */
+int zColBatchPH3D(const zPH3D ph[], const zFrame3D frame[], const zColPairSet *ps, zColMethod method, zColResult result[], int thread_num)
+{
+  _zColBatch batch;
+
+  batch.ph = ph;
+  batch.shape = NULL;
+  batch.frame = frame;
+  batch.ps = ps;
+  batch.method = method;
+  batch.result = result;
+  return _zColBatch( &batch, thread_num );
+}
+
+/* batched narrow-phase collision checking of 3D shapes. */
+int zColBatchShape3D(const zShape3D shape[], const zFrame3D frame[], const zColPairSet *ps, zColMethod method, zColResult result[], int thread_num)
+{
+  _zColBatch batch;
+
+  batch.ph = NULL;
+  batch.shape = shape;
+  batch.frame = frame;
+  batch.ps = ps;
+  batch.method = method;
+  batch.result = result;
+  return _zColBatch( &batch, thread_num );
+}
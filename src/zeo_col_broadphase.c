@@ -0,0 +1,511 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_broadphase - collision checking: broad-phase culling.
+ */
+
+#include <zeo/zeo_col.h>
+
+/* ********************************************************** */
+/* a set of candidate pairs of colliding bodies
+ * ********************************************************** */
+
+#define ZEO_COL_PAIRSET_INIT_CAPACITY 16
+
+/* initialize a set of candidate pairs. */
+zColPairSet *zColPairSetInit(zColPairSet *ps)
+{
+  ps->num = ps->capacity = 0;
+  ps->buf = NULL;
+  return ps;
+}
+
+/* destroy a set of candidate pairs. */
+void zColPairSetDestroy(zColPairSet *ps)
+{
+  zFree( ps->buf );
+  zColPairSetInit( ps );
+}
+
+/* add a pair of identifiers to a set of candidate pairs. */
+bool zColPairSetAdd(zColPairSet *ps, int id1, int id2)
+{
+  zColPair *buf;
+  int capacity;
+
+  if( ps->num >= ps->capacity ){
+    capacity = ps->capacity > 0 ? ps->capacity * 2 : ZEO_COL_PAIRSET_INIT_CAPACITY;
+    if( !( buf = zRealloc( ps->buf, zColPair, capacity ) ) ){
+      ZALLOCERROR();
+      return false;
+    }
+    ps->buf = buf;
+    ps->capacity = capacity;
+  }
+  ps->buf[ps->num].id1 = _zMin( id1, id2 );
+  ps->buf[ps->num].id2 = _zMax( id1, id2 );
+  ps->num++;
+  return true;
+}
+
+/* ********************************************************** */
+/* sweep-and-prune over axis-aligned bounding boxes
+ * ********************************************************** */
+
+/* allocate internal buffers of sweep-and-prune. */
+zColSAP *zColSAPAlloc(zColSAP *sap, int num)
+{
+  int i;
+
+  sap->box = zAlloc( zAABox3D, num );
+  sap->order = zAlloc( int, num );
+  if( !sap->box || !sap->order ){
+    ZALLOCERROR();
+    zColSAPDestroy( sap );
+    return NULL;
+  }
+  for( i=0; i<num; i++ ){
+    zAABox3DInit( &sap->box[i] );
+    sap->order[i] = i;
+  }
+  sap->num = num;
+  sap->axis = zX;
+  return sap;
+}
+
+/* destroy internal buffers of sweep-and-prune. */
+void zColSAPDestroy(zColSAP *sap)
+{
+  zFree( sap->box );
+  zFree( sap->order );
+  sap->num = 0;
+  sap->axis = zX;
+}
+
+/* set a bounding box of a body in sweep-and-prune. */
+zAABox3D *zColSAPSetBox(zColSAP *sap, int i, const zAABox3D *box)
+{
+  if( i < 0 || i >= sap->num ){
+    ZRUNERROR( ZEO_ERR_COL_BROADPHASE_INVALID_ID, i );
+    return NULL;
+  }
+  return zAABox3DCopy( box, &sap->box[i] );
+}
+
+/* set a bounding box of a set of 3D points in sweep-and-prune. */
+zAABox3D *zColSAPSetData(zColSAP *sap, int i, zVec3DData *data)
+{
+  if( i < 0 || i >= sap->num ){
+    ZRUNERROR( ZEO_ERR_COL_BROADPHASE_INVALID_ID, i );
+    return NULL;
+  }
+  return zVec3DDataAABB( data, &sap->box[i], NULL );
+}
+
+/* set a bounding box of a polyhedron in sweep-and-prune. */
+zAABox3D *zColSAPSetPH3D(zColSAP *sap, int i, const zPH3D *ph)
+{
+  int j;
+
+  if( i < 0 || i >= sap->num ){
+    ZRUNERROR( ZEO_ERR_COL_BROADPHASE_INVALID_ID, i );
+    return NULL;
+  }
+  if( zPH3DVertNum(ph) <= 0 ) return zAABox3DInit( &sap->box[i] );
+  zVec3DCopy( zPH3DVert(ph,0), &sap->box[i].min );
+  zVec3DCopy( zPH3DVert(ph,0), &sap->box[i].max );
+  for( j=1; j<zPH3DVertNum(ph); j++ )
+    zAABox3DEnlarge( &sap->box[i], zPH3DVert(ph,j) );
+  return &sap->box[i];
+}
+
+/* choose the axis along which the centers of boxes are the most scattered. */
+static zAxis _zColSAPChooseAxis(zColSAP *sap)
+{
+  zVec3D c, s, s2;
+  zAxis axis;
+  int i;
+
+  if( sap->num < 2 ) return sap->axis;
+  zVec3DZero( &s );
+  zVec3DZero( &s2 );
+  for( i=0; i<sap->num; i++ ){
+    zAABox3DCenter( &sap->box[i], &c );
+    zVec3DAddDRC( &s, &c );
+    s2.c.x += zSqr( c.c.x );
+    s2.c.y += zSqr( c.c.y );
+    s2.c.z += zSqr( c.c.z );
+  }
+  for( axis=zX, i=zY; i<=zZ; i++ ) /* variance scaled by num */
+    if( s2.e[i] - zSqr(s.e[i])/sap->num > s2.e[(int)axis] - zSqr(s.e[(int)axis])/sap->num )
+      axis = (zAxis)i;
+  return axis;
+}
+
+/* update sweep-and-prune by insertion sort. */
+void zColSAPUpdate(zColSAP *sap)
+{
+  int i, j, id;
+  double key;
+
+  sap->axis = _zColSAPChooseAxis( sap );
+  for( i=1; i<sap->num; i++ ){
+    id = sap->order[i];
+    key = sap->box[id].min.e[(int)sap->axis];
+    for( j=i-1; j>=0 && sap->box[sap->order[j]].min.e[(int)sap->axis] > key; j-- )
+      sap->order[j+1] = sap->order[j];
+    sap->order[j+1] = id;
+  }
+}
+
+/* find candidate pairs of colliding bodies by sweep-and-prune. */
+int zColSAPPair(zColSAP *sap, zColPairSet *ps)
+{
+  int i, j;
+  zAABox3D *bi, *bj;
+
+  zColSAPUpdate( sap );
+  zColPairSetClear( ps );
+  for( i=0; i<sap->num; i++ ){
+    bi = &sap->box[sap->order[i]];
+    for( j=i+1; j<sap->num; j++ ){
+      bj = &sap->box[sap->order[j]];
+      if( bj->min.e[(int)sap->axis] >= bi->max.e[(int)sap->axis] ) break;
+      if( zColChkAABox3D( bi, bj ) &&
+          !zColPairSetAdd( ps, sap->order[i], sap->order[j] ) ) return -1;
+    }
+  }
+  return zColPairSetNum(ps);
+}
+
+/* ********************************************************** */
+/* dynamic AABB tree
+ * ********************************************************** */
+
+#define ZEO_COL_AABBTREE_INIT_CAPACITY 16
+
+#define _zColAABBTreeNodeIsLeaf(node) ( (node)->child[0] < 0 )
+
+/* surface area of an axis-aligned box, which is the cost to be minimized in insertion. */
+static double _zAABox3DArea(const zAABox3D *box)
+{
+  double dx, dy, dz;
+
+  dx = zAABox3DDepth(box);
+  dy = zAABox3DWidth(box);
+  dz = zAABox3DHeight(box);
+  return 2 * ( dx*dy + dy*dz + dz*dx );
+}
+
+/* check if an axis-aligned box contains another. */
+static bool _zAABox3DContain(const zAABox3D *box, const zAABox3D *sub)
+{
+  return box->min.c.x <= sub->min.c.x && box->min.c.y <= sub->min.c.y && box->min.c.z <= sub->min.c.z &&
+         box->max.c.x >= sub->max.c.x && box->max.c.y >= sub->max.c.y && box->max.c.z >= sub->max.c.z ?
+    true : false;
+}
+
+/* initialize a dynamic AABB tree. */
+zColAABBTree *zColAABBTreeInit(zColAABBTree *tree, double margin)
+{
+  tree->root = tree->freenode = -1;
+  tree->capacity = 0;
+  tree->node = NULL;
+  tree->margin = margin > 0 ? margin : ZEO_COL_AABBTREE_DEFAULT_MARGIN;
+  return tree;
+}
+
+/* destroy a dynamic AABB tree. */
+void zColAABBTreeDestroy(zColAABBTree *tree)
+{
+  zFree( tree->node );
+  zColAABBTreeInit( tree, tree->margin );
+}
+
+/* allocate a node of a dynamic AABB tree from the pool. */
+static int _zColAABBTreeNodeAlloc(zColAABBTree *tree)
+{
+  zColAABBTreeNode *node;
+  int i, capacity;
+
+  if( tree->freenode < 0 ){
+    capacity = tree->capacity > 0 ? tree->capacity * 2 : ZEO_COL_AABBTREE_INIT_CAPACITY;
+    if( !( node = zRealloc( tree->node, zColAABBTreeNode, capacity ) ) ){
+      ZALLOCERROR();
+      return -1;
+    }
+    for( i=tree->capacity; i<capacity; i++ ){
+      node[i].parent = i + 1;
+      node[i].height = -1;
+    }
+    node[capacity-1].parent = -1;
+    tree->node = node;
+    tree->freenode = tree->capacity;
+    tree->capacity = capacity;
+  }
+  i = tree->freenode;
+  node = &tree->node[i];
+  tree->freenode = node->parent;
+  node->parent = node->child[0] = node->child[1] = -1;
+  node->height = 0;
+  node->id = -1;
+  return i;
+}
+
+/* return a node of a dynamic AABB tree to the pool. */
+static void _zColAABBTreeNodeFree(zColAABBTree *tree, int i)
+{
+  tree->node[i].parent = tree->freenode;
+  tree->node[i].height = -1;
+  tree->freenode = i;
+}
+
+/* replace a child of a node of a dynamic AABB tree, or the root. */
+static void _zColAABBTreeReplaceChild(zColAABBTree *tree, int parent, int oldchild, int newchild)
+{
+  if( parent < 0 )
+    tree->root = newchild;
+  else
+  if( tree->node[parent].child[0] == oldchild )
+    tree->node[parent].child[0] = newchild;
+  else
+    tree->node[parent].child[1] = newchild;
+}
+
+/* update the box and the height of a branch node of a dynamic AABB tree. */
+static void _zColAABBTreeNodeRefit(zColAABBTree *tree, int i)
+{
+  zColAABBTreeNode *n, *c0, *c1;
+
+  n = &tree->node[i];
+  c0 = &tree->node[n->child[0]];
+  c1 = &tree->node[n->child[1]];
+  zAABox3DMerge( &n->box, &c0->box, &c1->box );
+  n->height = 1 + _zMax( c0->height, c1->height );
+}
+
+/* rotate the \a s th child of a node of a dynamic AABB tree up. */
+static int _zColAABBTreeRotate(zColAABBTree *tree, int ia, int s)
+{
+  zColAABBTreeNode *a, *c;
+  int ic, ilow, ihigh;
+
+  a = &tree->node[ia];
+  ic = a->child[s];
+  c = &tree->node[ic];
+  if( tree->node[c->child[0]].height > tree->node[c->child[1]].height ){
+    ihigh = c->child[0]; ilow = c->child[1];
+  } else{
+    ihigh = c->child[1]; ilow = c->child[0];
+  }
+  /* c takes the place of a, and a adopts the lower grandchild */
+  c->parent = a->parent;
+  _zColAABBTreeReplaceChild( tree, c->parent, ia, ic );
+  c->child[0] = ia;
+  c->child[1] = ihigh;
+  a->parent = ic;
+  a->child[s] = ilow;
+  tree->node[ilow].parent = ia;
+  _zColAABBTreeNodeRefit( tree, ia );
+  _zColAABBTreeNodeRefit( tree, ic );
+  return ic;
+}
+
+/* balance a subtree of a dynamic AABB tree by a local rotation. */
+static int _zColAABBTreeBalance(zColAABBTree *tree, int ia)
+{
+  zColAABBTreeNode *a;
+  int balance;
+
+  a = &tree->node[ia];
+  if( _zColAABBTreeNodeIsLeaf(a) || a->height < 2 ) return ia;
+  balance = tree->node[a->child[1]].height - tree->node[a->child[0]].height;
+  if( balance > 1 ) return _zColAABBTreeRotate( tree, ia, 1 );
+  if( balance < -1 ) return _zColAABBTreeRotate( tree, ia, 0 );
+  return ia;
+}
+
+/* refit and balance ancestors of a node of a dynamic AABB tree. */
+static void _zColAABBTreeRefitUpward(zColAABBTree *tree, int i)
+{
+  while( i >= 0 ){
+    i = _zColAABBTreeBalance( tree, i );
+    _zColAABBTreeNodeRefit( tree, i );
+    i = tree->node[i].parent;
+  }
+}
+
+/* cost to descend to a child of a node of a dynamic AABB tree. */
+static double _zColAABBTreeDescendCost(zColAABBTree *tree, int i, const zAABox3D *box, double inheritcost)
+{
+  zAABox3D merged;
+  double cost;
+
+  cost = _zAABox3DArea( zAABox3DMerge( &merged, box, &tree->node[i].box ) ) + inheritcost;
+  if( !_zColAABBTreeNodeIsLeaf(&tree->node[i]) )
+    cost -= _zAABox3DArea( &tree->node[i].box );
+  return cost;
+}
+
+/* insert a leaf to a dynamic AABB tree. */
+static bool _zColAABBTreeInsertLeaf(zColAABBTree *tree, int leaf)
+{
+  zAABox3D box, merged;
+  double area, cost, cost0, cost1, inheritcost;
+  int i, sibling, parent;
+
+  if( tree->root < 0 ){
+    tree->root = leaf;
+    tree->node[leaf].parent = -1;
+    return true;
+  }
+  zAABox3DCopy( &tree->node[leaf].box, &box );
+  /* find the best sibling in terms of the surface area heuristic */
+  for( i=tree->root; !_zColAABBTreeNodeIsLeaf(&tree->node[i]); ){
+    area = _zAABox3DArea( &tree->node[i].box );
+    cost = 2 * _zAABox3DArea( zAABox3DMerge( &merged, &tree->node[i].box, &box ) );
+    inheritcost = cost - 2 * area;
+    cost0 = _zColAABBTreeDescendCost( tree, tree->node[i].child[0], &box, inheritcost );
+    cost1 = _zColAABBTreeDescendCost( tree, tree->node[i].child[1], &box, inheritcost );
+    if( cost < cost0 && cost < cost1 ) break;
+    i = tree->node[i].child[ cost0 < cost1 ? 0 : 1 ];
+  }
+  sibling = i;
+  /* create a new parent (note that the node buffer might be reallocated) */
+  if( ( parent = _zColAABBTreeNodeAlloc( tree ) ) < 0 ) return false;
+  tree->node[parent].parent = tree->node[sibling].parent;
+  _zColAABBTreeReplaceChild( tree, tree->node[parent].parent, sibling, parent );
+  tree->node[parent].child[0] = sibling;
+  tree->node[parent].child[1] = leaf;
+  tree->node[sibling].parent = parent;
+  tree->node[leaf].parent = parent;
+  _zColAABBTreeRefitUpward( tree, parent );
+  return true;
+}
+
+/* remove a leaf from a dynamic AABB tree. */
+static void _zColAABBTreeRemoveLeaf(zColAABBTree *tree, int leaf)
+{
+  int parent, grandparent, sibling;
+
+  if( leaf == tree->root ){
+    tree->root = -1;
+    return;
+  }
+  parent = tree->node[leaf].parent;
+  grandparent = tree->node[parent].parent;
+  sibling = tree->node[parent].child[ tree->node[parent].child[0] == leaf ? 1 : 0 ];
+  _zColAABBTreeReplaceChild( tree, grandparent, parent, sibling );
+  tree->node[sibling].parent = grandparent;
+  _zColAABBTreeNodeFree( tree, parent );
+  _zColAABBTreeRefitUpward( tree, grandparent );
+}
+
+/* fatten a box for a leaf of a dynamic AABB tree. */
+static void _zColAABBTreeFatten(zColAABBTree *tree, int leaf, const zAABox3D *box)
+{
+  zAABox3DCreate( &tree->node[leaf].box,
+    box->min.c.x - tree->margin, box->min.c.y - tree->margin, box->min.c.z - tree->margin,
+    box->max.c.x + tree->margin, box->max.c.y + tree->margin, box->max.c.z + tree->margin );
+}
+
+/* insert a body to a dynamic AABB tree. */
+int zColAABBTreeInsert(zColAABBTree *tree, const zAABox3D *box, int id)
+{
+  int leaf;
+
+  if( ( leaf = _zColAABBTreeNodeAlloc( tree ) ) < 0 ) return -1;
+  _zColAABBTreeFatten( tree, leaf, box );
+  tree->node[leaf].id = id;
+  if( !_zColAABBTreeInsertLeaf( tree, leaf ) ){
+    _zColAABBTreeNodeFree( tree, leaf );
+    return -1;
+  }
+  return leaf;
+}
+
+/* remove a body from a dynamic AABB tree. */
+void zColAABBTreeRemove(zColAABBTree *tree, int leaf)
+{
+  if( leaf < 0 || leaf >= tree->capacity || tree->node[leaf].height != 0 ){
+    ZRUNERROR( ZEO_ERR_COL_BROADPHASE_INVALID_LEAF, leaf );
+    return;
+  }
+  _zColAABBTreeRemoveLeaf( tree, leaf );
+  _zColAABBTreeNodeFree( tree, leaf );
+}
+
+/* move a body in a dynamic AABB tree. */
+bool zColAABBTreeMove(zColAABBTree *tree, int leaf, const zAABox3D *box)
+{
+  if( leaf < 0 || leaf >= tree->capacity || tree->node[leaf].height != 0 ){
+    ZRUNERROR( ZEO_ERR_COL_BROADPHASE_INVALID_LEAF, leaf );
+    return false;
+  }
+  if( _zAABox3DContain( &tree->node[leaf].box, box ) ) return false;
+  _zColAABBTreeRemoveLeaf( tree, leaf );
+  _zColAABBTreeFatten( tree, leaf, box );
+  /* the removed parent node is reused, so that the insertion never fails. */
+  _zColAABBTreeInsertLeaf( tree, leaf );
+  return true;
+}
+
+/* find bodies in a subtree of a dynamic AABB tree that overlap with a box. */
+static int _zColAABBTreeQuery(const zColAABBTree *tree, int i, const zAABox3D *box, int id[], int size, int n)
+{
+  const zColAABBTreeNode *node;
+
+  node = &tree->node[i];
+  if( !zColChkAABox3D( &node->box, box ) ) return n;
+  if( _zColAABBTreeNodeIsLeaf(node) ){
+    if( n < size ) id[n] = node->id;
+    return n + 1;
+  }
+  n = _zColAABBTreeQuery( tree, node->child[0], box, id, size, n );
+  return _zColAABBTreeQuery( tree, node->child[1], box, id, size, n );
+}
+
+/* find bodies in a dynamic AABB tree that overlap with a box. */
+int zColAABBTreeQuery(const zColAABBTree *tree, const zAABox3D *box, int id[], int size)
+{
+  return tree->root < 0 ? 0 : _zColAABBTreeQuery( tree, tree->root, box, id, size, 0 );
+}
+
+/* find overlapping pairs of bodies between two subtrees of a dynamic AABB tree. */
+static bool _zColAABBTreePairCross(const zColAABBTree *tree, int i1, int i2, zColPairSet *ps)
+{
+  const zColAABBTreeNode *n1, *n2;
+
+  n1 = &tree->node[i1];
+  n2 = &tree->node[i2];
+  if( !zColChkAABox3D( &n1->box, &n2->box ) ) return true;
+  if( _zColAABBTreeNodeIsLeaf(n1) && _zColAABBTreeNodeIsLeaf(n2) )
+    return zColPairSetAdd( ps, n1->id, n2->id );
+  /* descend the larger subtree */
+  if( _zColAABBTreeNodeIsLeaf(n1) ||
+      ( !_zColAABBTreeNodeIsLeaf(n2) && _zAABox3DArea( &n2->box ) > _zAABox3DArea( &n1->box ) ) )
+    return _zColAABBTreePairCross( tree, i1, n2->child[0], ps ) &&
+           _zColAABBTreePairCross( tree, i1, n2->child[1], ps );
+  return _zColAABBTreePairCross( tree, n1->child[0], i2, ps ) &&
+         _zColAABBTreePairCross( tree, n1->child[1], i2, ps );
+}
+
+/* find overlapping pairs of bodies in a subtree of a dynamic AABB tree. */
+static bool _zColAABBTreePair(const zColAABBTree *tree, int i, zColPairSet *ps)
+{
+  const zColAABBTreeNode *node;
+
+  node = &tree->node[i];
+  if( _zColAABBTreeNodeIsLeaf(node) ) return true;
+  return _zColAABBTreePairCross( tree, node->child[0], node->child[1], ps ) &&
+         _zColAABBTreePair( tree, node->child[0], ps ) &&
+         _zColAABBTreePair( tree, node->child[1], ps );
+}
+
+/* find overlapping pairs of bodies in a dynamic AABB tree. */
+int zColAABBTreePair(const zColAABBTree *tree, zColPairSet *ps)
+{
+  zColPairSetClear( ps );
+  if( tree->root >= 0 && !_zColAABBTreePair( tree, tree->root, ps ) ) return -1;
+  return zColPairSetNum(ps);
+}
@@ -12,8 +12,9 @@ typedef struct{
   bool sw_w;  /* included in W (the smallest simplex) */
   bool sw_y;  /* included in Y (the updated simplex) */
   zVec3D w;   /* the destination of support map for Minkowski's sum */
-  const zVec3D *p1; /* corresponding vertex on object 1 to the support map */
-  const zVec3D *p2; /* corresponding vertex on object 2 to the support map */
+  zVec3D p1;  /* corresponding point on object 1 to the support map */
+  zVec3D p2;  /* corresponding point on object 2 to the support map */
+  zVec3D v;   /* direction of the support map */
   double s;   /* linear sum coefficient : Weights used to represent nearest neighbors as linear combinations of simplex vertices, and used to exclude unnecessary vertices. If the weight becomes zero, that vertex is considered unused. */
 } zGJKSlot;
 
@@ -27,7 +28,9 @@ static void _zGJKSlotInit(zGJKSlot *slot)
 {
   slot->sw_w = slot->sw_y = false;
   zVec3DZero( &slot->w );
-  slot->p1 = slot->p2 = NULL;
+  zVec3DZero( &slot->p1 );
+  zVec3DZero( &slot->p2 );
+  zVec3DZero( &slot->v );
   slot->s = 0;
 }
 
@@ -36,16 +39,16 @@ static void _zGJKSlotInit(zGJKSlot *slot)
 static void _zGJKSlotPrint(zGJKSlot *slot)
 {
   printf( " w: " ); zVec3DPrint( &slot->w );
-  printf( " p1: " ); zVec3DPrint( slot->p1 );
-  printf( " p2: " ); zVec3DPrint( slot->p2 );
+  printf( " p1: " ); zVec3DPrint( &slot->p1 );
+  printf( " p2: " ); zVec3DPrint( &slot->p2 );
   printf( " s = %g\n", slot->s );
 }
 
 /* print out vertices of a slot. */
 static void _zGJKSlotVertFPrint(FILE *fp, zGJKSlot *slot)
 {
-  zVec3DValueFPrint( fp, slot->p1 );
-  zVec3DValueFPrint( fp, slot->p2 );
+  zVec3DValueFPrint( fp, &slot->p1 );
+  zVec3DValueFPrint( fp, &slot->p2 );
 }
 #endif
 
@@ -129,8 +132,9 @@ static int _zGJKSimplexAddSlot(zGJKSimplex *s, zGJKSlot *slot)
     if( !s->slot[i].sw_y ){
       s->slot[i].sw_y = true;
       zVec3DCopy( &slot->w, &s->slot[i].w );
-      s->slot[i].p1 = slot->p1;
-      s->slot[i].p2 = slot->p2;
+      zVec3DCopy( &slot->p1, &s->slot[i].p1 );
+      zVec3DCopy( &slot->p2, &s->slot[i].p2 );
+      zVec3DCopy( &slot->v, &s->slot[i].v );
       s->slot[i].s = slot->s;
       return i;
     }
@@ -183,18 +187,19 @@ static zVec3D *_zGJKSimplexClosest(zGJKSimplex *s, zVec3D *v)
 
 /* support map of Minkowski difference. */
 /* @param[out] s      slots that are simplex elements (3D vertex w, etc.) */
-/* @param[in]  data1  3D vertices 1 (must be made from convex hull) */
-/* @param[in]  data2  3D vertices 2 (must be made from convex hull) */
+/* @param[in]  sup1   support map of convex object 1 */
+/* @param[in]  sup2   support map of convex object 2 */
 /* @param[in]  v      separating axis for suppport mapping (and get reverse vector nv) */
-/* @return  the edge in Minkowski difference space (data1 - data2) */
-static zVec3D *_zGJKSupportMap(zGJKSlot *slot, zVec3DData *data1, zVec3DData *data2, zVec3D *v)
+/* @return  the edge in Minkowski difference space (object1 - object2), or the null pointer if support mapping fails */
+static zVec3D *_zGJKSupportMap(zGJKSlot *slot, zColSupport *sup1, zColSupport *sup2, const zVec3D *v)
 {
   zVec3D nv;
 
   zVec3DRev( v, &nv );
-  slot->p1 = zVec3DDataSupportMap( data1, &nv );
-  slot->p2 = zVec3DDataSupportMap( data2,   v );
-  zVec3DSub( slot->p1, slot->p2, &slot->w );
+  if( !zColSupportMap( sup1, &nv, &slot->p1 ) ||
+      !zColSupportMap( sup2,   v, &slot->p2 ) ) return NULL;
+  zVec3DSub( &slot->p1, &slot->p2, &slot->w );
+  zVec3DCopy( v, &slot->v );
   return &slot->w;
 }
 
@@ -207,8 +212,8 @@ static void _zGJKPair(zGJKSimplex *s, zVec3D *c1, zVec3D *c2)
   zVec3DZero( c2 );
   for( i=0; i<4; i++ )
     if( s->slot[i].sw_w ){
-      zVec3DCatDRC( c1, s->slot[i].s, s->slot[i].p1 );
-      zVec3DCatDRC( c2, s->slot[i].s, s->slot[i].p2 );
+      zVec3DCatDRC( c1, s->slot[i].s, &s->slot[i].p1 );
+      zVec3DCatDRC( c2, s->slot[i].s, &s->slot[i].p2 );
     }
 }
 
@@ -252,24 +257,24 @@ static zGJKSlotListCell *_zGJKSlotListInsert(zGJKSlotList *sl, zGJKSlot *s)
     return NULL;
   }
   zVec3DCopy( &s->w, &sc->data.w );
-  sc->data.p1 = s->p1;
-  sc->data.p2 = s->p2;
+  zVec3DCopy( &s->p1, &sc->data.p1 );
+  zVec3DCopy( &s->p2, &sc->data.p2 );
   zListInsertHead( sl, sc );
   return sc;
 }
 
-/* @param[in]     data1      3D vertices 1 (must be made from convex hull) */
-/* @param[in]     data2      3D vertices 2 (must be made from convex hull) */
+/* @param[in]     sup1       support map of convex object 1 */
+/* @param[in]     sup2       support map of convex object 2 */
 /* @param[in,out] slist      A list for accumulating slots that are simplex elements (3D vertex w, etc.) alongside the update process of simplex `s` */
 /* @param[in,out] vert_data  A set of 3D vertices `s->w` which `slist` has */
 /* @param[in]     v          */
 /* @param[in]     edge       */
 /* @param[in]     tri        */
-static bool _zGJKPDAddPoint(zVec3DData *data1, zVec3DData *data2, zGJKSlotList *slist, zVec3DData *vert_data, zVec3D *v, zEdge3D *edge, zTri3D *tri)
+static bool _zGJKPDAddPoint(zColSupport *sup1, zColSupport *sup2, zGJKSlotList *slist, zVec3DData *vert_data, zVec3D *v, zEdge3D *edge, zTri3D *tri)
 {
   zGJKSlot  ns;
 
-  _zGJKSupportMap( &ns, data1, data2, v );
+  if( !_zGJKSupportMap( &ns, sup1, sup2, v ) ) return false;
   if( ( edge != NULL && zIsTiny( zEdge3DDistFromPoint( edge, &ns.w ) ) ) ||
       ( tri != NULL && zIsTiny( zTri3DDistFromPoint( tri, &ns.w ) ) ) )
     return false;
@@ -280,12 +285,12 @@ static bool _zGJKPDAddPoint(zVec3DData *data1, zVec3DData *data2, zGJKSlotList *
 
 /* This function aims to convert the simplex into a 3D solid (with n vertices ≥ 4). */
 /* Assumption: The number of vertices n in the simplex should be 2 ≤ n ≤ 4. */
-/* @param[in]     data1      3D vertices 1 (must be made from convex hull) */
-/* @param[in]     data2      3D vertices 2 (must be made from convex hull) */
+/* @param[in]     sup1       support map of convex object 1 */
+/* @param[in]     sup2       support map of convex object 2 */
 /* @param[in]     s          simplex from GJK */
 /* @param[in,out] slist      A list for accumulating slots that are simplex elements (3D vertex w, etc.) alongside the update process of simplex `s` */
 /* @param[out]    vert_data  A set of 3D vertices `s->w` which `slist` has */
-static bool _zGJKPDInit(zVec3DData *data1, zVec3DData *data2, zGJKSimplex *s, zGJKSlotList *slist, zVec3DData *vert_data)
+static bool _zGJKPDInit(zColSupport *sup1, zColSupport *sup2, zGJKSimplex *s, zGJKSlotList *slist, zVec3DData *vert_data)
 {
   int i;
   zGJKSlotListCell *sc;
@@ -310,16 +315,16 @@ static bool _zGJKPDInit(zVec3DData *data1, zVec3DData *data2, zGJKSimplex *s, zG
     if( !zVec3DOrthoSpace( zEdge3DVec(&edge), &v1, &v2 ) )
       return false;
     /* v1 is the one separating axis vector in the Minkowski difference space */
-    if( !_zGJKPDAddPoint( data1, data2, slist, vert_data, &v1, &edge, NULL ) )
+    if( !_zGJKPDAddPoint( sup1, sup2, slist, vert_data, &v1, &edge, NULL ) )
       return false;
     /* v2 is the another separating axis vector in the Minkowski difference space */
-    if( !_zGJKPDAddPoint( data1, data2, slist, vert_data, &v2, &edge, NULL ) )
+    if( !_zGJKPDAddPoint( sup1, sup2, slist, vert_data, &v2, &edge, NULL ) )
       return false;
     /* -v1 */
-    if( !_zGJKPDAddPoint( data1, data2, slist, vert_data, zVec3DRevDRC( &v1 ), &edge, NULL ) )
+    if( !_zGJKPDAddPoint( sup1, sup2, slist, vert_data, zVec3DRevDRC( &v1 ), &edge, NULL ) )
       return false;
     /* -v2 */
-    if( !_zGJKPDAddPoint( data1, data2, slist, vert_data, zVec3DRevDRC( &v2 ), &edge, NULL ) )
+    if( !_zGJKPDAddPoint( sup1, sup2, slist, vert_data, zVec3DRevDRC( &v2 ), &edge, NULL ) )
       return false;
     if( zVec3DDataConvexHull( vert_data, &ph ) == NULL )
       return false;
@@ -333,10 +338,10 @@ static bool _zGJKPDInit(zVec3DData *data1, zVec3DData *data2, zGJKSimplex *s, zG
     if( zTri3DCreate( &tri, &s->slot[0].w, &s->slot[1].w, &s->slot[2].w ) == NULL )
       return false;
     /* normal vector of plane of 3 vertices */
-    if( !_zGJKPDAddPoint( data1, data2, slist, vert_data, zTri3DNorm(&tri), NULL, &tri ) )
+    if( !_zGJKPDAddPoint( sup1, sup2, slist, vert_data, zTri3DNorm(&tri), NULL, &tri ) )
       return false;
     /* inversed normal vector */
-    if( !_zGJKPDAddPoint( data1, data2, slist, vert_data, zVec3DRev( zTri3DNorm(&tri), &v1 ), NULL, &tri ) )
+    if( !_zGJKPDAddPoint( sup1, sup2, slist, vert_data, zVec3DRev( zTri3DNorm(&tri), &v1 ), NULL, &tri ) )
       return false;
   }
 
@@ -344,17 +349,17 @@ static bool _zGJKPDInit(zVec3DData *data1, zVec3DData *data2, zGJKSimplex *s, zG
 }
 
 /* initialize simplex as tetrahedron */
-/* @param[in]  data1      3D vertices 1 (must be made from convex hull) */
-/* @param[in]  data2      3D vertices 2 (must be made from convex hull) */
+/* @param[in]  sup1       support map of convex object 1 */
+/* @param[in]  sup2       support map of convex object 2 */
 /* @param[in]  s          simplex from GJK */
 /* @param[out] slist      A list for accumulating slots that are simplex elements (3D vertex w, etc.) alongside the update process of simplex `s` */
 /* @param[out] vert_data  A set of 3D vertices `s->w` which `slist` has */
 /* @return  If successful, true */
-static bool _zGJKPDInitSimplex3D(zVec3DData *data1, zVec3DData *data2, zGJKSimplex *s, zGJKSlotList *slist, zVec3DData *vert_data)
+static bool _zGJKPDInitSimplex3D(zColSupport *sup1, zColSupport *sup2, zGJKSimplex *s, zGJKSlotList *slist, zVec3DData *vert_data)
 {
   zListInit( slist );
   zVec3DDataInitList( vert_data );
-  if( _zGJKPDInit( data1, data2, s, slist, vert_data ) )
+  if( _zGJKPDInit( sup1, sup2, s, slist, vert_data ) )
     return true;
   zVec3DDataDestroy( vert_data );
   zListDestroy( zGJKSlotListCell, slist );
@@ -362,13 +367,13 @@ static bool _zGJKPDInitSimplex3D(zVec3DData *data1, zVec3DData *data2, zGJKSimpl
 }
 
 /* penetration depth */
-/* @param[in]  data1  3D vertices 1 (must be made from convex hull) */
-/* @param[in]  data2  3D vertices 2 (must be made from convex hull) */
-/* @param[out] c1     deepest penetration depth of data1 */
-/* @param[out] c2     deepest penetration depth of data2 */
+/* @param[in]  sup1   support map of convex object 1 */
+/* @param[in]  sup2   support map of convex object 2 */
+/* @param[out] c1     deepest penetration depth of object 1 */
+/* @param[out] c2     deepest penetration depth of object 2 */
 /* @param[in]  s      simplex from GJK */
 /* @return  If the search for depth succeeds, true */
-static bool _zGJKPD(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2, zGJKSimplex *s)
+static bool _zGJKPD(zColSupport *sup1, zColSupport *sup2, zVec3D *c1, zVec3D *c2, zGJKSimplex *s)
 {
   int i, j;
   zGJKSlot  ns;
@@ -377,16 +382,17 @@ static bool _zGJKPD(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2
   zVec3D v, v_temp;
   zVec3DData vert_data;
   zPH3D ph;
-  int id = 0;
+  int id = 0, k, iter = 0;
   double l[3];
 
   /* Question (Naive Approach): */
   /*  When the simplex vertices are 1, 2, and 3,       */
   /*  this means the penetration depth is 0,           */
   /*  so shouldn't the function terminate immediately? */
-  if( !_zGJKPDInitSimplex3D( data1, data2, s, &slist, &vert_data ) ) return false;
+  if( !_zGJKPDInitSimplex3D( sup1, sup2, s, &slist, &vert_data ) ) return false;
   zVec3DZero( &v_temp );
-  while( 1 ){
+  ZITERINIT( iter );
+  for( k=0; ; k++ ){
     if( zVec3DDataConvexHull( &vert_data, &ph ) == NULL ){
       zVec3DDataDestroy( &vert_data );
       zListDestroy( zGJKSlotListCell, &slist );
@@ -394,9 +400,18 @@ static bool _zGJKPD(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2
     }
     _zGJKPH3DClosest( &ph, ZVEC3DZERO, &v, &id );
     if( zVec3DEqual( &v, &v_temp ) ) break; /* success! */
+    if( k >= iter ){ /* curved objects might not converge exactly */
+      ZITERWARN( iter );
+      break;
+    }
     zVec3DCopy( &v, &v_temp );
     zVec3DRevDRC( &v );
-    _zGJKSupportMap( &ns, data1, data2, &v );
+    if( !_zGJKSupportMap( &ns, sup1, sup2, &v ) ){
+      zPH3DDestroy( &ph );
+      zVec3DDataDestroy( &vert_data );
+      zListDestroy( zGJKSlotListCell, &slist );
+      return false;
+    }
     zListForEach( &slist, sc )
       if( zVec3DEqual( &ns.w, &sc->data.w ) ) goto BREAK;
     _zGJKSlotListInsert( &slist, &ns );
@@ -411,8 +426,8 @@ static bool _zGJKPD(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2
   zListForEach( &slist, sc ){
     for( i=0; i<3; i++ ){
       if( zVec3DEqual( zPH3DFaceVert(&ph,id,i), &sc->data.w ) ){
-        zVec3DCatDRC( c1, l[i], sc->data.p1 );
-        zVec3DCatDRC( c2, l[i], sc->data.p2 );
+        zVec3DCatDRC( c1, l[i], &sc->data.p1 );
+        zVec3DCatDRC( c2, l[i], &sc->data.p2 );
         j++;
       }
     }
@@ -441,20 +456,59 @@ static bool _zGJKCheck(zGJKSimplex *s)
   return false;
 }
 
-static bool _zGJK(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2, zGJKSimplex *s)
+/* seed GJK simplex from a cache. */
+static bool _zGJKSimplexSeed(zGJKSimplex *s, zColSupport *sup1, zColSupport *sup2, zGJKCache *cache, zVec3D *proximity, double *dv2norm)
+{
+  zGJKSlot slot;
+  int i;
+
+  for( i=0; i<cache->n && s->n<4; i++ ){
+    if( !_zGJKSupportMap( &slot, sup1, sup2, &cache->dir[i] ) ) return false;
+    if( _zGJKSimplexCheckDupSlot( s, &slot ) ) continue;
+    _zGJKSimplexAddSlot( s, &slot );
+    _zGJKSimplexClosest( s, proximity );
+    *dv2norm = zVec3DSqrNorm( proximity );
+  }
+  if( s->n > 0 ) return true;
+  if( zVec3DIsTiny( &cache->axis ) ) return false;
+  zVec3DCopy( &cache->axis, proximity );
+  return true;
+}
+
+/* memorize GJK simplex to a cache. */
+static void _zGJKSimplexMemorize(zGJKSimplex *s, zVec3D *proximity, zGJKCache *cache)
+{
+  int i;
+
+  for( cache->n=0, i=0; i<4; i++ )
+    if( s->slot[i].sw_w ) zVec3DCopy( &s->slot[i].v, &cache->dir[cache->n++] );
+  zVec3DCopy( proximity, &cache->axis );
+}
+
+static bool _zGJK(zColSupport *sup1, zColSupport *sup2, zVec3D *c1, zVec3D *c2, zGJKSimplex *s, zGJKCache *cache)
 {
   zGJKSimplex _s; /* simplex */
   zGJKSlot slot;
   zVec3D proximity;
   double dv2norm = HUGE_VAL;
+  int i, iter = 0;
 
   if( s == NULL ) s = &_s;
-  zVec3DDataRewind( data1 );
-  zVec3DDataRewind( data2 );
-  zVec3DSub( zVec3DDataPeek( data1 ), zVec3DDataPeek( data2 ), &proximity );
   _zGJKSimplexInit( s );
-  do{
-    _zGJKSupportMap( &slot, data1, data2, &proximity );
+  if( !cache || !_zGJKSimplexSeed( s, sup1, sup2, cache, &proximity, &dv2norm ) ){
+    /* an arbitrary point in Minkowski difference as the initial proximity */
+    _zGJKSimplexInit( s );
+    dv2norm = HUGE_VAL;
+    if( !_zGJKSupportMap( &slot, sup1, sup2, ZVEC3DX ) ) return false;
+    zVec3DCopy( &slot.w, &proximity );
+  }
+  ZITERINIT( iter );
+  for( i=0; s->n<4; i++ ){
+    if( i >= iter ){ /* curved objects might not converge exactly */
+      ZITERWARN( iter );
+      break;
+    }
+    if( !_zGJKSupportMap( &slot, sup1, sup2, &proximity ) ) return false;
     if( _zGJKSimplexCheckDupSlot( s, &slot ) ||
         dv2norm - zVec3DInnerProd(&slot.w,&proximity) <= zTOL ){
       break; /* succeed */
@@ -462,24 +516,89 @@ static bool _zGJK(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2,
     _zGJKSimplexAddSlot( s, &slot );
     _zGJKSimplexClosest( s, &proximity );
     dv2norm = zVec3DSqrNorm( &proximity );
-  } while( s->n < 4 );
+  }
+  if( cache ) _zGJKSimplexMemorize( s, &proximity, cache );
   _zGJKPair( s, c1, c2 );
   return _zGJKCheck( s );
 }
 
+/* Gilbert-Johnson-Keerthi algorithm for convex objects given by support maps. */
+bool zGJKSupport(zColSupport *support1, zColSupport *support2, zVec3D *c1, zVec3D *c2)
+{
+  return _zGJK( support1, support2, c1, c2, NULL, NULL );
+}
+
+/* GJK algorithm followed by Johnson's penetration depth for convex objects given by support maps. */
+bool zGJKDepthSupport(zColSupport *support1, zColSupport *support2, zVec3D *c1, zVec3D *c2)
+{
+  zGJKSimplex s;
+
+  return _zGJK( support1, support2, c1, c2, &s, NULL ) ?
+    _zGJKPD( support1, support2, c1, c2, &s ) : false;
+}
+
 /* Gilbert-Johnson-Keerthi algorithm. */
 bool zGJK(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2)
 {
-  return _zGJK( data1, data2, c1, c2, NULL );
+  zColSupport sup1, sup2;
+
+  zColSupportAssignVec3DData( &sup1, data1 );
+  zColSupportAssignVec3DData( &sup2, data2 );
+  return zGJKSupport( &sup1, &sup2, c1, c2 );
 }
 
 /* GJK algorithm followed by Johnson's penetration depth */
 bool zGJKDepth(zVec3DData *data1, zVec3DData *data2, zVec3D *c1, zVec3D *c2)
 {
-  zGJKSimplex s;
+  zColSupport sup1, sup2;
+
+  zColSupportAssignVec3DData( &sup1, data1 );
+  zColSupportAssignVec3DData( &sup2, data2 );
+  return zGJKDepthSupport( &sup1, &sup2, c1, c2 );
+}
+
+/* initialize a cache of GJK algorithm. */
+zGJKCache *zGJKCacheInit(zGJKCache *cache)
+{
+  cache->n = 0;
+  zVec3DZero( &cache->axis );
+  return cache;
+}
+
+/* Gilbert-Johnson-Keerthi algorithm warm-started from a cache for convex objects given by support maps. */
+bool zGJKSupportWarmStart(zColSupport *support1, zColSupport *support2, zGJKCache *cache, zVec3D *c1, zVec3D *c2)
+{
+  return _zGJK( support1, support2, c1, c2, NULL, cache );
+}
+
+/* Gilbert-Johnson-Keerthi algorithm warm-started from a cache. */
+bool zGJKWarmStart(zVec3DData *data1, zVec3DData *data2, zGJKCache *cache, zVec3D *c1, zVec3D *c2)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignVec3DData( &sup1, data1 );
+  zColSupportAssignVec3DData( &sup2, data2 );
+  return zGJKSupportWarmStart( &sup1, &sup2, cache, c1, c2 );
+}
+
+/* Gilbert-Johnson-Keerthi algorithm for two 3D shapes. */
+bool zGJKShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2, zVec3D *c1, zVec3D *c2)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignShape3D( &sup1, shape1, frame1 );
+  zColSupportAssignShape3D( &sup2, shape2, frame2 );
+  return zGJKSupport( &sup1, &sup2, c1, c2 );
+}
+
+/* GJK algorithm followed by Johnson's penetration depth for two 3D shapes. */
+bool zGJKDepthShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2, zVec3D *c1, zVec3D *c2)
+{
+  zColSupport sup1, sup2;
 
-  return _zGJK( data1, data2, c1, c2, &s ) ?
-    _zGJKPD( data1, data2, c1, c2, &s ) : false;
+  zColSupportAssignShape3D( &sup1, shape1, frame1 );
+  zColSupportAssignShape3D( &sup2, shape2, frame2 );
+  return zGJKDepthSupport( &sup1, &sup2, c1, c2 );
 }
 
 /* support map of Minkowski difference. */
@@ -488,8 +607,8 @@ static zVec3D *_zGJKPointSupportMap(zGJKSlot *s, zVec3DData *data, zVec3D *v)
   zVec3D nv;
 
   zVec3DRev( v, &nv );
-  s->p1 = zVec3DDataSupportMap( data, &nv );
-  zVec3DSub( s->p1, s->p2, &s->w );
+  zVec3DCopy( zVec3DDataSupportMap( data, &nv ), &s->p1 );
+  zVec3DSub( &s->p1, &s->p2, &s->w );
   return &s->w;
 }
 
@@ -501,7 +620,7 @@ static void _zGJKPointClosest(zGJKSimplex *s, zVec3D *c)
   zVec3DZero( c );
   for( i=0; i<4; i++ )
     if( s->slot[i].sw_w )
-      zVec3DCatDRC( c, s->slot[i].s, s->slot[i].p1 );
+      zVec3DCatDRC( c, s->slot[i].s, &s->slot[i].p1 );
 }
 
 /* Gilbert-Johnson-Keerthi algorithm for a set of points and an independent point. */
@@ -512,7 +631,7 @@ bool zGJKPoint(zVec3DData *data, zVec3D *p, zVec3D *c)
   zVec3D proximity;
   double dv2norm = HUGE_VAL;
 
-  slot.p2 = p;
+  zVec3DCopy( p, &slot.p2 );
   zVec3DDataRewind( data );
   zVec3DSub( zVec3DDataPeek( data ), p, &proximity );
   _zGJKSimplexInit( &s );
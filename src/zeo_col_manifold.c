@@ -0,0 +1,337 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_manifold - collision checking: contact manifold.
+ */
+
+#include <zeo/zeo_col.h>
+
+#define _Z_COL_MANIFOLD_FEATURE_NUM ( ZEO_COL_MANIFOLD_SAMPLE_NUM + 1 )
+#define _Z_COL_MANIFOLD_CLIP_NUM    ( _Z_COL_MANIFOLD_FEATURE_NUM * 2 )
+
+/* initialize a contact manifold. */
+zColManifold *zColManifoldInit(zColManifold *manifold)
+{
+  zVec3DZero( &manifold->normal );
+  manifold->num = 0;
+  return manifold;
+}
+
+/* remove duplicate points in a plane, keeping the highest one. */
+static int _zColManifoldUnique(zVec3D q[], int num)
+{
+  int i, j, n = 0;
+
+  for( i=0; i<num; i++ ){
+    for( j=0; j<n; j++ )
+      if( zIsTiny( q[j].c.x - q[i].c.x ) && zIsTiny( q[j].c.y - q[i].c.y ) ) break;
+    if( j == n )
+      zVec3DCopy( &q[i], &q[n++] );
+    else
+    if( q[i].c.z > q[j].c.z ) q[j].c.z = q[i].c.z;
+  }
+  return n;
+}
+
+/* contact feature of a convex object in a direction, projected onto a plane spanned by u and w.
+ * the z-component of each point is its height along the direction. */
+static int _zColManifoldFeature(const zColSupport *support, const zVec3D *n, const zVec3D *u, const zVec3D *w, zVec3D q[])
+{
+  zVec3D sp[_Z_COL_MANIFOLD_FEATURE_NUM], d, center;
+  double theta, c, s, h, hi, size = 0;
+  int i, num = 0;
+
+  h = -HUGE_VAL;
+  if( !zColSupportCenter( support, &center ) ) return 0;
+  for( i=0; i<_Z_COL_MANIFOLD_FEATURE_NUM; i++ ){
+    if( i == 0 )
+      zVec3DCopy( n, &d );
+    else{
+      theta = zPIx2 * ( i - 1 ) / ZEO_COL_MANIFOLD_SAMPLE_NUM;
+      c = ZEO_COL_MANIFOLD_SAMPLE_TILT * cos( theta );
+      s = ZEO_COL_MANIFOLD_SAMPLE_TILT * sin( theta );
+      zVec3DCat( n, c, u, &d );
+      zVec3DCatDRC( &d, s, w );
+    }
+    if( !zColSupportMap( support, &d, &sp[i] ) ) return 0;
+    if( ( hi = zVec3DInnerProd( &sp[i], n ) ) > h ) h = hi;
+    if( ( hi = zVec3DDist( &sp[i], &center ) ) > size ) size = hi;
+  }
+  for( i=0; i<_Z_COL_MANIFOLD_FEATURE_NUM; i++ ){
+    if( ( hi = zVec3DInnerProd( &sp[i], n ) ) < h - ZEO_COL_MANIFOLD_FEATURE_TOL * size ) continue;
+    zVec3DCreate( &q[num++], zVec3DInnerProd( &sp[i], u ), zVec3DInnerProd( &sp[i], w ), hi );
+  }
+  return _zColManifoldUnique( q, num );
+}
+
+/* signed area of a triangle in a plane. */
+static double _zColManifoldArea(const zVec3D *a, const zVec3D *b, const zVec3D *c)
+{
+  return ( b->c.x - a->c.x ) * ( c->c.y - a->c.y ) - ( b->c.y - a->c.y ) * ( c->c.x - a->c.x );
+}
+
+/* height of a point on the plane of a polygonal feature. */
+static double _zColManifoldHeight(const zVec3D feature[], int num, const zVec3D *q)
+{
+  zVec3D e1, e2, m;
+
+  if( num < 3 ) return feature[0].c.z;
+  zVec3DSub( &feature[1], &feature[0], &e1 );
+  zVec3DSub( &feature[2], &feature[0], &e2 );
+  zVec3DOuterProd( &e1, &e2, &m );
+  if( zIsTiny( m.c.z ) ) return feature[0].c.z;
+  return feature[0].c.z - ( m.c.x * ( q->c.x - feature[0].c.x ) + m.c.y * ( q->c.y - feature[0].c.y ) ) / m.c.z;
+}
+
+/* convex hull of a small set of points in a plane (monotone chain, counterclockwise). */
+static int _zColManifoldHull(zVec3D q[], int num)
+{
+  zVec3D tmp, hull[_Z_COL_MANIFOLD_FEATURE_NUM*2];
+  int i, j, k = 0, l;
+
+  for( i=1; i<num; i++ ) /* insertion sort in lexicographic order */
+    for( j=i; j>0 && ( q[j].c.x < q[j-1].c.x || ( q[j].c.x == q[j-1].c.x && q[j].c.y < q[j-1].c.y ) ); j-- ){
+      zVec3DCopy( &q[j], &tmp );
+      zVec3DCopy( &q[j-1], &q[j] );
+      zVec3DCopy( &tmp, &q[j-1] );
+    }
+  if( num < 3 ) return num;
+  for( i=0; i<num; i++ ){ /* lower hull */
+    while( k >= 2 && _zColManifoldArea( &hull[k-2], &hull[k-1], &q[i] ) <= zTOL ) k--;
+    zVec3DCopy( &q[i], &hull[k++] );
+  }
+  for( l=k+1, i=num-2; i>=0; i-- ){ /* upper hull */
+    while( k >= l && _zColManifoldArea( &hull[k-2], &hull[k-1], &q[i] ) <= zTOL ) k--;
+    zVec3DCopy( &q[i], &hull[k++] );
+  }
+  for( i=0; i<k-1; i++ ) zVec3DCopy( &hull[i], &q[i] );
+  return k - 1;
+}
+
+/* clip a polygon by a convex polygon (Sutherland-Hodgman algorithm).
+ * heights of the clipped polygon are linearly interpolated. */
+static int _zColManifoldClip(const zVec3D clipper[], int cnum, zVec3D q[], int num)
+{
+  zVec3D in[_Z_COL_MANIFOLD_CLIP_NUM];
+  const zVec3D *a, *b, *s, *e;
+  double ds, de;
+  int i, j, n;
+
+  for( i=0; i<cnum && num>0; i++ ){
+    a = &clipper[i];
+    b = &clipper[(i+1)%cnum];
+    for( j=0; j<num; j++ ) zVec3DCopy( &q[j], &in[j] );
+    n = num;
+    for( num=0, j=0; j<n; j++ ){
+      s = &in[(j+n-1)%n];
+      e = &in[j];
+      ds = _zColManifoldArea( a, b, s );
+      de = _zColManifoldArea( a, b, e );
+      if( de >= -zTOL ){
+        if( ds < -zTOL && num < _Z_COL_MANIFOLD_CLIP_NUM )
+          zVec3DInterDiv( s, e, ds/(ds-de), &q[num++] );
+        if( num < _Z_COL_MANIFOLD_CLIP_NUM ) zVec3DCopy( e, &q[num++] );
+      } else
+      if( ds >= -zTOL && num < _Z_COL_MANIFOLD_CLIP_NUM )
+        zVec3DInterDiv( s, e, ds/(ds-de), &q[num++] );
+    }
+  }
+  return num;
+}
+
+/* reduce contact points to the deepest one and those spanning the largest area. */
+static int _zColManifoldReduce(zColContact contact[], int num, const zVec3D *n)
+{
+  zColContact tmp;
+  zVec3D e1, e2, e3, v;
+  double val, val_max;
+  int i, k, i_max;
+
+  for( k=0; k<ZEO_COL_MANIFOLD_NUM && k<num; k++ ){
+    for( i_max=k, val_max=-HUGE_VAL, i=k; i<num; i++ ){
+      switch( k ){
+      case 0: /* deepest point */
+        val = contact[i].depth; break;
+      case 1: /* farthest point from the first */
+        val = zVec3DSqrDist( &contact[i].pos, &contact[0].pos ); break;
+      case 2: /* largest triangle */
+        zVec3DSub( &contact[1].pos, &contact[0].pos, &e1 );
+        zVec3DSub( &contact[i].pos, &contact[0].pos, &e2 );
+        zVec3DOuterProd( &e1, &e2, &v );
+        val = fabs( zVec3DInnerProd( &v, n ) ); break;
+      default: /* largest quadrilateral */
+        zVec3DSub( &contact[0].pos, &contact[i].pos, &e1 );
+        zVec3DSub( &contact[1].pos, &contact[i].pos, &e2 );
+        zVec3DSub( &contact[2].pos, &contact[i].pos, &e3 );
+        zVec3DOuterProd( &e1, &e2, &v );
+        val = fabs( zVec3DInnerProd( &v, n ) );
+        zVec3DOuterProd( &e2, &e3, &v );
+        val += fabs( zVec3DInnerProd( &v, n ) );
+        zVec3DOuterProd( &e3, &e1, &v );
+        val += fabs( zVec3DInnerProd( &v, n ) );
+      }
+      if( val > val_max ){
+        val_max = val;
+        i_max = i;
+      }
+    }
+    if( i_max != k ){
+      zCopy( zColContact, &contact[k], &tmp );
+      zCopy( zColContact, &contact[i_max], &contact[k] );
+      zCopy( zColContact, &tmp, &contact[i_max] );
+    }
+  }
+  return k;
+}
+
+/* set a contact point from points on two objects in the world frame. */
+static void _zColManifoldSetContact(zColContact *contact, const zColSupport *support1, const zColSupport *support2, const zVec3D *w1, const zVec3D *w2, const zVec3D *n)
+{
+  zVec3D d;
+
+  zVec3DMid( w1, w2, &contact->pos );
+  zVec3DSub( w1, w2, &d );
+  contact->depth = zVec3DInnerProd( &d, n );
+  if( support1->frame )
+    zXform3DInv( support1->frame, w1, &contact->p1 );
+  else
+    zVec3DCopy( w1, &contact->p1 );
+  if( support2->frame )
+    zXform3DInv( support2->frame, w2, &contact->p2 );
+  else
+    zVec3DCopy( w2, &contact->p2 );
+  zVec3DZero( &contact->impulse );
+  contact->lifetime = 0;
+}
+
+/* move a persistent contact point with objects, and check if it is still valid. */
+static bool _zColManifoldRefresh(zColContact *contact, const zColSupport *support1, const zColSupport *support2, const zVec3D *n)
+{
+  zVec3D w1, w2, d;
+
+  if( support1->frame )
+    zXform3D( support1->frame, &contact->p1, &w1 );
+  else
+    zVec3DCopy( &contact->p1, &w1 );
+  if( support2->frame )
+    zXform3D( support2->frame, &contact->p2, &w2 );
+  else
+    zVec3DCopy( &contact->p2, &w2 );
+  zVec3DSub( &w1, &w2, &d );
+  if( ( contact->depth = zVec3DInnerProd( &d, n ) ) < -ZEO_COL_MANIFOLD_BREAK_TOL ) return false;
+  zVec3DCatDRC( &d, -contact->depth, n );
+  if( zVec3DNorm( &d ) > ZEO_COL_MANIFOLD_BREAK_TOL ) return false;
+  zVec3DMid( &w1, &w2, &contact->pos );
+  return true;
+}
+
+/* inherit accumulated impulses and lifetimes of contact points at the previous step. */
+static void _zColManifoldInherit(zColContact contact[], int num, const zColManifold *prev)
+{
+  double d, d_min;
+  int i, j, j_min;
+
+  for( i=0; i<num; i++ ){
+    for( j_min=-1, d_min=ZEO_COL_MANIFOLD_BREAK_TOL, j=0; j<prev->num; j++ )
+      if( ( d = zVec3DDist( &contact[i].pos, &prev->contact[j].pos ) ) < d_min ){
+        d_min = d;
+        j_min = j;
+      }
+    if( j_min < 0 ) continue;
+    zVec3DCopy( &prev->contact[j_min].impulse, &contact[i].impulse );
+    contact[i].lifetime = prev->contact[j_min].lifetime + 1;
+  }
+}
+
+/* contact manifold of two convex objects given by support maps. */
+bool zColManifoldSupport(zColSupport *support1, zColSupport *support2, zColManifold *manifold)
+{
+  zColContact contact[_Z_COL_MANIFOLD_CLIP_NUM+ZEO_COL_MANIFOLD_NUM];
+  zVec3D q1[_Z_COL_MANIFOLD_CLIP_NUM], q2[_Z_COL_MANIFOLD_CLIP_NUM], *q;
+  zVec3D n, rn, u, w, pos, w1, w2;
+  double depth, h1, h2;
+  int i, num, num1, num2;
+
+  if( !zMPRDepthSupport( support1, support2, &depth, &pos, &n ) ){
+    zColManifoldInit( manifold );
+    return false;
+  }
+  if( zVec3DIsTiny( &n ) ){ /* touching at a point */
+    if( !zColSupportCenter( support1, &w1 ) || !zColSupportCenter( support2, &w2 ) )
+      zVec3DZero( &n );
+    else
+      zVec3DSub( &w2, &w1, &n );
+    if( !zVec3DNormalizeDRC( &n ) ) zVec3DCopy( ZVEC3DZ, &n );
+  }
+  zVec3DOrthoSpace( &n, &u, &w );
+  zVec3DRev( &n, &rn );
+  num1 = _zColManifoldFeature( support1, &n, &u, &w, q1 );
+  num2 = _zColManifoldFeature( support2, &rn, &u, &w, q2 );
+  num1 = _zColManifoldHull( q1, num1 );
+  num2 = _zColManifoldHull( q2, num2 );
+  if( num1 >= 3 ){ /* clip the feature of the second object by that of the first */
+    num = _zColManifoldClip( q1, num1, q2, num2 );
+    q = q2;
+  } else
+  if( num2 >= 3 ){ /* clip the feature of the first object by that of the second */
+    num = _zColManifoldClip( q2, num2, q1, num1 );
+    q = q1;
+  } else{ /* edge-edge, edge-vertex or vertex-vertex contact */
+    num = 0;
+    q = NULL;
+  }
+  if( ( num = _zColManifoldUnique( q, num ) ) > 0 ){
+    for( i=0; i<num; i++ ){ /* depth of each point against the reference feature */
+      if( q == q2 ){
+        h1 = _zColManifoldHeight( q1, num1, &q[i] );
+        h2 =-q[i].c.z;
+      } else{
+        h1 = q[i].c.z;
+        h2 =-_zColManifoldHeight( q2, num2, &q[i] );
+      }
+      zVec3DMul( &n, h1, &w1 );
+      zVec3DCatDRC( &w1, q[i].c.x, &u );
+      zVec3DCatDRC( &w1, q[i].c.y, &w );
+      zVec3DCat( &w1, h2-h1, &n, &w2 );
+      _zColManifoldSetContact( &contact[i], support1, support2, &w1, &w2, &n );
+    }
+  } else{ /* a single contact point */
+    zVec3DCat( &pos, 0.5*depth, &n, &w1 );
+    zVec3DCat( &pos,-0.5*depth, &n, &w2 );
+    _zColManifoldSetContact( &contact[0], support1, support2, &w1, &w2, &n );
+    num = 1;
+  }
+  if( num == 1 ){ /* keep persistent points of the previous step */
+    for( i=0; i<manifold->num; i++ ){
+      if( zVec3DDist( &manifold->contact[i].pos, &contact[0].pos ) < ZEO_COL_MANIFOLD_BREAK_TOL ) continue;
+      zCopy( zColContact, &manifold->contact[i], &contact[num] );
+      if( _zColManifoldRefresh( &contact[num], support1, support2, &n ) ) num++;
+    }
+  }
+  _zColManifoldInherit( contact, num, manifold );
+  num = _zColManifoldReduce( contact, num, &n );
+  zVec3DCopy( &n, &manifold->normal );
+  memcpy( manifold->contact, contact, sizeof(zColContact)*num );
+  manifold->num = num;
+  return true;
+}
+
+/* contact manifold of two convex polyhedra. */
+bool zColManifoldPH3D(const zPH3D *ph1, const zFrame3D *frame1, const zPH3D *ph2, const zFrame3D *frame2, zColManifold *manifold)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignPH3D( &sup1, ph1, frame1 );
+  zColSupportAssignPH3D( &sup2, ph2, frame2 );
+  return zColManifoldSupport( &sup1, &sup2, manifold );
+}
+
+/* contact manifold of two 3D shapes. */
+bool zColManifoldShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2, zColManifold *manifold)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignShape3D( &sup1, shape1, frame1 );
+  zColSupportAssignShape3D( &sup2, shape2, frame2 );
+  return zColManifoldSupport( &sup1, &sup2, manifold );
+}
@@ -20,22 +20,22 @@ typedef struct{
 } zMPRSimplex;
 
 /* support map of Minkowski difference. */
-static zVec3D *_zMPRSupportMap(zMPRSlot *s, zVec3DData *data1, zVec3DData *data2, zVec3D *v)
+static zVec3D *_zMPRSupportMap(zMPRSlot *s, zColSupport *sup1, zColSupport *sup2, zVec3D *v)
 {
   zVec3D nv;
 
   _zVec3DRev( v, &nv );
-  zVec3DCopy( zVec3DDataSupportMap( data1,   v ), &s->v1 );
-  zVec3DCopy( zVec3DDataSupportMap( data2, &nv ), &s->v2 );
+  if( !zColSupportMap( sup1,   v, &s->v1 ) ||
+      !zColSupportMap( sup2, &nv, &s->v2 ) ) return NULL;
   _zVec3DSub( &s->v1, &s->v2, &s->v );
   return &s->v;
 }
 
-/* original Minkowski portal of sets of points. */
-static zVec3D *_zMPROrigin(zMPRSlot *center, zVec3DData *data1, zVec3DData *data2)
+/* original Minkowski portal of convex objects. */
+static zVec3D *_zMPROrigin(zMPRSlot *center, zColSupport *sup1, zColSupport *sup2)
 {
-  zVec3DDataBarycenter( data1, &center->v1 );
-  zVec3DDataBarycenter( data2, &center->v2 );
+  if( !zColSupportCenter( sup1, &center->v1 ) ||
+      !zColSupportCenter( sup2, &center->v2 ) ) return NULL;
   _zVec3DSub( &center->v1, &center->v2, &center->v );
   return &center->v;
 }
@@ -54,16 +54,17 @@ static zVec3D *_zMPRSimplexDir(zMPRSimplex *s, int i0, int i1, int i2, zVec3D *d
 
 #define Z_MPR_BIAS ( zTOL * 10 )
 
-enum{ Z_MPR_PORTAL_OUTSIDE = -1, Z_MPR_PORTAL_TO_REFINE = 0, Z_MPR_PORTAL_AT_POINT = 1, Z_MPR_PORTAL_ON_SEG = 2 };
+enum{ Z_MPR_PORTAL_FAILURE = -2, Z_MPR_PORTAL_OUTSIDE = -1, Z_MPR_PORTAL_TO_REFINE = 0, Z_MPR_PORTAL_AT_POINT = 1, Z_MPR_PORTAL_ON_SEG = 2 };
 
 /* find Minkowski portal. */
-static int _zMPRFindPortal(zMPRSimplex *portal, zVec3DData *data1, zVec3DData *data2)
+static int _zMPRFindPortal(zMPRSimplex *portal, zColSupport *sup1, zColSupport *sup2)
 {
   zVec3D dir;
   zMPRSlot tmp;
+  int i, iter = 0;
 
   /* vertex 0: the center of portal */
-  _zMPROrigin( &portal->slot[0], data1, data2 );
+  if( !_zMPROrigin( &portal->slot[0], sup1, sup2 ) ) return Z_MPR_PORTAL_FAILURE;
   portal->n = 1;
   if( zVec3DIsTiny( &portal->slot[0].v ) )
     /* intersecting case: the center is slightly biased in order to compute penetration depth. */
@@ -71,7 +72,7 @@ static int _zMPRFindPortal(zMPRSimplex *portal, zVec3DData *data1, zVec3DData *d
 
   /* vertex 1 = support in direction to origin */
   zVec3DNormalizeNCDRC( zVec3DRev( &portal->slot[0].v, &dir ) );
-  _zMPRSupportMap( &portal->slot[1], data1, data2, &dir );
+  if( !_zMPRSupportMap( &portal->slot[1], sup1, sup2, &dir ) ) return Z_MPR_PORTAL_FAILURE;
   portal->n = 2;
   if( zVec3DInnerProd( &portal->slot[1].v, &dir ) < zTOL ) return Z_MPR_PORTAL_OUTSIDE;
 
@@ -80,7 +81,7 @@ static int _zMPRFindPortal(zMPRSimplex *portal, zVec3DData *data1, zVec3DData *d
   if( zVec3DIsTiny( &dir ) ) /* origin lies at vertex 1 or between vertices 0 and 1. */
     return zVec3DIsTiny( &portal->slot[1].v ) ? Z_MPR_PORTAL_AT_POINT : Z_MPR_PORTAL_ON_SEG;
   zVec3DNormalizeNCDRC( &dir );
-  _zMPRSupportMap( &portal->slot[2], data1, data2, &dir );
+  if( !_zMPRSupportMap( &portal->slot[2], sup1, sup2, &dir ) ) return Z_MPR_PORTAL_FAILURE;
   portal->n = 3;
   if( zVec3DInnerProd( &portal->slot[2].v, &dir ) < zTOL ) return Z_MPR_PORTAL_OUTSIDE;
 
@@ -93,8 +94,13 @@ static int _zMPRFindPortal(zMPRSimplex *portal, zVec3DData *data1, zVec3DData *d
     _zMPRSlotCopy( &tmp, &portal->slot[2] );
     _zVec3DRevDRC( &dir );
   }
-  while( 1 ){
-    _zMPRSupportMap( &portal->slot[3], data1, data2, &dir );
+  ZITERINIT( iter );
+  for( i=0; ; i++ ){
+    if( i >= iter ){
+      ZITERWARN( iter );
+      return Z_MPR_PORTAL_FAILURE;
+    }
+    if( !_zMPRSupportMap( &portal->slot[3], sup1, sup2, &dir ) ) return Z_MPR_PORTAL_FAILURE;
     if( zVec3DInnerProd( &portal->slot[3].v, &dir ) < zTOL ) return Z_MPR_PORTAL_OUTSIDE;
     /* test if origin is outside of (v1, v0, v3) - set v3 for v2 and continue */
     if( zVec3DGrassmannProd( &portal->slot[0].v, &portal->slot[1].v, &portal->slot[3].v ) <= -zTOL ){
@@ -145,23 +151,26 @@ static zMPRSlot *_zMPRExpandPortal(zMPRSimplex* portal, zMPRSlot *s)
 }
 
 /* refine Minkowski portal. */
-static bool _zMPRRefinePortal(zMPRSimplex* portal, zVec3DData *data1, zVec3DData *data2)
+static bool _zMPRRefinePortal(zMPRSimplex* portal, zColSupport *sup1, zColSupport *sup2)
 {
   zVec3D dir;
   zMPRSlot s;
+  int i, iter = 0;
 
-  while( 1 ){
+  ZITERINIT( iter );
+  for( i=0; i<iter; i++ ){
     /* compute outward direction of portal */
     _zMPRPortalDir( portal, &dir );
     /* test if origin is inside of portal */
     if( zVec3DInnerProd( &portal->slot[1].v, &dir ) > -zTOL ) return true;
     /* next support point */
-    _zMPRSupportMap( &s, data1, data2, &dir );
+    if( !_zMPRSupportMap( &s, sup1, sup2, &dir ) ) return false;
     /* test if portal can be expanded toward origin. */
     if( zVec3DInnerProd( &s.v, &dir ) <= -zTOL ||
         _zMPRPortalIsReached( portal, &s, &dir ) ) return false;
     _zMPRExpandPortal( portal, &s );
   }
+  ZITERWARN( iter );
   return false;
 }
 
@@ -262,7 +271,7 @@ static double _zMPRCalcDepth(zVec3D *p0, zVec3D *p1, zVec3D *p2, zVec3D *dir)
 }
 
 /* calculate penetration depth of colliding objects based on MPR algorithm. */
-static bool _zMPRDepth(zMPRSimplex* portal, zVec3DData *data1, zVec3DData *data2, double *depth, zVec3D *pos, zVec3D *dir)
+static bool _zMPRDepth(zMPRSimplex* portal, zColSupport *sup1, zColSupport *sup2, double *depth, zVec3D *pos, zVec3D *dir)
 {
   zVec3D d;
   zMPRSlot s;
@@ -272,7 +281,7 @@ static bool _zMPRDepth(zMPRSimplex* portal, zVec3DData *data1, zVec3DData *data2
   for( i=0; i<iter; i++ ){
     /* compute portal direction and obtain next support point */
     _zMPRPortalDir( portal, &d );
-    _zMPRSupportMap( &s, data1, data2, &d );
+    if( !_zMPRSupportMap( &s, sup1, sup2, &d ) ) return false;
     /* reached tolerance -> find penetration info */
     if( _zMPRPortalIsReached( portal, &s, &d ) ){
       if( depth && dir ){
@@ -288,26 +297,27 @@ static bool _zMPRDepth(zMPRSimplex* portal, zVec3DData *data1, zVec3DData *data2
   return false;
 }
 
-/* Minkowski Portal Refinement algorithm. */
-bool zMPR(zVec3DData *data1, zVec3DData *data2)
+/* Minkowski Portal Refinement algorithm for convex objects given by support maps. */
+bool zMPRSupport(zColSupport *sup1, zColSupport *sup2)
 {
   zMPRSimplex portal;
 
-  switch( _zMPRFindPortal( &portal, data1, data2 ) ){
+  switch( _zMPRFindPortal( &portal, sup1, sup2 ) ){
+  case Z_MPR_PORTAL_FAILURE:
   case Z_MPR_PORTAL_OUTSIDE:   return false;
-  case Z_MPR_PORTAL_TO_REFINE: return _zMPRRefinePortal( &portal, data1, data2 );
+  case Z_MPR_PORTAL_TO_REFINE: return _zMPRRefinePortal( &portal, sup1, sup2 );
   default: ;
   }
   return true;
 }
 
-/* Minkowski Portal Refinement algorithm with penetration depth */
-bool zMPRDepth(zVec3DData *data1, zVec3DData *data2, double *depth, zVec3D *pos, zVec3D *dir)
+/* Minkowski Portal Refinement algorithm with penetration depth for convex objects given by support maps. */
+bool zMPRDepthSupport(zColSupport *sup1, zColSupport *sup2, double *depth, zVec3D *pos, zVec3D *dir)
 {
   zMPRSimplex portal;
 
   /* Phase 1: find portal */
-  switch( _zMPRFindPortal( &portal, data1, data2 ) ){
+  switch( _zMPRFindPortal( &portal, sup1, sup2 ) ){
   case Z_MPR_PORTAL_AT_POINT: /* contact at a point. */
     *depth = 0;
     _zVec3DZero( dir );
@@ -318,12 +328,52 @@ bool zMPRDepth(zVec3DData *data1, zVec3DData *data2, double *depth, zVec3D *pos,
     zVec3DMid( &portal.slot[1].v1, &portal.slot[1].v2, pos );
     break;
   case Z_MPR_PORTAL_TO_REFINE: /* Phase 2: refine portal */
-    if( _zMPRRefinePortal( &portal, data1, data2 ) ){
+    if( _zMPRRefinePortal( &portal, sup1, sup2 ) ){
       /* compute penetration depth */
-      return _zMPRDepth( &portal, data1, data2, depth, pos, dir );
+      return _zMPRDepth( &portal, sup1, sup2, depth, pos, dir );
     }
   default: /* no collision */
     return false;
   }
   return true;
 }
+
+/* Minkowski Portal Refinement algorithm. */
+bool zMPR(zVec3DData *data1, zVec3DData *data2)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignVec3DData( &sup1, data1 );
+  zColSupportAssignVec3DData( &sup2, data2 );
+  return zMPRSupport( &sup1, &sup2 );
+}
+
+/* Minkowski Portal Refinement algorithm with penetration depth */
+bool zMPRDepth(zVec3DData *data1, zVec3DData *data2, double *depth, zVec3D *pos, zVec3D *dir)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignVec3DData( &sup1, data1 );
+  zColSupportAssignVec3DData( &sup2, data2 );
+  return zMPRDepthSupport( &sup1, &sup2, depth, pos, dir );
+}
+
+/* Minkowski Portal Refinement algorithm for two 3D shapes. */
+bool zMPRShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignShape3D( &sup1, shape1, frame1 );
+  zColSupportAssignShape3D( &sup2, shape2, frame2 );
+  return zMPRSupport( &sup1, &sup2 );
+}
+
+/* Minkowski Portal Refinement algorithm with penetration depth for two 3D shapes. */
+bool zMPRDepthShape3D(const zShape3D *shape1, const zFrame3D *frame1, const zShape3D *shape2, const zFrame3D *frame2, double *depth, zVec3D *pos, zVec3D *dir)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignShape3D( &sup1, shape1, frame1 );
+  zColSupportAssignShape3D( &sup2, shape2, frame2 );
+  return zMPRDepthSupport( &sup1, &sup2, depth, pos, dir );
+}
@@ -0,0 +1,209 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_shape - collision checking: pairwise kernels of 3D shapes.
+ */
+
+#include <zeo/zeo_col.h>
+
+/* closest points of two balls. */
+static bool _zColBall3D(const zVec3D *center1, double r1, const zVec3D *center2, double r2, zVec3D *p1, zVec3D *p2)
+{
+  zVec3D n;
+  double d;
+
+  zVec3DSub( center2, center1, &n );
+  if( zIsTiny( ( d = zVec3DNorm( &n ) ) ) )
+    zVec3DCopy( ZVEC3DX, &n ); /* concentric balls */
+  else
+    zVec3DDivDRC( &n, d );
+  if( d > r1 + r2 ){
+    zVec3DCat( center1, r1, &n, p1 );
+    zVec3DCat( center2,-r2, &n, p2 );
+    return false;
+  }
+  /* middle of the overlap of the balls on the line of centers, inside of both
+     even if one contains the other */
+  zVec3DCat( center1, 0.5 * ( _zMax( -r1, d - r2 ) + _zMin( r1, d + r2 ) ), &n, p1 );
+  zVec3DCopy( p1, p2 );
+  return true;
+}
+
+/* closest point on a line segment to a point. */
+static zVec3D *_zColSegClosest(const zVec3D *e1, const zVec3D *e2, const zVec3D *p, zVec3D *cp)
+{
+  zVec3D d, v;
+  double l;
+
+  zVec3DSub( e2, e1, &d );
+  zVec3DSub( p, e1, &v );
+  if( zIsTiny( ( l = zVec3DSqrNorm( &d ) ) ) ) return zVec3DCopy( e1, cp );
+  return zVec3DCat( e1, _zLimit( zVec3DInnerProd( &d, &v ) / l, 0, 1 ), &d, cp );
+}
+
+/* closest points of two line segments. */
+static void _zColSegSegClosest(const zVec3D *e11, const zVec3D *e12, const zVec3D *e21, const zVec3D *e22, zVec3D *cp1, zVec3D *cp2)
+{
+  zVec3D d1, d2, r;
+  double a, b, c, e, f, den, s, t;
+
+  zVec3DSub( e12, e11, &d1 );
+  zVec3DSub( e22, e21, &d2 );
+  zVec3DSub( e11, e21, &r );
+  a = zVec3DSqrNorm( &d1 );
+  e = zVec3DSqrNorm( &d2 );
+  f = zVec3DInnerProd( &d2, &r );
+  if( zIsTiny( a ) ){
+    s = 0;
+    t = zIsTiny( e ) ? 0 : _zLimit( f / e, 0, 1 );
+  } else{
+    c = zVec3DInnerProd( &d1, &r );
+    if( zIsTiny( e ) ){
+      t = 0;
+      s = _zLimit( -c / a, 0, 1 );
+    } else{
+      b = zVec3DInnerProd( &d1, &d2 );
+      s = zIsTiny( ( den = a*e - b*b ) ) ? 0 : _zLimit( ( b*f - c*e ) / den, 0, 1 );
+      if( ( t = ( b*s + f ) / e ) < 0 ){
+        t = 0;
+        s = _zLimit( -c / a, 0, 1 );
+      } else
+      if( t > 1 ){
+        t = 1;
+        s = _zLimit( ( b - c ) / a, 0, 1 );
+      }
+    }
+  }
+  zVec3DCat( e11, s, &d1, cp1 );
+  zVec3DCat( e21, t, &d2, cp2 );
+}
+
+/* closest points of two 3D spheres. */
+bool zColSphere3D(const zSphere3D *s1, const zSphere3D *s2, zVec3D *p1, zVec3D *p2)
+{
+  return _zColBall3D( zSphere3DCenter(s1), zSphere3DRadius(s1), zSphere3DCenter(s2), zSphere3DRadius(s2), p1, p2 );
+}
+
+/* closest points of a 3D sphere and a 3D capsule. */
+bool zColSphereCapsule3D(const zSphere3D *sphere, const zCapsule3D *capsule, zVec3D *p1, zVec3D *p2)
+{
+  zVec3D cp;
+
+  _zColSegClosest( zCapsule3DCenter(capsule,0), zCapsule3DCenter(capsule,1), zSphere3DCenter(sphere), &cp );
+  return _zColBall3D( zSphere3DCenter(sphere), zSphere3DRadius(sphere), &cp, zCapsule3DRadius(capsule), p1, p2 );
+}
+
+/* closest points of two 3D capsules. */
+bool zColCapsule3D(const zCapsule3D *c1, const zCapsule3D *c2, zVec3D *p1, zVec3D *p2)
+{
+  zVec3D cp1, cp2;
+
+  _zColSegSegClosest( zCapsule3DCenter(c1,0), zCapsule3DCenter(c1,1), zCapsule3DCenter(c2,0), zCapsule3DCenter(c2,1), &cp1, &cp2 );
+  return _zColBall3D( &cp1, zCapsule3DRadius(c1), &cp2, zCapsule3DRadius(c2), p1, p2 );
+}
+
+/* closest points of a 3D sphere and a 3D box. */
+bool zColSphereBox3D(const zSphere3D *sphere, const zBox3D *box, zVec3D *p1, zVec3D *p2)
+{
+  zVec3D cp;
+  double d;
+
+  if( ( d = zBox3DClosest( box, zSphere3DCenter(sphere), &cp ) ) <= zTOL ){ /* center inside of the box */
+    zVec3DCopy( zSphere3DCenter(sphere), p1 );
+    zVec3DCopy( p1, p2 );
+    return true;
+  }
+  zVec3DCopy( &cp, p2 );
+  if( d <= zSphere3DRadius(sphere) ){
+    zVec3DCopy( &cp, p1 );
+    return true;
+  }
+  zVec3DSub( &cp, zSphere3DCenter(sphere), p1 );
+  zVec3DMulDRC( p1, zSphere3DRadius(sphere) / d );
+  zVec3DAddDRC( p1, zSphere3DCenter(sphere) );
+  return false;
+}
+
+/* kernel of a sphere-sphere pair. */
+static bool _zColShape3DSphereSphere(const zShape3D *s1, const zShape3D *s2, zVec3D *c1, zVec3D *c2)
+{
+  return zColSphere3D( zShape3DSphere(s1), zShape3DSphere(s2), c1, c2 );
+}
+
+/* kernel of a sphere-capsule pair. */
+static bool _zColShape3DSphereCapsule(const zShape3D *s1, const zShape3D *s2, zVec3D *c1, zVec3D *c2)
+{
+  return zColSphereCapsule3D( zShape3DSphere(s1), zShape3DCapsule(s2), c1, c2 );
+}
+
+/* kernel of a capsule-capsule pair. */
+static bool _zColShape3DCapsuleCapsule(const zShape3D *s1, const zShape3D *s2, zVec3D *c1, zVec3D *c2)
+{
+  return zColCapsule3D( zShape3DCapsule(s1), zShape3DCapsule(s2), c1, c2 );
+}
+
+/* kernel of a sphere-box pair. */
+static bool _zColShape3DSphereBox(const zShape3D *s1, const zShape3D *s2, zVec3D *c1, zVec3D *c2)
+{
+  return zColSphereBox3D( zShape3DSphere(s1), zShape3DBox(s2), c1, c2 );
+}
+
+/* kernel of a general pair. */
+static bool _zColShape3DGJK(const zShape3D *s1, const zShape3D *s2, zVec3D *c1, zVec3D *c2)
+{
+  return zGJKShape3D( s1, NULL, s2, NULL, c1, c2 );
+}
+
+/* check kernel of a box-box pair by the separating axis test. */
+static bool _zColChkShape3DBoxBox(const zShape3D *s1, const zShape3D *s2)
+{
+  return zColChkBox3D( zShape3DBox(s1), zShape3DBox(s2) );
+}
+
+/* dispatch table of kernels indexed by pairs of types of 3D shapes.
+ * _chk is used for a mere check if it is given, and _col is used otherwise. */
+static const struct{
+  const zShape3DCom *com1, *com2;
+  bool (* _col)(const zShape3D*, const zShape3D*, zVec3D*, zVec3D*);
+  bool (* _chk)(const zShape3D*, const zShape3D*);
+} _zeo_col_shape3d_kernel[] = {
+  { &zeo_shape3d_sphere_com,  &zeo_shape3d_sphere_com,  _zColShape3DSphereSphere,   NULL },
+  { &zeo_shape3d_sphere_com,  &zeo_shape3d_capsule_com, _zColShape3DSphereCapsule,  NULL },
+  { &zeo_shape3d_capsule_com, &zeo_shape3d_capsule_com, _zColShape3DCapsuleCapsule, NULL },
+  { &zeo_shape3d_sphere_com,  &zeo_shape3d_box_com,     _zColShape3DSphereBox,      NULL },
+  { &zeo_shape3d_box_com,     &zeo_shape3d_box_com,     _zColShape3DGJK,            _zColChkShape3DBoxBox },
+  { NULL, NULL, NULL, NULL },
+};
+
+/* collision checking of two 3D shapes dispatched by types (c1 and c2 can be null). */
+static bool _zColShape3DDispatch(const zShape3D *shape1, const zShape3D *shape2, zVec3D *c1, zVec3D *c2)
+{
+  zVec3D tmp1, tmp2;
+  int i;
+
+  for( i=0; _zeo_col_shape3d_kernel[i]._col; i++ ){
+    if( shape1->com == _zeo_col_shape3d_kernel[i].com1 && shape2->com == _zeo_col_shape3d_kernel[i].com2 ){
+      if( !c1 && _zeo_col_shape3d_kernel[i]._chk )
+        return _zeo_col_shape3d_kernel[i]._chk( shape1, shape2 );
+      return _zeo_col_shape3d_kernel[i]._col( shape1, shape2, c1 ? c1 : &tmp1, c1 ? c2 : &tmp2 );
+    }
+    if( shape1->com == _zeo_col_shape3d_kernel[i].com2 && shape2->com == _zeo_col_shape3d_kernel[i].com1 ){
+      if( !c1 && _zeo_col_shape3d_kernel[i]._chk )
+        return _zeo_col_shape3d_kernel[i]._chk( shape2, shape1 );
+      return _zeo_col_shape3d_kernel[i]._col( shape2, shape1, c1 ? c2 : &tmp2, c1 ? c1 : &tmp1 );
+    }
+  }
+  return _zColShape3DGJK( shape1, shape2, c1 ? c1 : &tmp1, c1 ? c2 : &tmp2 );
+}
+
+/* closest points of two 3D shapes dispatched by types. */
+bool zColShape3D(const zShape3D *shape1, const zShape3D *shape2, zVec3D *c1, zVec3D *c2)
+{
+  return _zColShape3DDispatch( shape1, shape2, c1, c2 );
+}
+
+/* check if two 3D shapes are in collision dispatched by types. */
+bool zColChkShape3D(const zShape3D *shape1, const zShape3D *shape2)
+{
+  return _zColShape3DDispatch( shape1, shape2, NULL, NULL );
+}
@@ -0,0 +1,110 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_support - collision checking: support map of convex objects.
+ */
+
+#include <zeo/zeo_col.h>
+
+/* methods for a set of 3D points */
+
+static zVec3D *_zColSupportVec3DDataSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  const zVec3D *v;
+  return ( v = zVec3DDataSupportMap( (zVec3DData*)body, dir ) ) ? zVec3DCopy( v, sp ) : NULL; }
+static zVec3D *_zColSupportVec3DDataCenter(void *body, zVec3D *center){
+  return zVec3DDataBarycenter( (zVec3DData*)body, center ); }
+
+/* assign a set of 3D points to a support map. */
+zColSupport *zColSupportAssignVec3DData(zColSupport *support, zVec3DData *data)
+{
+  support->body = data;
+  support->frame = NULL;
+  support->_supportmap = _zColSupportVec3DDataSupportMap;
+  support->_center = _zColSupportVec3DDataCenter;
+  return support;
+}
+
+/* methods for a polyhedron */
+
+static zVec3D *_zColSupportPH3DSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  const zVec3D *v;
+  return ( v = zPH3DSupportMap( (zPH3D*)body, dir ) ) ? zVec3DCopy( v, sp ) : NULL; }
+static zVec3D *_zColSupportPH3DCenter(void *body, zVec3D *center){
+  int i;
+  zVec3DZero( center );
+  if( zPH3DVertNum((zPH3D*)body) == 0 ) return center;
+  for( i=0; i<zPH3DVertNum((zPH3D*)body); i++ )
+    zVec3DAddDRC( center, zPH3DVert((zPH3D*)body,i) );
+  return zVec3DDivDRC( center, zPH3DVertNum((zPH3D*)body) ); }
+
+/* assign a polyhedron to a support map. */
+zColSupport *zColSupportAssignPH3D(zColSupport *support, const zPH3D *ph, const zFrame3D *frame)
+{
+  support->body = (zPH3D*)ph;
+  support->frame = frame;
+  support->_supportmap = _zColSupportPH3DSupportMap;
+  support->_center = _zColSupportPH3DCenter;
+  return support;
+}
+
+/* methods for a convex polyhedron with vertex adjacency */
+
+static zVec3D *_zColSupportPH3DAdjSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  const zVec3D *v;
+  return ( v = zPH3DAdjSupportMap( (zPH3DAdj*)body, dir ) ) ? zVec3DCopy( v, sp ) : NULL; }
+static zVec3D *_zColSupportPH3DAdjCenter(void *body, zVec3D *center){
+  return _zColSupportPH3DCenter( (void*)((zPH3DAdj*)body)->ph, center ); }
+
+/* assign a convex polyhedron with vertex adjacency to a support map. */
+zColSupport *zColSupportAssignPH3DAdj(zColSupport *support, zPH3DAdj *adj, const zFrame3D *frame)
+{
+  support->body = adj;
+  support->frame = frame;
+  support->_supportmap = _zColSupportPH3DAdjSupportMap;
+  support->_center = _zColSupportPH3DAdjCenter;
+  return support;
+}
+
+/* methods for a 3D shape */
+
+static zVec3D *_zColSupportShape3DSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  return zShape3DSupportMap( (zShape3D*)body, dir, sp ); }
+static zVec3D *_zColSupportShape3DCenter(void *body, zVec3D *center){
+  return zShape3DBarycenter( (zShape3D*)body, center ); }
+
+/* assign a 3D shape to a support map. */
+zColSupport *zColSupportAssignShape3D(zColSupport *support, const zShape3D *shape, const zFrame3D *frame)
+{
+  support->body = (zShape3D*)shape;
+  support->frame = frame;
+  support->_supportmap = _zColSupportShape3DSupportMap;
+  support->_center = _zColSupportShape3DCenter;
+  return support;
+}
+
+/* support map of a convex object. */
+zVec3D *zColSupportMap(const zColSupport *support, const zVec3D *dir, zVec3D *sp)
+{
+  zVec3D d, p;
+
+  if( !support->frame ) return support->_supportmap( support->body, dir, sp );
+  zMulMat3DTVec3D( zFrame3DAtt(support->frame), dir, &d );
+  if( !support->_supportmap( support->body, &d, &p ) ) return NULL;
+  return zXform3D( support->frame, &p, sp );
+}
+
+/* a point inside of a convex object. */
+zVec3D *zColSupportCenter(const zColSupport *support, zVec3D *center)
+{
+  zVec3D c, p1, p2, d;
+
+  if( !support->_center( support->body, &c ) ){
+    /* midpoint of two opposite extreme points for an object without barycenter */
+    zVec3DCreate( &d, 1, 0, 0 );
+    if( !support->_supportmap( support->body, &d, &p1 ) ) return NULL;
+    zVec3DRevDRC( &d );
+    if( !support->_supportmap( support->body, &d, &p2 ) ) return NULL;
+    zVec3DMid( &p1, &p2, &c );
+  }
+  return support->frame ? zXform3D( support->frame, &c, center ) : zVec3DCopy( &c, center );
+}
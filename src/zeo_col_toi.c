@@ -0,0 +1,107 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_col_toi - collision checking: time of impact of moving convex objects.
+ */
+
+#include <zeo/zeo_col.h>
+
+/* interpolate a frame moving with a constant linear and angular velocity. */
+static zFrame3D *_zColTOIFrame(const zFrame3D *start, const zVec3D *vel, const zVec3D *aa, double t, zFrame3D *frame)
+{
+  zVec3DCat( zFrame3DPos(start), t, vel, zFrame3DPos(frame) );
+  zMat3DRotCat( zFrame3DAtt(start), aa, t, zFrame3DAtt(frame) );
+  return frame;
+}
+
+/* radius of a ball about the origin of the object frame which bounds a convex object. */
+static double _zColTOIRadius(const zColSupport *support)
+{
+  zVec3D dir, sp, r;
+  zAxis axis;
+
+  for( axis=zX; axis<=zZ; axis++ ){
+    zVec3DZero( &dir );
+    dir.e[(int)axis] = 1;
+    r.e[(int)axis] = support->_supportmap( support->body, &dir, &sp ) ? fabs( sp.e[(int)axis] ) : 0;
+    dir.e[(int)axis] = -1;
+    if( support->_supportmap( support->body, &dir, &sp ) && fabs( sp.e[(int)axis] ) > r.e[(int)axis] )
+      r.e[(int)axis] = fabs( sp.e[(int)axis] );
+  }
+  return zVec3DNorm( &r );
+}
+
+/* time of impact of two moving convex objects by conservative advancement. */
+bool zColTOISupport(zColSupport *support1, const zFrame3D *frame1_start, const zFrame3D *frame1_end, zColSupport *support2, const zFrame3D *frame2_start, const zFrame3D *frame2_end, double *toi, zVec3D *c1, zVec3D *c2)
+{
+  const zFrame3D *frame1_org, *frame2_org;
+  zFrame3D f1, f2;
+  zVec3D vel1, vel2, aa1, aa2, dv, n, p1, p2;
+  zGJKCache cache;
+  double w, d, mu, t = 0;
+  int i;
+  bool ret = true;
+
+  zVec3DSub( zFrame3DPos(frame1_end), zFrame3DPos(frame1_start), &vel1 );
+  zVec3DSub( zFrame3DPos(frame2_end), zFrame3DPos(frame2_start), &vel2 );
+  zMat3DError( zFrame3DAtt(frame1_end), zFrame3DAtt(frame1_start), &aa1 );
+  zMat3DError( zFrame3DAtt(frame2_end), zFrame3DAtt(frame2_start), &aa2 );
+  zVec3DSub( &vel1, &vel2, &dv );
+  /* upper bound of approaching speed due to rotation */
+  w = zVec3DNorm(&aa1) * _zColTOIRadius( support1 ) + zVec3DNorm(&aa2) * _zColTOIRadius( support2 );
+  frame1_org = support1->frame;
+  frame2_org = support2->frame;
+  support1->frame = &f1;
+  support2->frame = &f2;
+  zGJKCacheInit( &cache );
+  for( i=0; i<ZEO_COL_TOI_MAXITER; i++ ){
+    _zColTOIFrame( frame1_start, &vel1, &aa1, t, &f1 );
+    _zColTOIFrame( frame2_start, &vel2, &aa2, t, &f2 );
+    if( zGJKSupportWarmStart( support1, support2, &cache, &p1, &p2 ) ) break;
+    zVec3DSub( &p2, &p1, &n );
+    if( ( d = zVec3DNorm( &n ) ) <= ZEO_COL_TOI_TOL ) break;
+    zVec3DDivDRC( &n, d );
+    if( ( mu = zVec3DInnerProd( &dv, &n ) + w ) <= zTOL ||
+        ( t += d / mu ) > 1 ){ /* the objects separate from each other */
+      ret = false;
+      break;
+    }
+  }
+  support1->frame = frame1_org;
+  support2->frame = frame2_org;
+  if( !ret ) return false;
+  *toi = t;
+  zVec3DCopy( &p1, c1 );
+  zVec3DCopy( &p2, c2 );
+  return true;
+}
+
+/* time of impact of convex hulls of two moving sets of 3D points. */
+bool zColTOIVec3DData(zVec3DData *data1, const zFrame3D *frame1_start, const zFrame3D *frame1_end, zVec3DData *data2, const zFrame3D *frame2_start, const zFrame3D *frame2_end, double *toi, zVec3D *c1, zVec3D *c2)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignVec3DData( &sup1, data1 );
+  zColSupportAssignVec3DData( &sup2, data2 );
+  return zColTOISupport( &sup1, frame1_start, frame1_end, &sup2, frame2_start, frame2_end, toi, c1, c2 );
+}
+
+/* time of impact of two moving convex polyhedra. */
+bool zColTOIPH3D(const zPH3D *ph1, const zFrame3D *frame1_start, const zFrame3D *frame1_end, const zPH3D *ph2, const zFrame3D *frame2_start, const zFrame3D *frame2_end, double *toi, zVec3D *c1, zVec3D *c2)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignPH3D( &sup1, ph1, NULL );
+  zColSupportAssignPH3D( &sup2, ph2, NULL );
+  return zColTOISupport( &sup1, frame1_start, frame1_end, &sup2, frame2_start, frame2_end, toi, c1, c2 );
+}
+
+/* time of impact of two moving 3D shapes. */
+bool zColTOIShape3D(const zShape3D *shape1, const zFrame3D *frame1_start, const zFrame3D *frame1_end, const zShape3D *shape2, const zFrame3D *frame2_start, const zFrame3D *frame2_end, double *toi, zVec3D *c1, zVec3D *c2)
+{
+  zColSupport sup1, sup2;
+
+  zColSupportAssignShape3D( &sup1, shape1, NULL );
+  zColSupportAssignShape3D( &sup2, shape2, NULL );
+  return zColTOISupport( &sup1, frame1_start, frame1_end, &sup2, frame2_start, frame2_end, toi, c1, c2 );
+}
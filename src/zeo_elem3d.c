@@ -398,6 +398,26 @@ double zTri3DSignedDistFromPoint(const zTri3D *tri, const zVec3D *point)
   return zTri3DSignedClosest( tri, point, &cp );
 }
 
+/* ray casting on a 3D triangle (Moller-Trumbore algorithm). */
+bool zTri3DRaycast(const zTri3D *tri, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  zVec3D e1, e2, p, q, s;
+  double det, u, v, _t;
+
+  zVec3DSub( zTri3DVert(tri,1), zTri3DVert(tri,0), &e1 );
+  zVec3DSub( zTri3DVert(tri,2), zTri3DVert(tri,0), &e2 );
+  zVec3DOuterProd( dir, &e2, &p );
+  if( zIsTiny( det = zVec3DInnerProd( &e1, &p ) ) ) return false; /* parallel to the triangle */
+  zVec3DSub( org, zTri3DVert(tri,0), &s );
+  if( ( u = zVec3DInnerProd( &s, &p ) / det ) < 0 || u > 1 ) return false;
+  zVec3DOuterProd( &s, &e1, &q );
+  if( ( v = zVec3DInnerProd( dir, &q ) / det ) < 0 || u + v > 1 ) return false;
+  if( ( _t = zVec3DInnerProd( &e2, &q ) / det ) < 0 || _t > tmax ) return false;
+  *t = _t;
+  if( normal ) zVec3DCopy( zTri3DNorm(tri), normal );
+  return true;
+}
+
 /* compute a trio of linear scale factors of a point on a 3D triangle.
  * when p is on t, p = l0*t->v0 + l1*t->v1 + l2*t->v2. If p is not on t, the result does not make sense. */
 
@@ -112,6 +112,67 @@ bool zAABox3DPointIsInside(const zAABox3D *box, const zVec3D *point, double marg
          point->e[zZ] > box->min.e[zZ] - margin && point->e[zZ] <= box->max.e[zZ] + margin ? true : false;
 }
 
+/* intersect a ray with slabs of a 3D axis-aligned box. */
+static bool _zAABox3DRaySlab(const zAABox3D *box, const zVec3D *org, const zVec3D *dir, double *tnear, double *tfar, zVec3D *nnear, zVec3D *nfar)
+{
+  zAxis axis, axis_near = zX, axis_far = zX;
+  double t1, t2, s, s_near = 0, s_far = 0;
+
+  *tnear = -HUGE_VAL;
+  *tfar = HUGE_VAL;
+  for( axis=zX; axis<=zZ; axis++ ){
+    if( zIsTiny( dir->e[(int)axis] ) ){
+      if( org->e[(int)axis] < box->min.e[(int)axis] || org->e[(int)axis] > box->max.e[(int)axis] ) return false;
+      continue;
+    }
+    t1 = ( box->min.e[(int)axis] - org->e[(int)axis] ) / dir->e[(int)axis];
+    t2 = ( box->max.e[(int)axis] - org->e[(int)axis] ) / dir->e[(int)axis];
+    s = -1; /* the ray enters through the min side */
+    if( t1 > t2 ){
+      s = t1; t1 = t2; t2 = s;
+      s = 1;
+    }
+    if( t1 > *tnear ){ *tnear = t1; axis_near = axis; s_near = s; }
+    if( t2 < *tfar ){ *tfar = t2; axis_far = axis; s_far = -s; }
+    if( *tnear > *tfar ) return false;
+  }
+  if( nnear ){
+    zVec3DZero( nnear ); nnear->e[(int)axis_near] = s_near;
+    zVec3DZero( nfar );  nfar->e[(int)axis_far] = s_far;
+  }
+  return true;
+}
+
+/* ray casting on a 3D axis-aligned box. */
+bool zAABox3DRaycast(const zAABox3D *box, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  double tnear, tfar;
+  zVec3D nnear, nfar;
+
+  if( !_zAABox3DRaySlab( box, org, dir, &tnear, &tfar, &nnear, &nfar ) ) return false;
+  if( tnear >= 0 ){
+    if( tnear > tmax ) return false;
+    *t = tnear;
+    if( normal ) zVec3DCopy( &nnear, normal );
+  } else{ /* the origin is inside of the box */
+    if( tfar < 0 || tfar > tmax || tfar == HUGE_VAL ) return false;
+    *t = tfar;
+    if( normal ) zVec3DCopy( &nfar, normal );
+  }
+  return true;
+}
+
+/* check if a ray passes through a 3D axis-aligned box. */
+bool zAABox3DRayIsIntersect(const zAABox3D *box, const zVec3D *org, const zVec3D *dir, double tmax, double *tnear)
+{
+  double tfar;
+
+  if( !_zAABox3DRaySlab( box, org, dir, tnear, &tfar, NULL, NULL ) ) return false;
+  if( tfar < 0 || *tnear > tmax ) return false;
+  if( *tnear < 0 ) *tnear = 0;
+  return true;
+}
+
 /* compute volume of a 3D axis-aligned box. */
 double zAABox3DVolume(const zAABox3D *box)
 {
@@ -142,6 +203,14 @@ zAABox3D *zAABox3DEnlarge(zAABox3D *aabox, const zVec3D *v)
   return aabox;
 }
 
+/* the axis along the longest side of a 3D axis-aligned box. */
+zAxis zAABox3DLongestAxis(const zAABox3D *box)
+{
+  return zAABox3DDepth(box) >= zAABox3DWidth(box) ?
+    ( zAABox3DDepth(box) >= zAABox3DHeight(box) ? zX : zZ ) :
+    ( zAABox3DWidth(box) >= zAABox3DHeight(box) ? zY : zZ );
+}
+
 /* print out a 3D axis-aligned box to a file. */
 void zAABox3DFPrint(FILE *fp, const zAABox3D *box)
 {
@@ -182,6 +251,159 @@ void zAABox3DValueFPrint(FILE *fp, const zAABox3D *box)
   fprintf( fp, "\n\n" );
 }
 
+/* ********************************************************** */
+/* balanced binary tree of 3D axis-aligned boxes
+ *//* ******************************************************* */
+
+/* initialize a tree of 3D axis-aligned boxes. */
+zAABox3DTree *zAABox3DTreeInit(zAABox3DTree *tree)
+{
+  tree->node_num = tree->node_capacity = 0;
+  tree->node = NULL;
+  tree->index = NULL;
+  return tree;
+}
+
+/* destroy a tree of 3D axis-aligned boxes. */
+void zAABox3DTreeDestroy(zAABox3DTree *tree)
+{
+  zFree( tree->node );
+  zFree( tree->index );
+  zAABox3DTreeInit( tree );
+}
+
+/* allocate a node of a tree of 3D axis-aligned boxes. */
+static int _zAABox3DTreeAllocNode(zAABox3DTree *tree)
+{
+  zAABox3DTreeNode *node;
+  int capacity;
+
+  if( tree->node_num >= tree->node_capacity ){
+    capacity = _zMax( tree->node_capacity * 2, 16 );
+    if( !( node = zRealloc( tree->node, zAABox3DTreeNode, capacity ) ) ){
+      ZALLOCERROR();
+      return -1;
+    }
+    tree->node = node;
+    tree->node_capacity = capacity;
+  }
+  return tree->node_num++;
+}
+
+/* select the k-th smallest primitive in terms of the center along an axis in a range (quickselect). */
+static void _zAABox3DTreeSelect(zAABox3DTree *tree, const zVec3D center[], int start, int end, int k, zAxis axis)
+{
+  int i, j, l, r, tmp;
+  double pivot;
+
+  for( l=start, r=end-1; l<r; ){
+    pivot = center[tree->index[(l+r)/2]].e[(int)axis];
+    for( i=l, j=r; i<=j; ){
+      while( center[tree->index[i]].e[(int)axis] < pivot ) i++;
+      while( center[tree->index[j]].e[(int)axis] > pivot ) j--;
+      if( i <= j ){
+        tmp = tree->index[i]; tree->index[i++] = tree->index[j]; tree->index[j--] = tmp;
+      }
+    }
+    if( k <= j ) r = j;
+    else if( k >= i ) l = i;
+    else break;
+  }
+}
+
+/* build a subtree of a tree of 3D axis-aligned boxes. */
+static int _zAABox3DTreeBuild(zAABox3DTree *tree, const zAABox3D box[], const zVec3D center[], int start, int end, int leafsize)
+{
+  zAABox3DTreeNode *node;
+  zAABox3D cbox;
+  int i, n, mid;
+
+  if( ( n = _zAABox3DTreeAllocNode( tree ) ) < 0 ) return -1;
+  zVec3DCopy( &center[tree->index[start]], &cbox.min );
+  zVec3DCopy( &center[tree->index[start]], &cbox.max );
+  for( i=start+1; i<end; i++ )
+    zAABox3DEnlarge( &cbox, &center[tree->index[i]] );
+  node = &tree->node[n];
+  if( box ){
+    zAABox3DCopy( &box[tree->index[start]], &node->box );
+    for( i=start+1; i<end; i++ )
+      zAABox3DMerge( &node->box, &node->box, &box[tree->index[i]] );
+  } else
+    zAABox3DCopy( &cbox, &node->box );
+  node->child[0] = node->child[1] = -1;
+  node->start = start;
+  node->num = end - start;
+  if( end - start <= leafsize ) return n;
+  mid = ( start + end ) / 2;
+  _zAABox3DTreeSelect( tree, center, start, end, mid, zAABox3DLongestAxis( &cbox ) );
+  if( ( i = _zAABox3DTreeBuild( tree, box, center, start, mid, leafsize ) ) < 0 ) return -1;
+  tree->node[n].child[0] = i; /* the node buffer might be reallocated */
+  if( ( i = _zAABox3DTreeBuild( tree, box, center, mid, end, leafsize ) ) < 0 ) return -1;
+  tree->node[n].child[1] = i;
+  return n;
+}
+
+/* create a tree of 3D axis-aligned boxes. */
+zAABox3DTree *zAABox3DTreeCreate(zAABox3DTree *tree, const zAABox3D box[], const zVec3D center[], int num, int leafsize)
+{
+  int i;
+
+  zAABox3DTreeInit( tree );
+  if( num <= 0 ) return tree;
+  if( !( tree->index = zAlloc( int, num ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  for( i=0; i<num; i++ ) tree->index[i] = i;
+  if( _zAABox3DTreeBuild( tree, box, center, 0, num, _zMax( leafsize, 1 ) ) < 0 ){
+    zAABox3DTreeDestroy( tree );
+    return NULL;
+  }
+  return tree;
+}
+
+/* find the first primitive hit by a ray in a subtree of a tree of 3D axis-aligned boxes. */
+static bool _zAABox3DTreeRaycast(const zAABox3DTree *tree, int n, const zVec3D *org, const zVec3D *dir, double *tmax, bool (* raycast)(int, const zVec3D *, const zVec3D *, double, double *, void *), void *util)
+{
+  const zAABox3DTreeNode *node;
+  double t, t0, t1;
+  bool hit = false, hit0, hit1;
+  int i;
+
+  node = &tree->node[n];
+  if( zAABox3DTreeNodeIsLeaf( node ) ){
+    for( i=node->start; i<node->start+node->num; i++ )
+      if( raycast( tree->index[i], org, dir, *tmax, &t, util ) ){
+        *tmax = t;
+        hit = true;
+      }
+    return hit;
+  }
+  /* visit the child that the ray enters first */
+  hit0 = zAABox3DRayIsIntersect( &tree->node[node->child[0]].box, org, dir, *tmax, &t0 );
+  hit1 = zAABox3DRayIsIntersect( &tree->node[node->child[1]].box, org, dir, *tmax, &t1 );
+  if( hit0 && hit1 && t1 < t0 ){
+    hit = _zAABox3DTreeRaycast( tree, node->child[1], org, dir, tmax, raycast, util );
+    if( t0 <= *tmax && _zAABox3DTreeRaycast( tree, node->child[0], org, dir, tmax, raycast, util ) ) hit = true;
+    return hit;
+  }
+  if( hit0 && _zAABox3DTreeRaycast( tree, node->child[0], org, dir, tmax, raycast, util ) ) hit = true;
+  if( hit1 && t1 <= *tmax && _zAABox3DTreeRaycast( tree, node->child[1], org, dir, tmax, raycast, util ) ) hit = true;
+  return hit;
+}
+
+/* ray casting on a tree of 3D axis-aligned boxes. */
+bool zAABox3DTreeRaycast(const zAABox3DTree *tree, const zVec3D *org, const zVec3D *dir, double tmax, double *t, bool (* raycast)(int, const zVec3D *, const zVec3D *, double, double *, void *), void *util)
+{
+  double t0;
+
+  if( tree->node_num == 0 ||
+      !zAABox3DRayIsIntersect( &tree->node[0].box, org, dir, tmax, &t0 ) ) return false;
+  if( !_zAABox3DTreeRaycast( tree, 0, org, dir, &tmax, raycast, util ) ) return false;
+  *t = tmax;
+  return true;
+}
+
 /* ********************************************************** */
 /* list of 3D axis-aligned boxes.
  *//* ******************************************************* */
@@ -312,6 +534,34 @@ bool zBox3DPointIsInside(const zBox3D *box, const zVec3D *p, double margin)
   return true;
 }
 
+/* support map of a box. */
+zVec3D *zBox3DSupportMap(const zBox3D *box, const zVec3D *dir, zVec3D *sp)
+{
+  zAxis axis;
+  double l;
+
+  zVec3DCopy( zBox3DCenter(box), sp );
+  for( axis=zX; axis<=zZ; axis++ ){
+    l = 0.5 * zBox3DSpan(box,axis);
+    zVec3DCatDRC( sp, zVec3DInnerProd( zBox3DAxis(box,axis), dir ) >= 0 ? l : -l, zBox3DAxis(box,axis) );
+  }
+  return sp;
+}
+
+/* ray casting on a 3D box. */
+bool zBox3DRaycast(const zBox3D *box, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  zAABox3D aabox;
+  zVec3D o, d, n;
+
+  zXform3DInv( &box->frame, org, &o );
+  zMulMat3DTVec3D( zFrame3DAtt(&box->frame), dir, &d );
+  zAABox3DCreate( &aabox, -0.5*zBox3DDepth(box), -0.5*zBox3DWidth(box), -0.5*zBox3DHeight(box), 0.5*zBox3DDepth(box), 0.5*zBox3DWidth(box), 0.5*zBox3DHeight(box) );
+  if( !zAABox3DRaycast( &aabox, &o, &d, tmax, t, &n ) ) return false;
+  if( normal ) zMulMat3DVec3D( zFrame3DAtt(&box->frame), &n, normal );
+  return true;
+}
+
 /* volume of a 3D box. */
 double zBox3DVolume(const zBox3D *box)
 {
@@ -92,6 +92,36 @@ bool zSphere3DPointIsInside(const zSphere3D *sphere, const zVec3D *point, double
   return zSphere3DDistFromPoint( sphere, point ) < margin ? true : false;
 }
 
+/* support map of a 3D sphere. */
+zVec3D *zSphere3DSupportMap(const zSphere3D *sphere, const zVec3D *dir, zVec3D *sp)
+{
+  double l;
+
+  if( zIsTiny( ( l = zVec3DNorm( dir ) ) ) )
+    return zVec3DCopy( zSphere3DCenter(sphere), sp );
+  return zVec3DCat( zSphere3DCenter(sphere), zSphere3DRadius(sphere)/l, dir, sp );
+}
+
+/* ray casting on a 3D sphere. */
+bool zSphere3DRaycast(const zSphere3D *sphere, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  zVec3D oc;
+  double s[2];
+  int i, n;
+
+  zVec3DSub( org, zSphere3DCenter(sphere), &oc );
+  n = zQuadraticRealRoots( zVec3DSqrNorm(dir), zVec3DInnerProd(&oc,dir), zVec3DSqrNorm(&oc) - zSqr(zSphere3DRadius(sphere)), s );
+  for( i=0; i<n; i++ )
+    if( s[i] >= 0 ) break;
+  if( i == n || s[i] > tmax ) return false;
+  *t = s[i];
+  if( normal ){
+    zVec3DCatDRC( &oc, s[i], dir );
+    zVec3DDiv( &oc, zSphere3DRadius(sphere), normal );
+  }
+  return true;
+}
+
 /* create a 3D sphere from two points at both ends of diameter. */
 zSphere3D *zSphere3DFrom2(zSphere3D *sphere, const zVec3D *v1, const zVec3D *v2)
 {
@@ -6,6 +6,11 @@
 
 #include <zeo/zeo_misc.h>
 
+#ifdef __ZEO_USE_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 static const char *__zaxisname[] = { "x", "y", "z", "tilt", "elev", "azim", NULL };
 
 /* string for the name of axis. */
@@ -63,3 +68,120 @@ zDir zDirRev(zDir dir)
 {
   return dir == ZEO_DIR_NONE ? ZEO_DIR_NONE : ( 1 + dir - (dir+1)%2 *2 );
 }
+
+/* real roots of a quadratic equation a t^2 + 2 b t + c = 0. */
+int zQuadraticRealRoots(double a, double b, double c, double t[2])
+{
+  double d;
+
+  if( zIsTiny( a ) ){
+    if( zIsTiny( b ) ) return 0;
+    t[0] = -0.5 * c / b;
+    return 1;
+  }
+  if( ( d = b*b - a*c ) < 0 ) return 0;
+  d = sqrt( d );
+  t[0] = ( -b - d ) / a;
+  t[1] = ( -b + d ) / a;
+  if( t[0] > t[1] ){
+    d = t[0]; t[0] = t[1]; t[1] = d;
+  }
+  return 2;
+}
+
+/* number of threads to be used. */
+int zParallelThreadNum(int thread_num)
+{
+#ifdef __ZEO_USE_PTHREAD
+  long n;
+
+  if( thread_num > 0 ) return thread_num;
+  return ( n = sysconf( _SC_NPROCESSORS_ONLN ) ) > 0 ? (int)n : 1;
+#else
+  return thread_num > 0 ? thread_num : 1;
+#endif /* __ZEO_USE_PTHREAD */
+}
+
+#ifdef __ZEO_USE_PTHREAD
+/* number of chunks assigned to each thread on average */
+#define Z_PARALLEL_CHUNK_PER_THREAD 8
+
+typedef struct{
+  int num;
+  int chunk;
+  int next;
+  void (* func)(void*,int,int,int);
+  void *util;
+  pthread_mutex_t mutex;
+} _zParallel;
+
+typedef struct{
+  _zParallel *parallel;
+  int id;
+} _zParallelWorker;
+
+/* process chunks assigned dynamically. */
+static void *_zParallelWorkerRun(void *arg)
+{
+  _zParallelWorker *worker;
+  _zParallel *parallel;
+  int start;
+
+  worker = (_zParallelWorker *)arg;
+  parallel = worker->parallel;
+  while( 1 ){
+    pthread_mutex_lock( &parallel->mutex );
+    start = parallel->next;
+    parallel->next += parallel->chunk;
+    pthread_mutex_unlock( &parallel->mutex );
+    if( start >= parallel->num ) break;
+    parallel->func( parallel->util, worker->id, start, _zMin( start + parallel->chunk, parallel->num ) );
+  }
+  return NULL;
+}
+#endif /* __ZEO_USE_PTHREAD */
+
+/* parallel loop. */
+int zParallelFor(int num, int thread_num, void (* func)(void*,int,int,int), void *util)
+{
+#ifdef __ZEO_USE_PTHREAD
+  _zParallel parallel;
+  _zParallelWorker *worker;
+  pthread_t *thread;
+  int i, n;
+
+  if( ( thread_num = _zMin( zParallelThreadNum( thread_num ), num ) ) <= 1 ) goto SERIAL;
+  worker = zAlloc( _zParallelWorker, thread_num );
+  thread = zAlloc( pthread_t, thread_num );
+  if( !worker || !thread ){
+    ZALLOCERROR();
+    zFree( worker );
+    zFree( thread );
+    goto SERIAL;
+  }
+  parallel.num = num;
+  parallel.chunk = _zMax( num / ( thread_num * Z_PARALLEL_CHUNK_PER_THREAD ), 1 );
+  parallel.next = 0;
+  parallel.func = func;
+  parallel.util = util;
+  pthread_mutex_init( &parallel.mutex, NULL );
+  for( i=0; i<thread_num; i++ ){
+    worker[i].parallel = &parallel;
+    worker[i].id = i;
+  }
+  /* the caller thread works as the 0th worker */
+  for( n=1; n<thread_num; n++ )
+    if( pthread_create( &thread[n], NULL, _zParallelWorkerRun, &worker[n] ) != 0 ) break;
+  _zParallelWorkerRun( &worker[0] );
+  for( i=1; i<n; i++ )
+    pthread_join( thread[i], NULL );
+  pthread_mutex_destroy( &parallel.mutex );
+  zFree( worker );
+  zFree( thread );
+  return n;
+
+ SERIAL:
+#endif /* __ZEO_USE_PTHREAD */
+  if( num > 0 ) func( util, 0, 0, num );
+  return 1;
+}
@@ -0,0 +1,154 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_multishape3d_raycast - ray casting on multiple 3D shapes.
+ */
+
+#include <zeo/zeo_multishape3d.h>
+
+/* initialize a ray caster on multiple 3D shapes. */
+static zMultiShape3DRaycaster *_zMultiShape3DRaycasterInit(zMultiShape3DRaycaster *rc)
+{
+  rc->ms = NULL;
+  rc->box = NULL;
+  rc->ph = NULL;
+  rc->bvh = NULL;
+  zAABox3DTreeInit( &rc->boxtree );
+  return rc;
+}
+
+/* destroy a ray caster on multiple 3D shapes. */
+void zMultiShape3DRaycasterDestroy(zMultiShape3DRaycaster *rc)
+{
+  int i;
+
+  if( rc->ms ){
+    for( i=0; i<zMultiShape3DShapeNum(rc->ms); i++ ){
+      if( rc->bvh ) zPH3DBVHDestroy( &rc->bvh[i] );
+      if( rc->ph ) zPH3DDestroy( &rc->ph[i] );
+    }
+  }
+  zFree( rc->box );
+  zFree( rc->ph );
+  zFree( rc->bvh );
+  zAABox3DTreeDestroy( &rc->boxtree );
+  _zMultiShape3DRaycasterInit( rc );
+}
+
+/* create a ray caster on multiple 3D shapes. */
+zMultiShape3DRaycaster *zMultiShape3DRaycasterCreate(zMultiShape3DRaycaster *rc, const zMultiShape3D *ms)
+{
+  zShape3D *shape;
+  zVec3D *center = NULL;
+  int i, num;
+
+  _zMultiShape3DRaycasterInit( rc );
+  if( ( num = zMultiShape3DShapeNum(ms) ) == 0 ) return rc;
+  rc->box = zAlloc( zAABox3D, num );
+  rc->ph = zAlloc( zPH3D, num );
+  rc->bvh = zAlloc( zPH3DBVH, num );
+  center = zAlloc( zVec3D, num );
+  if( !rc->box || !rc->ph || !rc->bvh || !center ){
+    ZALLOCERROR();
+    goto FAILURE;
+  }
+  rc->ms = ms;
+  for( i=0; i<num; i++ ){
+    zPH3DInit( &rc->ph[i] );
+    zPH3DBVHInit( &rc->bvh[i] );
+  }
+  for( i=0; i<num; i++ ){
+    shape = zMultiShape3DShape(ms,i);
+    if( shape->com == &zeo_shape3d_ph_com ){
+      if( !zPH3DBVHCreate( &rc->bvh[i], zShape3DPH(shape), 0 ) ) goto FAILURE;
+    } else
+    if( shape->com == &zeo_shape3d_nurbs_com ){
+      if( !zNURBS3DToPH( zShape3DNURBS(shape), &rc->ph[i] ) ||
+          !zPH3DBVHCreate( &rc->bvh[i], &rc->ph[i], 0 ) ) goto FAILURE;
+    }
+    if( !zShape3DAABB( shape, &rc->box[i] ) )
+      zAABox3DInit( &rc->box[i] ); /* empty shape */
+    zAABox3DCenter( &rc->box[i], &center[i] );
+  }
+  if( !zAABox3DTreeCreate( &rc->boxtree, rc->box, center, num, ZEO_MULTISHAPE3D_RAYCASTER_LEAFSIZE ) ) goto FAILURE;
+  zFree( center );
+  return rc;
+
+ FAILURE:
+  zFree( center );
+  zMultiShape3DRaycasterDestroy( rc );
+  return NULL;
+}
+
+typedef struct{
+  const zMultiShape3DRaycaster *rc;
+  zMultiShape3DRayHit *hit;
+} _zMultiShape3DRaycasterHit;
+
+/* ray casting on a shape in a ray caster. */
+static bool _zMultiShape3DRaycasterShape(int i, const zVec3D *org, const zVec3D *dir, double tmax, double *t, void *util)
+{
+  _zMultiShape3DRaycasterHit *rh;
+  zVec3D normal;
+
+  rh = (_zMultiShape3DRaycasterHit *)util;
+  if( rh->rc->bvh[i].ph ){
+    if( !zPH3DBVHRaycast( &rh->rc->bvh[i], org, dir, tmax, t, &normal, NULL ) ) return false;
+  } else
+  if( !zShape3DRaycast( zMultiShape3DShape(rh->rc->ms,i), org, dir, tmax, t, &normal ) ) return false;
+  rh->hit->shape = i;
+  zVec3DCopy( &normal, &rh->hit->normal );
+  return true;
+}
+
+/* ray casting on multiple 3D shapes. */
+bool zMultiShape3DRaycasterRaycast(const zMultiShape3DRaycaster *rc, const zVec3D *org, const zVec3D *dir, double tmax, zMultiShape3DRayHit *hit)
+{
+  _zMultiShape3DRaycasterHit rh;
+
+  hit->shape = -1;
+  hit->t = HUGE_VAL;
+  rh.rc = rc;
+  rh.hit = hit;
+  if( !zAABox3DTreeRaycast( &rc->boxtree, org, dir, tmax, &hit->t, _zMultiShape3DRaycasterShape, &rh ) ) return false;
+  zVec3DCat( org, hit->t, dir, &hit->pos );
+  return true;
+}
+
+/* batched ray casting */
+
+typedef struct{
+  const zMultiShape3DRaycaster *rc;
+  const zVec3D *org;
+  const zVec3D *dir;
+  double tmax;
+  zMultiShape3DRayHit *hit;
+} _zMultiShape3DRaycasterBatch;
+
+/* ray casting on a chunk of rays. */
+static void _zMultiShape3DRaycasterBatchChunk(void *util, int id, int start, int end)
+{
+  _zMultiShape3DRaycasterBatch *batch;
+  int i;
+
+  batch = (_zMultiShape3DRaycasterBatch *)util;
+  for( i=start; i<end; i++ )
+    zMultiShape3DRaycasterRaycast( batch->rc, &batch->org[i], &batch->dir[i], batch->tmax, &batch->hit[i] );
+}
+
+/* batched ray casting on multiple 3D shapes. */
+int zMultiShape3DRaycasterRaycastBatch(const zMultiShape3DRaycaster *rc, const zVec3D org[], const zVec3D dir[], int num, double tmax, zMultiShape3DRayHit hit[], int thread_num)
+{
+  _zMultiShape3DRaycasterBatch batch;
+  int i, count = 0;
+
+  batch.rc = rc;
+  batch.org = org;
+  batch.dir = dir;
+  batch.tmax = tmax;
+  batch.hit = hit;
+  zParallelFor( num, thread_num, _zMultiShape3DRaycasterBatchChunk, &batch );
+  for( i=0; i<num; i++ )
+    if( hit[i].shape >= 0 ) count++;
+  return count;
+}
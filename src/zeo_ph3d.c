@@ -168,6 +168,142 @@ const zVec3D *zPH3DContigVert(const zPH3D *ph, const zVec3D *point, double *dist
   return v;
 }
 
+/* support map of a 3D polyhedron. */
+const zVec3D *zPH3DSupportMap(const zPH3D *ph, const zVec3D *dir)
+{
+  int i;
+  zVec3D *v;
+  double d, d_max;
+
+  if( zPH3DVertNum(ph) == 0 ){
+    ZRUNERROR( ZEO_ERR_NOVERT );
+    return NULL;
+  }
+  v = zPH3DVert(ph,0);
+  d_max = zVec3DInnerProd( v, dir );
+  for( i=1; i<zPH3DVertNum(ph); i++ )
+    if( ( d = zVec3DInnerProd( zPH3DVert(ph,i), dir ) ) > d_max ){
+      v = zPH3DVert(ph,i);
+      d_max = d;
+    }
+  return v;
+}
+
+/* initialize vertex adjacency of a convex polyhedron. */
+zPH3DAdj *zPH3DAdjInit(zPH3DAdj *adj)
+{
+  adj->ph = NULL;
+  adj->offset = adj->index = NULL;
+  adj->hint = 0;
+  return adj;
+}
+
+/* add a vertex to the list of adjacent vertices of another vertex if not listed yet. */
+static void _zPH3DAdjAdd(zPH3DAdj *adj, int deg[], int i, int j)
+{
+  int k;
+
+  for( k=adj->offset[i]; k<adj->offset[i]+deg[i]; k++ )
+    if( adj->index[k] == j ) return;
+  adj->index[adj->offset[i]+deg[i]++] = j;
+}
+
+/* the first vertex which has adjacent vertices. */
+static int _zPH3DAdjFirst(const zPH3DAdj *adj)
+{
+  int i;
+
+  for( i=0; i<zPH3DVertNum(adj->ph); i++ )
+    if( adj->offset[i+1] > adj->offset[i] ) return i;
+  return 0;
+}
+
+/* create vertex adjacency of a convex polyhedron. */
+zPH3DAdj *zPH3DAdjCreate(zPH3DAdj *adj, const zPH3D *ph)
+{
+  int i, j, n, start, v[3];
+  int *deg;
+
+  zPH3DAdjInit( adj );
+  adj->ph = ph;
+  n = zPH3DVertNum(ph);
+  adj->offset = zAlloc( int, n+1 );
+  adj->index = zAlloc( int, zPH3DFaceNum(ph)*6 );
+  deg = zAlloc( int, n );
+  if( !adj->offset || ( zPH3DFaceNum(ph) > 0 && !adj->index ) || ( n > 0 && !deg ) ){
+    ZALLOCERROR();
+    goto FAILURE;
+  }
+  /* upper bound of the number of adjacent vertices */
+  for( i=0; i<zPH3DFaceNum(ph); i++ )
+    for( j=0; j<3; j++ ){
+      if( ( v[j] = zTri3DVert(zPH3DFace(ph,i),j) - zPH3DVertBuf(ph) ) < 0 || v[j] >= n ){
+        ZRUNERROR( ZEO_ERR_PH_INVALID_VERT_ID, v[j] );
+        goto FAILURE;
+      }
+      adj->offset[v[j]+1] += 2;
+    }
+  for( i=0; i<n; i++ ) adj->offset[i+1] += adj->offset[i];
+  for( i=0; i<zPH3DFaceNum(ph); i++ ){
+    for( j=0; j<3; j++ )
+      v[j] = zTri3DVert(zPH3DFace(ph,i),j) - zPH3DVertBuf(ph);
+    for( j=0; j<3; j++ ){
+      _zPH3DAdjAdd( adj, deg, v[j], v[(j+1)%3] );
+      _zPH3DAdjAdd( adj, deg, v[j], v[(j+2)%3] );
+    }
+  }
+  /* pack lists of adjacent vertices */
+  for( start=0, i=0; i<n; i++ ){
+    j = adj->offset[i];
+    adj->offset[i] = start;
+    memmove( &adj->index[start], &adj->index[j], sizeof(int)*deg[i] );
+    start += deg[i];
+  }
+  adj->offset[n] = start;
+  adj->hint = _zPH3DAdjFirst( adj ); /* skip vertices referred by no face */
+  zFree( deg );
+  return adj;
+
+ FAILURE:
+  zFree( deg );
+  zPH3DAdjDestroy( adj );
+  return NULL;
+}
+
+/* destroy vertex adjacency of a convex polyhedron. */
+void zPH3DAdjDestroy(zPH3DAdj *adj)
+{
+  zFree( adj->offset );
+  zFree( adj->index );
+  zPH3DAdjInit( adj );
+}
+
+/* support map of a convex polyhedron by hill-climbing. */
+const zVec3D *zPH3DAdjSupportMap(zPH3DAdj *adj, const zVec3D *dir)
+{
+  int i, k, next;
+  double d, d_max;
+
+  if( zPH3DVertNum(adj->ph) == 0 ){
+    ZRUNERROR( ZEO_ERR_NOVERT );
+    return NULL;
+  }
+  if( !adj->offset || adj->offset[zPH3DVertNum(adj->ph)] == 0 )
+    return zPH3DSupportMap( adj->ph, dir );
+  if( adj->hint < 0 || adj->hint >= zPH3DVertNum(adj->ph) ||
+      adj->offset[adj->hint+1] == adj->offset[adj->hint] ) adj->hint = _zPH3DAdjFirst( adj );
+  d_max = zVec3DInnerProd( zPH3DVert(adj->ph,adj->hint), dir );
+  for( next=adj->hint; ; adj->hint=next ){
+    for( k=adj->offset[adj->hint]; k<adj->offset[adj->hint+1]; k++ )
+      if( ( d = zVec3DInnerProd( zPH3DVert(adj->ph,( i = adj->index[k] )), dir ) ) > d_max ){
+        next = i;
+        d_max = d;
+      }
+    if( next == adj->hint ) break;
+  }
+  return zPH3DVert(adj->ph,adj->hint);
+}
+
 /* the closest point to a 3D polyhedron.
  * note: this is not an exact computation because it supposes that
  *  - the polyhedron is convex
@@ -213,6 +349,20 @@ bool zPH3DPointIsInside(const zPH3D *ph, const zVec3D *point, double margin)
   return true;
 }
 
+/* ray casting on a polyhedron. */
+bool zPH3DRaycast(const zPH3D *ph, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal, int *face)
+{
+  int i, f = -1;
+
+  for( i=0; i<zPH3DFaceNum(ph); i++ )
+    if( zTri3DRaycast( zPH3DFace(ph,i), org, dir, tmax, &tmax, NULL ) ) f = i;
+  if( f < 0 ) return false;
+  *t = tmax;
+  if( normal ) zVec3DCopy( zPH3DFaceNorm(ph,f), normal );
+  if( face ) *face = f;
+  return true;
+}
+
 /* volume of a 3D polyhedron. */
 double zPH3DVolume(const zPH3D *ph)
 {
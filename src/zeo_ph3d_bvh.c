@@ -0,0 +1,199 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_ph3d_bvh - bounding volume hierarchy of faces of a polyhedron.
+ */
+
+#include <zeo/zeo_ph3d.h>
+
+/* initialize a bounding volume hierarchy of a polyhedron. */
+zPH3DBVH *zPH3DBVHInit(zPH3DBVH *bvh)
+{
+  bvh->ph = NULL;
+  zAABox3DTreeInit( &bvh->boxtree );
+  bvh->leafsize = ZEO_PH3D_BVH_DEFAULT_LEAFSIZE;
+  return bvh;
+}
+
+/* destroy a bounding volume hierarchy of a polyhedron. */
+void zPH3DBVHDestroy(zPH3DBVH *bvh)
+{
+  zAABox3DTreeDestroy( &bvh->boxtree );
+  zPH3DBVHInit( bvh );
+}
+
+/* create a bounding volume hierarchy of a polyhedron. */
+zPH3DBVH *zPH3DBVHCreate(zPH3DBVH *bvh, const zPH3D *ph, int leafsize)
+{
+  zAABox3D *box;
+  zVec3D *centroid;
+  zTri3D *face;
+  int i;
+
+  zPH3DBVHInit( bvh );
+  bvh->ph = ph;
+  if( leafsize > 0 ) bvh->leafsize = leafsize;
+  if( zPH3DFaceNum(ph) == 0 ) return bvh;
+  box = zAlloc( zAABox3D, zPH3DFaceNum(ph) );
+  centroid = zAlloc( zVec3D, zPH3DFaceNum(ph) );
+  if( !box || !centroid ){
+    ZALLOCERROR();
+    bvh = NULL;
+    goto TERMINATE;
+  }
+  for( i=0; i<zPH3DFaceNum(ph); i++ ){
+    face = zPH3DFace( ph, i );
+    zVec3DCopy( zTri3DVert(face,0), &box[i].min );
+    zVec3DCopy( zTri3DVert(face,0), &box[i].max );
+    zAABox3DEnlarge( &box[i], zTri3DVert(face,1) );
+    zAABox3DEnlarge( &box[i], zTri3DVert(face,2) );
+    zTri3DBarycenter( face, &centroid[i] );
+  }
+  if( !zAABox3DTreeCreate( &bvh->boxtree, box, centroid, zPH3DFaceNum(ph), bvh->leafsize ) ){
+    zPH3DBVHDestroy( bvh );
+    bvh = NULL;
+  }
+ TERMINATE:
+  zFree( box );
+  zFree( centroid );
+  return bvh;
+}
+
+/* closest point query */
+
+typedef struct{
+  const zVec3D *point;
+  double dmin_sqr;     /* squared distance to the current closest point */
+  double dmin;         /* distance to the current closest point */
+  double plane_dist;   /* absolute distance to the plane of the current closest face */
+  zVec3D cp;           /* current closest point */
+  int face;            /* index of the current closest face */
+} _zPH3DBVHClosest;
+
+/* test a face as the closest face. */
+static void _zPH3DBVHClosestTest(const zPH3DBVH *bvh, int i, _zPH3DBVHClosest *closest)
+{
+  zTri3D *face;
+  zVec3D cp;
+  double d, pd;
+
+  face = zPH3DBVHFace( bvh, i );
+  d = zTri3DClosest( face, closest->point, &cp );
+  if( d > closest->dmin + zTOL ) return;
+  pd = fabs( zTri3DDistFromPointToPlane( face, closest->point ) );
+  /* among faces sharing the closest point, choose the one facing the point the most squarely */
+  if( d > closest->dmin - zTOL && pd <= closest->plane_dist ) return;
+  closest->dmin = d;
+  closest->dmin_sqr = _zSqr( d + zTOL );
+  closest->plane_dist = pd;
+  zVec3DCopy( &cp, &closest->cp );
+  closest->face = bvh->boxtree.index[i];
+}
+
+/* find the closest face in a subtree of a bounding volume hierarchy. */
+static void _zPH3DBVHClosestNode(const zPH3DBVH *bvh, int n, _zPH3DBVHClosest *closest)
+{
+  const zAABox3DTreeNode *node;
+  double d0, d1;
+  int i;
+
+  node = &bvh->boxtree.node[n];
+  if( zAABox3DTreeNodeIsLeaf( node ) ){
+    for( i=node->start; i<node->start+node->num; i++ )
+      _zPH3DBVHClosestTest( bvh, i, closest );
+    return;
+  }
+  /* visit the nearer child first */
+  d0 = zAABox3DSqrDistFromPoint( &bvh->boxtree.node[node->child[0]].box, closest->point );
+  d1 = zAABox3DSqrDistFromPoint( &bvh->boxtree.node[node->child[1]].box, closest->point );
+  if( d0 <= d1 ){
+    if( d0 <= closest->dmin_sqr ) _zPH3DBVHClosestNode( bvh, node->child[0], closest );
+    if( d1 <= closest->dmin_sqr ) _zPH3DBVHClosestNode( bvh, node->child[1], closest );
+  } else{
+    if( d1 <= closest->dmin_sqr ) _zPH3DBVHClosestNode( bvh, node->child[1], closest );
+    if( d0 <= closest->dmin_sqr ) _zPH3DBVHClosestNode( bvh, node->child[0], closest );
+  }
+}
+
+/* find the closest face to a point in a bounding volume hierarchy. */
+static bool _zPH3DBVHClosest(const zPH3DBVH *bvh, const zVec3D *point, _zPH3DBVHClosest *closest)
+{
+  closest->point = point;
+  closest->dmin = closest->dmin_sqr = closest->plane_dist = HUGE_VAL;
+  zVec3DCopy( point, &closest->cp );
+  closest->face = -1;
+  if( bvh->boxtree.node_num == 0 ) return false;
+  _zPH3DBVHClosestNode( bvh, 0, closest );
+  return true;
+}
+
+/* closest point from a point to a polyhedron by a bounding volume hierarchy. */
+double zPH3DBVHClosest(const zPH3DBVH *bvh, const zVec3D *point, zVec3D *closestpoint, int *face)
+{
+  _zPH3DBVHClosest closest;
+
+  _zPH3DBVHClosest( bvh, point, &closest );
+  zVec3DCopy( &closest.cp, closestpoint );
+  if( face ) *face = closest.face;
+  return closest.dmin;
+}
+
+/* signed closest point from a point to a polyhedron by a bounding volume hierarchy. */
+double zPH3DBVHSignedClosest(const zPH3DBVH *bvh, const zVec3D *point, zVec3D *closestpoint, int *face)
+{
+  _zPH3DBVHClosest closest;
+
+  if( !_zPH3DBVHClosest( bvh, point, &closest ) ){
+    zVec3DCopy( point, closestpoint );
+    if( face ) *face = -1;
+    return HUGE_VAL;
+  }
+  zVec3DCopy( &closest.cp, closestpoint );
+  if( face ) *face = closest.face;
+  return zTri3DDistFromPointToPlane( zPH3DFace(bvh->ph,closest.face), point ) >= 0 ? closest.dmin : -closest.dmin;
+}
+
+/* distance from a point to a polyhedron by a bounding volume hierarchy. */
+double zPH3DBVHDistFromPoint(const zPH3DBVH *bvh, const zVec3D *point)
+{
+  zVec3D cp;
+  return zPH3DBVHClosest( bvh, point, &cp, NULL );
+}
+
+/* signed distance from a point to a polyhedron by a bounding volume hierarchy. */
+double zPH3DBVHSignedDistFromPoint(const zPH3DBVH *bvh, const zVec3D *point)
+{
+  zVec3D cp;
+  return zPH3DBVHSignedClosest( bvh, point, &cp, NULL );
+}
+
+/* ray casting */
+
+typedef struct{
+  const zPH3D *ph;
+  int face;            /* index of the current first hit face */
+} _zPH3DBVHRaycast;
+
+/* ray casting on a face of a polyhedron in a bounding volume hierarchy. */
+static bool _zPH3DBVHRaycastFace(int i, const zVec3D *org, const zVec3D *dir, double tmax, double *t, void *util)
+{
+  _zPH3DBVHRaycast *rc;
+
+  rc = (_zPH3DBVHRaycast *)util;
+  if( !zTri3DRaycast( zPH3DFace(rc->ph,i), org, dir, tmax, t, NULL ) ) return false;
+  rc->face = i;
+  return true;
+}
+
+/* ray casting on a polyhedron by a bounding volume hierarchy. */
+bool zPH3DBVHRaycast(const zPH3DBVH *bvh, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal, int *face)
+{
+  _zPH3DBVHRaycast rc;
+
+  rc.ph = bvh->ph;
+  rc.face = -1;
+  if( !zAABox3DTreeRaycast( &bvh->boxtree, org, dir, tmax, t, _zPH3DBVHRaycastFace, &rc ) ) return false;
+  if( normal ) zVec3DCopy( zPH3DFaceNorm(bvh->ph,rc.face), normal );
+  if( face ) *face = rc.face;
+  return true;
+}
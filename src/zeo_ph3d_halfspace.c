@@ -0,0 +1,136 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_ph3d_halfspace - half-space representation of a convex polyhedron.
+ */
+
+#include <zeo/zeo_ph3d.h>
+
+/* initialize a half-space representation of a convex polyhedron. */
+zPH3DHalfSpace *zPH3DHalfSpaceInit(zPH3DHalfSpace *hs)
+{
+  hs->num = 0;
+  hs->nx = hs->ny = hs->nz = hs->d = NULL;
+  return hs;
+}
+
+/* destroy a half-space representation of a convex polyhedron. */
+void zPH3DHalfSpaceDestroy(zPH3DHalfSpace *hs)
+{
+  zFree( hs->nx ); /* ny, nz and d share the buffer */
+  zPH3DHalfSpaceInit( hs );
+}
+
+/* create a half-space representation of a convex polyhedron. */
+zPH3DHalfSpace *zPH3DHalfSpaceCreate(zPH3DHalfSpace *hs, const zPH3D *ph)
+{
+  const zVec3D *n;
+  double d;
+  int i, j, num;
+
+  zPH3DHalfSpaceInit( hs );
+  if( ( num = zPH3DFaceNum(ph) ) == 0 ) return hs;
+  if( !( hs->nx = zAlloc( double, num*4 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  hs->ny = hs->nx + num;
+  hs->nz = hs->ny + num;
+  hs->d  = hs->nz + num;
+  for( i=0; i<num; i++ ){
+    n = zTri3DNorm( zPH3DFace(ph,i) );
+    d = zVec3DInnerProd( n, zTri3DVert(zPH3DFace(ph,i),0) );
+    for( j=0; j<hs->num; j++ ) /* merge coplanar faces */
+      if( zIsTiny( hs->nx[j] - n->c.x ) && zIsTiny( hs->ny[j] - n->c.y ) &&
+          zIsTiny( hs->nz[j] - n->c.z ) && zIsTiny( hs->d[j] - d ) ) break;
+    if( j < hs->num ) continue;
+    hs->nx[hs->num] = n->c.x;
+    hs->ny[hs->num] = n->c.y;
+    hs->nz[hs->num] = n->c.z;
+    hs->d[hs->num++] = d;
+  }
+  return hs;
+}
+
+/* check if a point is inside of a convex polyhedron in a half-space representation. */
+bool zPH3DHalfSpacePointIsInside(const zPH3DHalfSpace *hs, const zVec3D *point, double margin)
+{
+  int i;
+
+  for( i=0; i<hs->num; i++ )
+    if( hs->nx[i]*point->c.x + hs->ny[i]*point->c.y + hs->nz[i]*point->c.z - hs->d[i] >= margin ) return false;
+  return true;
+}
+
+typedef struct{
+  const zPH3DHalfSpace *hs;
+  const zVec3D *point;
+  int num;
+  double margin;
+  bool *inside;
+  int *count;
+} _zPH3DHalfSpaceBatch;
+
+/* check if a block of points are inside of a convex polyhedron. */
+static int _zPH3DHalfSpaceBlock(const zPH3DHalfSpace *hs, const zVec3D point[], int num, double margin, bool inside[])
+{
+  double x[ZEO_PH3D_HALFSPACE_BLOCK], y[ZEO_PH3D_HALFSPACE_BLOCK], z[ZEO_PH3D_HALFSPACE_BLOCK];
+  double dmax[ZEO_PH3D_HALFSPACE_BLOCK];
+  double nx, ny, nz, d, s;
+  int i, j, count = 0;
+
+  for( j=0; j<num; j++ ){
+    x[j] = point[j].c.x;
+    y[j] = point[j].c.y;
+    z[j] = point[j].c.z;
+    dmax[j] = -HUGE_VAL;
+  }
+  for( i=0; i<hs->num; i++ ){
+    nx = hs->nx[i]; ny = hs->ny[i]; nz = hs->nz[i]; d = hs->d[i];
+    for( j=0; j<num; j++ ){ /* vectorized loop */
+      s = nx*x[j] + ny*y[j] + nz*z[j] - d;
+      dmax[j] = dmax[j] > s ? dmax[j] : s;
+    }
+  }
+  for( j=0; j<num; j++ ){
+    if( dmax[j] < margin ) count++;
+    if( inside ) inside[j] = dmax[j] < margin ? true : false;
+  }
+  return count;
+}
+
+/* check if a chunk of blocks of points are inside of a convex polyhedron. */
+static void _zPH3DHalfSpaceBatchChunk(void *util, int id, int start, int end)
+{
+  _zPH3DHalfSpaceBatch *batch;
+  int i, head, n;
+
+  batch = (_zPH3DHalfSpaceBatch *)util;
+  for( i=start; i<end; i++ ){
+    head = i * ZEO_PH3D_HALFSPACE_BLOCK;
+    n = _zMin( batch->num - head, ZEO_PH3D_HALFSPACE_BLOCK );
+    batch->count[id] += _zPH3DHalfSpaceBlock( batch->hs, &batch->point[head], n, batch->margin, batch->inside ? &batch->inside[head] : NULL );
+  }
+}
+
+/* check if points are inside of a convex polyhedron in a half-space representation. */
+int zPH3DHalfSpacePointIsInsideBatch(const zPH3DHalfSpace *hs, const zVec3D point[], int num, double margin, bool inside[], int thread_num)
+{
+  _zPH3DHalfSpaceBatch batch;
+  int i, count = 0;
+
+  thread_num = zParallelThreadNum( thread_num );
+  if( !( batch.count = zAlloc( int, thread_num ) ) ){
+    ZALLOCERROR();
+    return 0;
+  }
+  batch.hs = hs;
+  batch.point = point;
+  batch.num = num;
+  batch.margin = margin;
+  batch.inside = inside;
+  zParallelFor( ( num + ZEO_PH3D_HALFSPACE_BLOCK - 1 ) / ZEO_PH3D_HALFSPACE_BLOCK, thread_num, _zPH3DHalfSpaceBatchChunk, &batch );
+  for( i=0; i<thread_num; i++ ) count += batch.count[i];
+  zFree( batch.count );
+  return count;
+}
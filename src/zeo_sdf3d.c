@@ -0,0 +1,341 @@
+/* Zeo - Z/Geometry and optics computation library.
+ * Copyright (C) 2005 Tomomichi Sugihara (Zhidao)
+ *
+ * zeo_sdf3d - signed distance field on a voxel grid.
+ */
+
+#include <zeo/zeo_sdf3d.h>
+
+/* initialize a signed distance field. */
+zSDF3D *zSDF3DInit(zSDF3D *sdf)
+{
+  zVec3DZero( &sdf->origin );
+  sdf->pitch = 0;
+  sdf->num[zX] = sdf->num[zY] = sdf->num[zZ] = 0;
+  sdf->val = NULL;
+  return sdf;
+}
+
+/* allocate a grid of a signed distance field. */
+zSDF3D *zSDF3DAlloc(zSDF3D *sdf, const zVec3D *origin, double pitch, int nx, int ny, int nz)
+{
+  zSDF3DInit( sdf );
+  /* the number of bytes of the grid has to be within the range of int */
+  if( nx < 2 || ny < 2 || nz < 2 || nx > INT_MAX / (int)sizeof(double) / ny / nz ){
+    ZRUNERROR( ZEO_ERR_SDF3D_INVALID_SIZE, nx, ny, nz );
+    return NULL;
+  }
+  if( !( pitch > 0 ) ){ /* also rejects NaN */
+    ZRUNERROR( ZEO_ERR_SDF3D_INVALID_PITCH, pitch );
+    return NULL;
+  }
+  if( !( sdf->val = zAlloc( double, nx*ny*nz ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  zVec3DCopy( origin, &sdf->origin );
+  sdf->pitch = pitch;
+  sdf->num[zX] = nx;
+  sdf->num[zY] = ny;
+  sdf->num[zZ] = nz;
+  return sdf;
+}
+
+/* destroy a signed distance field. */
+void zSDF3DDestroy(zSDF3D *sdf)
+{
+  zFree( sdf->val );
+  zSDF3DInit( sdf );
+}
+
+/* baking */
+
+typedef struct{
+  const zShape3D *shape; /* array of shapes */
+  int num;               /* number of shapes */
+  zShape3D *tess;        /* primitive shapes converted to polyhedra */
+  zPH3DBVH *bvh;         /* hierarchies of faces of polyhedra */
+  zSDF3D *sdf;
+} _zSDF3DBake;
+
+/* prepare polyhedra to measure signed distances from shapes. */
+static bool _zSDF3DBakeInit(_zSDF3DBake *bake, const zShape3D *shape, int num, zSDF3D *sdf)
+{
+  int i;
+
+  bake->shape = shape;
+  bake->num = num;
+  bake->sdf = sdf;
+  bake->tess = zAlloc( zShape3D, num );
+  bake->bvh = zAlloc( zPH3DBVH, num );
+  if( !bake->tess || !bake->bvh ){
+    ZALLOCERROR();
+    zFree( bake->tess );
+    zFree( bake->bvh );
+    bake->num = 0;
+    return false;
+  }
+  for( i=0; i<num; i++ ){
+    zShape3DInit( &bake->tess[i] );
+    zPH3DBVHInit( &bake->bvh[i] );
+  }
+  for( i=0; i<num; i++ ){
+    if( shape[i].com == &zeo_shape3d_nurbs_com ) continue;
+    if( shape[i].com == &zeo_shape3d_ph_com ){
+      if( !zPH3DBVHCreate( &bake->bvh[i], zShape3DPH(&shape[i]), 0 ) ) return false;
+      continue;
+    }
+    if( !zShape3DClone( &shape[i], &bake->tess[i], NULL ) || !zShape3DToPH( &bake->tess[i] ) ||
+        !zPH3DBVHCreate( &bake->bvh[i], zShape3DPH(&bake->tess[i]), 0 ) ) return false;
+  }
+  return true;
+}
+
+/* destroy polyhedra to measure signed distances. */
+static void _zSDF3DBakeDestroy(_zSDF3DBake *bake)
+{
+  int i;
+
+  for( i=0; i<bake->num; i++ ){
+    zPH3DBVHDestroy( &bake->bvh[i] );
+    if( bake->tess[i].com ) zShape3DDestroy( &bake->tess[i] );
+  }
+  zFree( bake->tess );
+  zFree( bake->bvh );
+}
+
+/* signed distance from a point to a shape. */
+static double _zSDF3DBakeShapeDist(_zSDF3DBake *bake, int i, const zVec3D *point)
+{
+  const zShape3D *shape;
+
+  shape = &bake->shape[i];
+  if( shape->com == &zeo_shape3d_ph_com )
+    return zPH3DBVHSignedDistFromPoint( &bake->bvh[i], point );
+  if( shape->com != &zeo_shape3d_nurbs_com && zShape3DPointIsInside( shape, point, 0 ) )
+    return -zPH3DBVHDistFromPoint( &bake->bvh[i], point );
+  return fabs( zShape3DDistFromPoint( shape, point ) );
+}
+
+/* evaluate signed distances at a chunk of grid points. */
+static void _zSDF3DBakeChunk(void *util, int id, int start, int end)
+{
+  _zSDF3DBake *bake;
+  zSDF3D *sdf;
+  zVec3D p;
+  double d, dmin;
+  int n, i;
+
+  bake = (_zSDF3DBake *)util;
+  sdf = bake->sdf;
+  for( n=start; n<end; n++ ){
+    zVec3DCreate( &p,
+      sdf->origin.c.x + sdf->pitch * ( n % sdf->num[zX] ),
+      sdf->origin.c.y + sdf->pitch * ( ( n / sdf->num[zX] ) % sdf->num[zY] ),
+      sdf->origin.c.z + sdf->pitch * ( n / ( sdf->num[zX] * sdf->num[zY] ) ) );
+    for( dmin=HUGE_VAL, i=0; i<bake->num; i++ )
+      if( ( d = _zSDF3DBakeShapeDist( bake, i, &p ) ) < dmin ) dmin = d;
+    sdf->val[n] = dmin;
+  }
+}
+
+/* bake a signed distance field of an array of shapes. */
+static zSDF3D *_zSDF3DBake(zSDF3D *sdf, const zShape3D *shape, int num, double pitch, double margin, int thread_num)
+{
+  _zSDF3DBake bake;
+  zAABox3D box, b;
+  zAxis axis;
+  double d;
+  int i, n[3];
+  bool ret;
+
+  zSDF3DInit( sdf );
+  if( !( pitch > 0 ) ){
+    ZRUNERROR( ZEO_ERR_SDF3D_INVALID_PITCH, pitch );
+    return NULL;
+  }
+  for( ret=false, i=0; i<num; i++ ){
+    if( !zShape3DAABB( &shape[i], &b ) ) continue;
+    if( ret ) zAABox3DMerge( &box, &box, &b );
+    else{
+      zAABox3DCopy( &b, &box );
+      ret = true;
+    }
+  }
+  if( !ret ){
+    ZRUNERROR( ZEO_ERR_SDF3D_EMPTY );
+    return NULL;
+  }
+  if( margin > 0 ) zAABox3DExpandDRC( &box, margin );
+  for( axis=zX; axis<=zZ; axis++ ){
+    if( ( d = ceil( ( box.max.e[(int)axis] - box.min.e[(int)axis] ) / pitch ) + 1 ) > INT_MAX ){
+      ZRUNERROR( ZEO_ERR_SDF3D_INVALID_PITCH, pitch );
+      return NULL;
+    }
+    n[(int)axis] = _zMax( (int)d, 2 );
+  }
+  if( !zSDF3DAlloc( sdf, &box.min, pitch, n[zX], n[zY], n[zZ] ) ) return NULL;
+  if( !( ret = _zSDF3DBakeInit( &bake, shape, num, sdf ) ) ) goto TERMINATE;
+  zParallelFor( n[zX]*n[zY]*n[zZ], thread_num, _zSDF3DBakeChunk, &bake );
+ TERMINATE:
+  _zSDF3DBakeDestroy( &bake );
+  if( !ret ){
+    zSDF3DDestroy( sdf );
+    return NULL;
+  }
+  return sdf;
+}
+
+/* bake a signed distance field of a 3D shape. */
+zSDF3D *zSDF3DFromShape3D(zSDF3D *sdf, const zShape3D *shape, double pitch, double margin, int thread_num)
+{
+  return _zSDF3DBake( sdf, shape, 1, pitch, margin, thread_num );
+}
+
+/* bake a signed distance field of multiple 3D shapes. */
+zSDF3D *zSDF3DFromMultiShape3D(zSDF3D *sdf, const zMultiShape3D *ms, double pitch, double margin, int thread_num)
+{
+  return _zSDF3DBake( sdf, zMultiShape3DShapeBuf(ms), zMultiShape3DShapeNum(ms), pitch, margin, thread_num );
+}
+
+/* lookup */
+
+/* trilinear interpolation of a signed distance field. */
+static double _zSDF3DInterp(const zSDF3D *sdf, const zVec3D *point, zVec3D *grad)
+{
+  zVec3D q;
+  double x, u[3], c[8], c00, c10, c01, c11, c0, c1, d, ex;
+  bool clamped[3];
+  int idx[3], n;
+  zAxis axis;
+
+  if( !sdf->val ){
+    if( grad ) zVec3DZero( grad );
+    return HUGE_VAL;
+  }
+  for( axis=zX; axis<=zZ; axis++ ){
+    x = ( point->e[(int)axis] - sdf->origin.e[(int)axis] ) / sdf->pitch;
+    clamped[(int)axis] = true;
+    if( x < 0 ) x = 0;
+    else if( x > sdf->num[(int)axis] - 1 ) x = sdf->num[(int)axis] - 1;
+    else clamped[(int)axis] = false;
+    q.e[(int)axis] = sdf->origin.e[(int)axis] + x * sdf->pitch;
+    idx[(int)axis] = _zMin( (int)x, sdf->num[(int)axis] - 2 );
+    u[(int)axis] = x - idx[(int)axis];
+  }
+  for( n=0; n<8; n++ )
+    c[n] = zSDF3DVal( sdf, idx[zX]+(n&1), idx[zY]+((n>>1)&1), idx[zZ]+((n>>2)&1) );
+  c00 = c[0] + ( c[1] - c[0] ) * u[zX];
+  c10 = c[2] + ( c[3] - c[2] ) * u[zX];
+  c01 = c[4] + ( c[5] - c[4] ) * u[zX];
+  c11 = c[6] + ( c[7] - c[6] ) * u[zX];
+  c0 = c00 + ( c10 - c00 ) * u[zY];
+  c1 = c01 + ( c11 - c01 ) * u[zY];
+  d = c0 + ( c1 - c0 ) * u[zZ];
+  if( grad ){
+    grad->c.x = ( ( ( c[1] - c[0] ) * ( 1 - u[zY] ) + ( c[3] - c[2] ) * u[zY] ) * ( 1 - u[zZ] )
+                + ( ( c[5] - c[4] ) * ( 1 - u[zY] ) + ( c[7] - c[6] ) * u[zY] ) * u[zZ] ) / sdf->pitch;
+    grad->c.y = ( ( c10 - c00 ) * ( 1 - u[zZ] ) + ( c11 - c01 ) * u[zZ] ) / sdf->pitch;
+    grad->c.z = ( c1 - c0 ) / sdf->pitch;
+  }
+  if( !zIsTiny( ex = zVec3DDist( point, &q ) ) ){ /* out of the grid */
+    d += ex;
+    if( grad )
+      for( axis=zX; axis<=zZ; axis++ )
+        if( clamped[(int)axis] ) grad->e[(int)axis] = ( point->e[(int)axis] - q.e[(int)axis] ) / ex;
+  }
+  return d;
+}
+
+/* signed distance at a point in a signed distance field. */
+double zSDF3DDist(const zSDF3D *sdf, const zVec3D *point)
+{
+  return _zSDF3DInterp( sdf, point, NULL );
+}
+
+/* signed distance and its gradient at a point in a signed distance field. */
+double zSDF3DGrad(const zSDF3D *sdf, const zVec3D *point, zVec3D *grad)
+{
+  return _zSDF3DInterp( sdf, point, grad );
+}
+
+/* binary file I/O */
+
+#define ZEO_SDF3D_ID_SIZE 8
+static const char __zeo_sdf3d_id[ZEO_SDF3D_ID_SIZE] = "ZSDF3D";
+
+/* write a signed distance field to a binary file. */
+bool zSDF3DFWrite(FILE *fp, const zSDF3D *sdf)
+{
+  int32_t num[3];
+  size_t size;
+
+  num[0] = sdf->num[zX]; num[1] = sdf->num[zY]; num[2] = sdf->num[zZ];
+  size = (size_t)num[0] * num[1] * num[2];
+  return fwrite( __zeo_sdf3d_id, sizeof(char), ZEO_SDF3D_ID_SIZE, fp ) == ZEO_SDF3D_ID_SIZE &&
+         fwrite( num, sizeof(int32_t), 3, fp ) == 3 &&
+         fwrite( sdf->origin.e, sizeof(double), 3, fp ) == 3 &&
+         fwrite( &sdf->pitch, sizeof(double), 1, fp ) == 1 &&
+         fwrite( sdf->val, sizeof(double), size, fp ) == size ? true : false;
+}
+
+/* read a signed distance field from a binary file. */
+zSDF3D *zSDF3DFRead(FILE *fp, zSDF3D *sdf)
+{
+  char id[ZEO_SDF3D_ID_SIZE];
+  int32_t num[3];
+  zVec3D origin;
+  double pitch;
+  size_t size;
+
+  zSDF3DInit( sdf );
+  if( fread( id, sizeof(char), ZEO_SDF3D_ID_SIZE, fp ) < ZEO_SDF3D_ID_SIZE ||
+      memcmp( id, __zeo_sdf3d_id, ZEO_SDF3D_ID_SIZE ) != 0 ){
+    ZRUNERROR( ZEO_ERR_SDF3D_UNREADABLE );
+    return NULL;
+  }
+  if( fread( num, sizeof(int32_t), 3, fp ) < 3 ||
+      fread( origin.e, sizeof(double), 3, fp ) < 3 ||
+      fread( &pitch, sizeof(double), 1, fp ) < 1 ){
+    ZRUNERROR( ZEO_ERR_SDF3D_INCOMPLETE );
+    return NULL;
+  }
+  if( !zSDF3DAlloc( sdf, &origin, pitch, num[0], num[1], num[2] ) ) return NULL;
+  size = (size_t)num[0] * num[1] * num[2];
+  if( fread( sdf->val, sizeof(double), size, fp ) < size ){
+    ZRUNERROR( ZEO_ERR_SDF3D_INCOMPLETE );
+    zSDF3DDestroy( sdf );
+    return NULL;
+  }
+  return sdf;
+}
+
+/* write a signed distance field to a binary file. */
+bool zSDF3DWriteFile(const zSDF3D *sdf, const char filename[])
+{
+  FILE *fp;
+  bool ret;
+
+  if( !( fp = fopen( filename, "wb" ) ) ){
+    ZOPENERROR( filename );
+    return false;
+  }
+  ret = zSDF3DFWrite( fp, sdf );
+  fclose( fp );
+  return ret;
+}
+
+/* read a signed distance field from a binary file. */
+zSDF3D *zSDF3DReadFile(zSDF3D *sdf, const char filename[])
+{
+  FILE *fp;
+  zSDF3D *ret;
+
+  if( !( fp = fopen( filename, "rb" ) ) ){ /* "rb" mode specifier is required for Windows. */
+    ZOPENERROR( filename );
+    return NULL;
+  }
+  ret = zSDF3DFRead( fp, sdf );
+  fclose( fp );
+  return ret;
+}
@@ -110,6 +110,37 @@ bool zShape3DPointIsInside(const zShape3D *shape, const zVec3D *point, double ma
   return shape->com->_pointisinside( shape->body, point, margin );
 }
 
+/* support map of a 3D shape. */
+zVec3D *zShape3DSupportMap(const zShape3D *shape, const zVec3D *dir, zVec3D *sp)
+{
+  return shape->com->_supportmap( shape->body, dir, sp );
+}
+
+/* axis-aligned bounding box of a 3D shape. */
+zAABox3D *zShape3DAABB(const zShape3D *shape, zAABox3D *box)
+{
+  zVec3D dir, sp;
+  zAxis axis;
+
+  zAABox3DInit( box );
+  for( axis=zX; axis<=zZ; axis++ ){
+    zVec3DZero( &dir );
+    dir.e[(int)axis] = -1;
+    if( !zShape3DSupportMap( shape, &dir, &sp ) ) return NULL;
+    box->min.e[(int)axis] = sp.e[(int)axis];
+    dir.e[(int)axis] = 1;
+    if( !zShape3DSupportMap( shape, &dir, &sp ) ) return NULL;
+    box->max.e[(int)axis] = sp.e[(int)axis];
+  }
+  return box;
+}
+
+/* ray casting against a 3D shape. */
+bool zShape3DRaycast(const zShape3D *shape, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  return shape->com->_raycast( shape->body, org, dir, tmax, t, normal );
+}
+
 /* volume of a 3D shape. */
 double zShape3DVolume(const zShape3D *shape)
 {
@@ -122,6 +122,10 @@ static double _zShape3DBoxDistFromPoint(void *body, const zVec3D *p){
   return zBox3DDistFromPoint( (zBox3D*)body, p ); }
 static bool _zShape3DBoxPointIsInside(void *body, const zVec3D *p, double margin){
   return zBox3DPointIsInside( (zBox3D*)body, p, margin ); }
+static zVec3D *_zShape3DBoxSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  return zBox3DSupportMap( (zBox3D*)body, dir, sp ); }
+static bool _zShape3DBoxRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  return zBox3DRaycast( (zBox3D*)body, org, dir, tmax, t, normal ); }
 static double _zShape3DBoxVolume(void *body){
   return zBox3DVolume( (zBox3D*)body ); }
 static zVec3D *_zShape3DBoxBarycenter(void *body, zVec3D *c){
@@ -150,6 +154,8 @@ zShape3DCom zeo_shape3d_box_com = {
   _zShape3DBoxClosest,
   _zShape3DBoxDistFromPoint,
   _zShape3DBoxPointIsInside,
+  _zShape3DBoxSupportMap,
+  _zShape3DBoxRaycast,
   _zShape3DBoxVolume,
   _zShape3DBoxBarycenter,
   _zShape3DBoxBaryInertiaMass,
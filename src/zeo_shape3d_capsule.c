@@ -70,6 +70,67 @@ bool zCapsule3DPointIsInside(const zCapsule3D *capsule, const zVec3D *point, dou
   return zCapsule3DDistFromPoint( capsule, point ) < margin ? true : false;
 }
 
+/* support map of a capsule. */
+zVec3D *zCapsule3DSupportMap(const zCapsule3D *capsule, const zVec3D *dir, zVec3D *sp)
+{
+  zVec3D axis;
+  double l;
+
+  zCapsule3DAxis( capsule, &axis );
+  zVec3DCopy( zCapsule3DCenter( capsule, zVec3DInnerProd( &axis, dir ) >= 0 ? 1 : 0 ), sp );
+  if( zIsTiny( ( l = zVec3DNorm( dir ) ) ) ) return sp;
+  return zVec3DCatDRC( sp, zCapsule3DRadius(capsule)/l, dir );
+}
+
+/* ray casting on a 3D capsule. */
+bool zCapsule3DRaycast(const zCapsule3D *capsule, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  zVec3D u, w, wp, dp, oc, q;
+  double l, wu, du, s[2], h;
+  int i, j, num;
+  bool ret = false;
+
+  zCyl3DAxis( capsule, &u );
+  if( zIsTiny( ( l = zVec3DNorm( &u ) ) ) ) return false;
+  zVec3DDivDRC( &u, l );
+  zVec3DSub( org, zCyl3DCenter(capsule,0), &w );
+  wu = zVec3DInnerProd( &w, &u );
+  du = zVec3DInnerProd( dir, &u );
+  zVec3DCat( &w, -wu, &u, &wp ); /* radial components */
+  zVec3DCat( dir, -du, &u, &dp );
+  /* side */
+  num = zQuadraticRealRoots( zVec3DSqrNorm(&dp), zVec3DInnerProd(&wp,&dp), zVec3DSqrNorm(&wp) - zSqr(zCyl3DRadius(capsule)), s );
+  for( i=0; i<num; i++ ){
+    if( s[i] < 0 || s[i] > tmax ) continue;
+    if( ( h = wu + s[i] * du ) < 0 || h > l ) continue;
+    tmax = *t = s[i];
+    if( normal ){
+      zVec3DCat( &wp, s[i], &dp, &q );
+      zVec3DDiv( &q, zCyl3DRadius(capsule), normal );
+    }
+    ret = true;
+    break;
+  }
+  /* hemispheres at both ends */
+  for( j=0; j<2; j++ ){
+    zVec3DSub( org, zCyl3DCenter(capsule,j), &oc );
+    num = zQuadraticRealRoots( zVec3DSqrNorm(dir), zVec3DInnerProd(&oc,dir), zVec3DSqrNorm(&oc) - zSqr(zCyl3DRadius(capsule)), s );
+    for( i=0; i<num; i++ ){
+      if( s[i] < 0 || s[i] > tmax ) continue;
+      h = wu + s[i] * du;
+      if( ( j == 0 && h > 0 ) || ( j == 1 && h < l ) ) continue;
+      tmax = *t = s[i];
+      if( normal ){
+        zVec3DCat( &oc, s[i], dir, &q );
+        zVec3DDiv( &q, zCyl3DRadius(capsule), normal );
+      }
+      ret = true;
+      break;
+    }
+  }
+  return ret;
+}
+
 /* height of a 3D capsule. */
 double zCapsule3DHeight(const zCapsule3D *capsule)
 {
@@ -241,6 +302,10 @@ static double _zShape3DCapsuleDistFromPoint(void *body, const zVec3D *p){
   return zCapsule3DDistFromPoint( (zCapsule3D*)body, p ); }
 static bool _zShape3DCapsulePointIsInside(void *body, const zVec3D *p, double margin){
   return zCapsule3DPointIsInside( (zCapsule3D*)body, p, margin ); }
+static zVec3D *_zShape3DCapsuleSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  return zCapsule3DSupportMap( (zCapsule3D*)body, dir, sp ); }
+static bool _zShape3DCapsuleRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  return zCapsule3DRaycast( (zCapsule3D*)body, org, dir, tmax, t, normal ); }
 static double _zShape3DCapsuleVolume(void *body){
   return zCapsule3DVolume( (zCapsule3D*)body ); }
 static zVec3D *_zShape3DCapsuleBarycenter(void *body, zVec3D *c){
@@ -269,6 +334,8 @@ zShape3DCom zeo_shape3d_capsule_com = {
   _zShape3DCapsuleClosest,
   _zShape3DCapsuleDistFromPoint,
   _zShape3DCapsulePointIsInside,
+  _zShape3DCapsuleSupportMap,
+  _zShape3DCapsuleRaycast,
   _zShape3DCapsuleVolume,
   _zShape3DCapsuleBarycenter,
   _zShape3DCapsuleBaryInertiaMass,
@@ -152,6 +152,62 @@ bool zCone3DPointIsInside(const zCone3D *cone, const zVec3D *point, double margi
   return zVec2DInnerProd( &l2d, &p2d ) < margin ? true : false;
 }
 
+/* support map of a cone. */
+zVec3D *zCone3DSupportMap(const zCone3D *cone, const zVec3D *dir, zVec3D *sp)
+{
+  zVec3D axis, r;
+  double l;
+
+  zCone3DAxis( cone, &axis );
+  zVec3DCopy( zCone3DCenter(cone), sp );
+  if( zVec3DOrthogonalize( dir, &axis, &r ) && !zIsTiny( ( l = zVec3DNorm( &r ) ) ) )
+    zVec3DCatDRC( sp, zCone3DRadius(cone)/l, &r );
+  return zVec3DInnerProd( zCone3DVert(cone), dir ) > zVec3DInnerProd( sp, dir ) ?
+    zVec3DCopy( zCone3DVert(cone), sp ) : sp;
+}
+
+/* ray casting on a 3D cone. */
+bool zCone3DRaycast(const zCone3D *cone, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  zVec3D u, w, q, n;
+  double l, k, wu, du, s[2], h;
+  int i, num;
+  bool ret = false;
+
+  zCone3DAxis( cone, &u );
+  if( zIsTiny( ( l = zVec3DNorm( &u ) ) ) ) return false;
+  zVec3DDivDRC( &u, l );
+  k = zCone3DRadius(cone) / l;
+  zVec3DSub( org, zCone3DCenter(cone), &w );
+  wu = zVec3DInnerProd( &w, &u );
+  du = zVec3DInnerProd( dir, &u );
+  /* side: |q|^2 - (q.u)^2 = k^2 (l - q.u)^2 for q = w + t dir */
+  num = zQuadraticRealRoots(
+    zVec3DSqrNorm(dir) - du*du - k*k*du*du,
+    zVec3DInnerProd(&w,dir) - wu*du + k*k*(l-wu)*du,
+    zVec3DSqrNorm(&w) - wu*wu - k*k*(l-wu)*(l-wu), s );
+  for( i=0; i<num; i++ ){
+    if( s[i] < 0 || s[i] > tmax ) continue;
+    if( ( h = wu + s[i] * du ) < 0 || h > l ) continue;
+    tmax = *t = s[i];
+    if( normal ){
+      zVec3DCat( &w, s[i], dir, &q );
+      zVec3DCat( &q, -h + k*k*(l-h), &u, &n ); /* gradient of the implicit function */
+      zVec3DNormalize( &n, normal );
+    }
+    ret = true;
+    break;
+  }
+  /* base */
+  if( zIsTiny( du ) ) return ret;
+  if( ( s[0] = -wu / du ) < 0 || s[0] > tmax ) return ret;
+  zVec3DCat( &w, s[0], dir, &q );
+  if( zVec3DSqrNorm( &q ) > zSqr(zCone3DRadius(cone)) ) return ret;
+  *t = s[0];
+  if( normal ) zVec3DRev( &u, normal );
+  return true;
+}
+
 /* height of a 3D cone. */
 double zCone3DHeight(const zCone3D *cone)
 {
@@ -304,6 +360,10 @@ static double _zShape3DConeDistFromPoint(void *body, const zVec3D *p){
   return zCone3DDistFromPoint( (zCone3D*)body, p ); }
 static bool _zShape3DConePointIsInside(void *body, const zVec3D *p, double margin){
   return zCone3DPointIsInside( (zCone3D*)body, p, margin ); }
+static zVec3D *_zShape3DConeSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  return zCone3DSupportMap( (zCone3D*)body, dir, sp ); }
+static bool _zShape3DConeRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  return zCone3DRaycast( (zCone3D*)body, org, dir, tmax, t, normal ); }
 static double _zShape3DConeVolume(void *body){
   return zCone3DVolume( (zCone3D*)body ); }
 static zVec3D *_zShape3DConeBarycenter(void *body, zVec3D *c){
@@ -332,6 +392,8 @@ zShape3DCom zeo_shape3d_cone_com = {
   _zShape3DConeClosest,
   _zShape3DConeDistFromPoint,
   _zShape3DConePointIsInside,
+  _zShape3DConeSupportMap,
+  _zShape3DConeRaycast,
   _zShape3DConeVolume,
   _zShape3DConeBarycenter,
   _zShape3DConeBaryInertiaMass,
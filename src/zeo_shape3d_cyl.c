@@ -132,6 +132,65 @@ bool zCyl3DPointIsInside(const zCyl3D *cyl, const zVec3D *point, double margin)
   return d > -margin && d < l + margin ? true : false;
 }
 
+/* support map of a cylinder. */
+zVec3D *zCyl3DSupportMap(const zCyl3D *cyl, const zVec3D *dir, zVec3D *sp)
+{
+  zVec3D axis, r;
+  double l;
+
+  zCyl3DAxis( cyl, &axis );
+  zVec3DCopy( zCyl3DCenter( cyl, zVec3DInnerProd( &axis, dir ) >= 0 ? 1 : 0 ), sp );
+  if( !zVec3DOrthogonalize( dir, &axis, &r ) || zIsTiny( ( l = zVec3DNorm( &r ) ) ) ) return sp;
+  return zVec3DCatDRC( sp, zCyl3DRadius(cyl)/l, &r );
+}
+
+/* ray casting on a 3D cylinder. */
+bool zCyl3DRaycast(const zCyl3D *cyl, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  zVec3D u, w, wp, dp, q;
+  double l, wu, du, s[2], h;
+  int i, num;
+  bool ret = false;
+
+  zCyl3DAxis( cyl, &u );
+  if( zIsTiny( ( l = zVec3DNorm( &u ) ) ) ) return false;
+  zVec3DDivDRC( &u, l );
+  zVec3DSub( org, zCyl3DCenter(cyl,0), &w );
+  wu = zVec3DInnerProd( &w, &u );
+  du = zVec3DInnerProd( dir, &u );
+  zVec3DCat( &w, -wu, &u, &wp ); /* radial components */
+  zVec3DCat( dir, -du, &u, &dp );
+  /* side */
+  num = zQuadraticRealRoots( zVec3DSqrNorm(&dp), zVec3DInnerProd(&wp,&dp), zVec3DSqrNorm(&wp) - zSqr(zCyl3DRadius(cyl)), s );
+  for( i=0; i<num; i++ ){
+    if( s[i] < 0 || s[i] > tmax ) continue;
+    if( ( h = wu + s[i] * du ) < 0 || h > l ) continue;
+    tmax = *t = s[i];
+    if( normal ){
+      zVec3DCat( &wp, s[i], &dp, &q );
+      zVec3DDiv( &q, zCyl3DRadius(cyl), normal );
+    }
+    ret = true;
+    break;
+  }
+  /* caps */
+  if( zIsTiny( du ) ) return ret;
+  for( i=0; i<2; i++ ){
+    if( ( s[0] = ( i * l - wu ) / du ) < 0 || s[0] > tmax ) continue;
+    zVec3DCat( &wp, s[0], &dp, &q );
+    if( zVec3DSqrNorm( &q ) > zSqr(zCyl3DRadius(cyl)) ) continue;
+    tmax = *t = s[0];
+    if( normal ){
+      if( i == 0 )
+        zVec3DRev( &u, normal );
+      else
+        zVec3DCopy( &u, normal );
+    }
+    ret = true;
+  }
+  return ret;
+}
+
 /* height of a 3D cylinder. */
 double zCyl3DHeight(const zCyl3D *cyl)
 {
@@ -283,6 +342,10 @@ static double _zShape3DCylDistFromPoint(void *body, const zVec3D *p){
   return zCyl3DDistFromPoint( (zCyl3D*)body, p ); }
 static bool _zShape3DCylPointIsInside(void *body, const zVec3D *p, double margin){
   return zCyl3DPointIsInside( (zCyl3D*)body, p, margin ); }
+static zVec3D *_zShape3DCylSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  return zCyl3DSupportMap( (zCyl3D*)body, dir, sp ); }
+static bool _zShape3DCylRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  return zCyl3DRaycast( (zCyl3D*)body, org, dir, tmax, t, normal ); }
 static double _zShape3DCylVolume(void *body){
   return zCyl3DVolume( (zCyl3D*)body ); }
 static zVec3D *_zShape3DCylBarycenter(void *body, zVec3D *c){
@@ -311,6 +374,8 @@ zShape3DCom zeo_shape3d_cyl_com = {
   _zShape3DCylClosest,
   _zShape3DCylDistFromPoint,
   _zShape3DCylPointIsInside,
+  _zShape3DCylSupportMap,
+  _zShape3DCylRaycast,
   _zShape3DCylVolume,
   _zShape3DCylBarycenter,
   _zShape3DCylBaryInertiaMass,
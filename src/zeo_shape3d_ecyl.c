@@ -147,6 +147,73 @@ bool zECyl3DPointIsInside(const zECyl3D *ecyl, const zVec3D *point, double margi
   return zEllips2DPointIsInside( &ellips2d, (zVec2D*)vs.e, margin );
 }
 
+/* support map of an elliptic cylinder. */
+zVec3D *zECyl3DSupportMap(const zECyl3D *ecyl, const zVec3D *dir, zVec3D *sp)
+{
+  zVec3D axis;
+  double d0, d1, l;
+
+  zECyl3DAxis( ecyl, &axis );
+  zVec3DCopy( zECyl3DCenter( ecyl, zVec3DInnerProd( &axis, dir ) >= 0 ? 1 : 0 ), sp );
+  d0 = zECyl3DRadius(ecyl,0) * zVec3DInnerProd( zECyl3DRadVec(ecyl,0), dir );
+  d1 = zECyl3DRadius(ecyl,1) * zVec3DInnerProd( zECyl3DRadVec(ecyl,1), dir );
+  if( zIsTiny( ( l = sqrt( d0*d0 + d1*d1 ) ) ) ) return sp;
+  zVec3DCatDRC( sp, zECyl3DRadius(ecyl,0)*d0/l, zECyl3DRadVec(ecyl,0) );
+  return zVec3DCatDRC( sp, zECyl3DRadius(ecyl,1)*d1/l, zECyl3DRadVec(ecyl,1) );
+}
+
+/* ray casting on a 3D elliptic cylinder. */
+bool zECyl3DRaycast(const zECyl3D *ecyl, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  zVec3D u, w, n;
+  double l, wu, du, w0, w1, d0, d1, s[2], x, y;
+  int i, num;
+  bool ret = false;
+
+  zECyl3DAxis( ecyl, &u );
+  if( zIsTiny( ( l = zVec3DNorm( &u ) ) ) ) return false;
+  zVec3DDivDRC( &u, l );
+  zVec3DSub( org, zECyl3DCenter(ecyl,0), &w );
+  wu = zVec3DInnerProd( &w, &u );
+  du = zVec3DInnerProd( dir, &u );
+  /* radial components normalized by radii */
+  w0 = zVec3DInnerProd( &w, zECyl3DRadVec(ecyl,0) ) / zECyl3DRadius(ecyl,0);
+  w1 = zVec3DInnerProd( &w, zECyl3DRadVec(ecyl,1) ) / zECyl3DRadius(ecyl,1);
+  d0 = zVec3DInnerProd( dir, zECyl3DRadVec(ecyl,0) ) / zECyl3DRadius(ecyl,0);
+  d1 = zVec3DInnerProd( dir, zECyl3DRadVec(ecyl,1) ) / zECyl3DRadius(ecyl,1);
+  /* side */
+  num = zQuadraticRealRoots( d0*d0 + d1*d1, w0*d0 + w1*d1, w0*w0 + w1*w1 - 1, s );
+  for( i=0; i<num; i++ ){
+    if( s[i] < 0 || s[i] > tmax ) continue;
+    if( wu + s[i] * du < 0 || wu + s[i] * du > l ) continue;
+    tmax = *t = s[i];
+    if( normal ){
+      x = ( w0 + s[i] * d0 ) / zECyl3DRadius(ecyl,0);
+      y = ( w1 + s[i] * d1 ) / zECyl3DRadius(ecyl,1);
+      zVec3DMul( zECyl3DRadVec(ecyl,0), x, &n );
+      zVec3DCatDRC( &n, y, zECyl3DRadVec(ecyl,1) );
+      zVec3DNormalize( &n, normal );
+    }
+    ret = true;
+    break;
+  }
+  /* caps */
+  if( zIsTiny( du ) ) return ret;
+  for( i=0; i<2; i++ ){
+    if( ( s[0] = ( i * l - wu ) / du ) < 0 || s[0] > tmax ) continue;
+    if( zSqr( w0 + s[0] * d0 ) + zSqr( w1 + s[0] * d1 ) > 1 ) continue;
+    tmax = *t = s[0];
+    if( normal ){
+      if( i == 0 )
+        zVec3DRev( &u, normal );
+      else
+        zVec3DCopy( &u, normal );
+    }
+    ret = true;
+  }
+  return ret;
+}
+
 /* height of a 3D elliptic cylinder. */
 double zECyl3DHeight(const zECyl3D *cyl)
 {
@@ -317,6 +384,10 @@ static double _zShape3DECylDistFromPoint(void *body, const zVec3D *p){
   return zECyl3DDistFromPoint( (zECyl3D*)body, p ); }
 static bool _zShape3DECylPointIsInside(void *body, const zVec3D *p, double margin){
   return zECyl3DPointIsInside( (zECyl3D*)body, p, margin ); }
+static zVec3D *_zShape3DECylSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  return zECyl3DSupportMap( (zECyl3D*)body, dir, sp ); }
+static bool _zShape3DECylRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  return zECyl3DRaycast( (zECyl3D*)body, org, dir, tmax, t, normal ); }
 static double _zShape3DECylVolume(void *body){
   return zECyl3DVolume( (zECyl3D*)body ); }
 static zVec3D *_zShape3DECylBarycenter(void *body, zVec3D *c){
@@ -345,6 +416,8 @@ zShape3DCom zeo_shape3d_ecyl_com = {
   _zShape3DECylClosest,
   _zShape3DECylDistFromPoint,
   _zShape3DECylPointIsInside,
+  _zShape3DECylSupportMap,
+  _zShape3DECylRaycast,
   _zShape3DECylVolume,
   _zShape3DECylBarycenter,
   _zShape3DECylBaryInertiaMass,
@@ -81,58 +81,105 @@ zEllips3D *zEllips3DXformInv(const zEllips3D *src, const zFrame3D *f, zEllips3D
   return dest;
 }
 
-/* the closest point from a 3D point to an aligned 3D ellipsoid. */
-static zVec3D *_zEllips3DClosest(double rx, double ry, double rz, const zVec3D *v, zVec3D *cp)
+/* the closest point from a 3D point outside of an aligned 3D ellipsoid. */
+static zVec3D *_zEllips3DClosest(const zVec3D *radius, const zVec3D *v, zVec3D *cp)
 {
-  double a, b, c, p, q, r, p2, q2, r2, pqr, l;
-  zPex pex;
-  zCVec ans;
-  int i;
-
-  a = zSqr( v->e[zX] / rx );
-  b = zSqr( v->e[zY] / ry );
-  c = zSqr( v->e[zZ] / rz );
-  p = rx * rx; p2 = p * p;
-  q = ry * ry; q2 = q * q;
-  r = rz * rz; r2 = r * r; pqr = p * q * r;
-  pex = zPexAlloc( 6 );
-  ans = zCVecAlloc( 6 );
-  if( !pex || !ans ) return NULL;
-  zPexSetCoeff( pex, 6, 1 );
-  zPexSetCoeff( pex, 5, 2*(p+q+r) );
-  zPexSetCoeff( pex, 4, (1-a)*p2 + (1-c)*r2 + (1-b)*q2 + 4*(p*q+q*r+r*p) );
-  zPexSetCoeff( pex, 3, 2*(1-a)*(q+r)*p2 + 2*(1-b)*(r+p)*q2 + 2*(1-c)*(p+q)*r2 + 8*p*q*r );
-  zPexSetCoeff( pex, 2, (1-b-a)*p2*q2 + (1-a-c)*p2*r2 + (1-c-b)*q2*r2 + 4*pqr*( (1-a)*p + (1-b)*q + (1-c)*r ) );
-  zPexSetCoeff( pex, 1, 2*pqr*( (1-b-a)*p*q + (1-a-c)*r*p + (1-c-b)*q*r ) );
-  zPexSetCoeff( pex, 0, (1-a-b-c)*pqr*pqr );
-  zPexBH( pex, ans, zTOL, 0 );
-  zPexFree( pex );
-
-  for( i=0; i<6; i++ )
-    if( ( l = zCVecElemNC(ans,i)->re ) >= 0 ) break;
-  if( i == 6 || !zIsTiny( zCVecElemNC(ans,i)->im ) ){
-    ZRUNERROR( ZEO_ERR_FATAL );
-    return NULL;
+  double r2[3], g[3], t = 0, tmax, f, df, s, dt;
+  int i, k, iter = 0;
+
+  /* the closest point is r2[k]*v[k]/(t+r2[k]) for the root t of
+   * f(t) = sum_k ( g[k]/(t+r2[k]) )^2 - 1, g[k] = radius[k]*v[k],
+   * which is decreasing and convex for t>=0. Newton's method from t=0,
+   * where f>0, monotonically converges to the root without overshoot. */
+  for( k=0; k<3; k++ ){
+    r2[k] = zSqr( radius->e[k] );
+    g[k] = radius->e[k] * v->e[k];
   }
-  zCVecFree( ans );
-  zVec3DCreate( cp, v->e[zX]/(1+l/p), v->e[zY]/(1+l/q), v->e[zZ]/(1+l/r) );
+  tmax = sqrt( zSqr(g[0]) + zSqr(g[1]) + zSqr(g[2]) ); /* f(tmax)<=0 */
+  ZITERINIT( iter );
+  for( i=0; i<iter; i++ ){
+    for( f=-1, df=0, k=0; k<3; k++ ){
+      s = zSqr( g[k] / ( t + r2[k] ) );
+      f += s;
+      df -= 2 * s / ( t + r2[k] );
+    }
+    if( f <= 0 || df == 0 ) break;
+    if( ( t += ( dt = -f / df ) ) >= tmax ){
+      t = tmax;
+      break;
+    }
+    if( dt <= zTOL * ( 1 + t ) ) break;
+  }
+  for( k=0; k<3; k++ )
+    cp->e[k] = r2[k] * v->e[k] / ( t + r2[k] );
   return cp;
 }
 
+/* the closest point from a 3D point to an aligned 3D ellipsoid. */
+static double _zEllips3DClosestAligned(const zVec3D *radius, const zVec3D *v, zVec3D *cp)
+{
+  if( zSqr( v->c.x / ( radius->c.x + zTOL ) )
+    + zSqr( v->c.y / ( radius->c.y + zTOL ) )
+    + zSqr( v->c.z / ( radius->c.z + zTOL ) ) < 1 ){
+    zVec3DCopy( v, cp );
+    return 0;
+  }
+  _zEllips3DClosest( radius, v, cp );
+  return zVec3DDist( v, cp );
+}
+
 /* the closest point from a 3D point to a 3D ellipsoid. */
 double zEllips3DClosest(const zEllips3D *ellips, const zVec3D *p, zVec3D *cp)
 {
   zVec3D pi;
+  double d;
 
-  if( zEllips3DPointIsInside( ellips, p, zTOL ) ){
+  zXform3DInv( &ellips->f, p, &pi );
+  if( ( d = _zEllips3DClosestAligned( &ellips->radius, &pi, cp ) ) == 0 ){
     zVec3DCopy( p, cp );
     return 0;
   }
-  zXform3DInv( &ellips->f, p, &pi );
-  _zEllips3DClosest( zEllips3DRadiusX(ellips), zEllips3DRadiusY(ellips), zEllips3DRadiusZ(ellips), &pi, cp );
   zXform3DDRC( &ellips->f, cp );
-  /* distance */
-  return zVec3DDist( p, cp );
+  return d;
+}
+
+typedef struct{
+  const zEllips3D *ellips;
+  const zVec3D *p;
+  zVec3D *cp;
+  double *dist;
+} _zEllips3DClosestBatch;
+
+/* the closest points from a chunk of 3D points to a 3D ellipsoid. */
+static void _zEllips3DClosestBatchChunk(void *util, int id, int start, int end)
+{
+  _zEllips3DClosestBatch *batch;
+  zVec3D pi, cp;
+  double d;
+  int i;
+
+  batch = (_zEllips3DClosestBatch *)util;
+  for( i=start; i<end; i++ ){
+    zXform3DInv( &batch->ellips->f, &batch->p[i], &pi );
+    if( ( d = _zEllips3DClosestAligned( &batch->ellips->radius, &pi, &cp ) ) == 0 )
+      zVec3DCopy( &batch->p[i], &cp );
+    else
+      zXform3DDRC( &batch->ellips->f, &cp );
+    if( batch->cp ) zVec3DCopy( &cp, &batch->cp[i] );
+    if( batch->dist ) batch->dist[i] = d;
+  }
+}
+
+/* the closest points from a set of 3D points to a 3D ellipsoid. */
+void zEllips3DClosestBatch(const zEllips3D *ellips, const zVec3D p[], int num, zVec3D cp[], double dist[], int thread_num)
+{
+  _zEllips3DClosestBatch batch;
+
+  batch.ellips = ellips;
+  batch.p = p;
+  batch.cp = cp;
+  batch.dist = dist;
+  zParallelFor( num, thread_num, _zEllips3DClosestBatchChunk, &batch );
 }
 
 /* distance from a point to a 3D ellipsoid. */
@@ -153,6 +200,52 @@ bool zEllips3DPointIsInside(const zEllips3D *ellips, const zVec3D *p, double mar
        + zSqr(_p.c.z / ( zEllips3DRadiusZ(ellips) + margin ) ) < 1 ? true : false;
 }
 
+/* support map of an ellipsoid. */
+zVec3D *zEllips3DSupportMap(const zEllips3D *ellips, const zVec3D *dir, zVec3D *sp)
+{
+  zVec3D d;
+  double l;
+
+  zMulMat3DTVec3D( zFrame3DAtt(&ellips->f), dir, &d );
+  d.c.x *= zEllips3DRadiusX(ellips);
+  d.c.y *= zEllips3DRadiusY(ellips);
+  d.c.z *= zEllips3DRadiusZ(ellips);
+  if( zIsTiny( ( l = zVec3DNorm( &d ) ) ) )
+    return zVec3DCopy( zEllips3DCenter(ellips), sp );
+  d.c.x *= zEllips3DRadiusX(ellips) / l;
+  d.c.y *= zEllips3DRadiusY(ellips) / l;
+  d.c.z *= zEllips3DRadiusZ(ellips) / l;
+  return zXform3D( &ellips->f, &d, sp );
+}
+
+/* ray casting on a 3D ellipsoid. */
+bool zEllips3DRaycast(const zEllips3D *ellips, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal)
+{
+  zVec3D o, d, n;
+  double s[2];
+  int i, num;
+
+  /* scale the ellipsoid to the unit sphere in its frame */
+  zXform3DInv( &ellips->f, org, &o );
+  zMulMat3DTVec3D( zFrame3DAtt(&ellips->f), dir, &d );
+  for( i=zX; i<=zZ; i++ ){
+    o.e[i] /= zEllips3DRadius(ellips,i);
+    d.e[i] /= zEllips3DRadius(ellips,i);
+  }
+  num = zQuadraticRealRoots( zVec3DSqrNorm(&d), zVec3DInnerProd(&o,&d), zVec3DSqrNorm(&o) - 1, s );
+  for( i=0; i<num; i++ )
+    if( s[i] >= 0 ) break;
+  if( i == num || s[i] > tmax ) return false;
+  *t = s[i];
+  if( !normal ) return true;
+  zVec3DCatDRC( &o, s[i], &d );
+  for( i=zX; i<=zZ; i++ ) /* gradient of the implicit function */
+    o.e[i] /= zEllips3DRadius(ellips,i);
+  zMulMat3DVec3D( zFrame3DAtt(&ellips->f), &o, &n );
+  zVec3DNormalize( &n, normal );
+  return true;
+}
+
 /* volume of a 3D ellipsoid. */
 double zEllips3DVolume(const zEllips3D *ellips)
 {
@@ -343,6 +436,10 @@ static double _zShape3DEllipsDistFromPoint(void *body, const zVec3D *p){
   return zEllips3DDistFromPoint( (zEllips3D*)body, p ); }
 static bool _zShape3DEllipsPointIsInside(void *body, const zVec3D *p, double margin){
   return zEllips3DPointIsInside( (zEllips3D*)body, p, margin ); }
+static zVec3D *_zShape3DEllipsSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  return zEllips3DSupportMap( (zEllips3D*)body, dir, sp ); }
+static bool _zShape3DEllipsRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  return zEllips3DRaycast( (zEllips3D*)body, org, dir, tmax, t, normal ); }
 static double _zShape3DEllipsVolume(void *body){
   return zEllips3DVolume( (zEllips3D*)body ); }
 static zVec3D *_zShape3DEllipsBarycenter(void *body, zVec3D *c){
@@ -371,6 +468,8 @@ zShape3DCom zeo_shape3d_ellips_com = {
   _zShape3DEllipsClosest,
   _zShape3DEllipsDistFromPoint,
   _zShape3DEllipsPointIsInside,
+  _zShape3DEllipsSupportMap,
+  _zShape3DEllipsRaycast,
   _zShape3DEllipsVolume,
   _zShape3DEllipsBarycenter,
   _zShape3DEllipsBaryInertiaMass,
@@ -35,6 +35,28 @@ static double _zShape3DNURBSClosest(void *body, const zVec3D *p, zVec3D *cp){
 static double _zShape3DNURBSDistFromPoint(void *body, const zVec3D *p){
   zVec3D nn;
   return zNURBS3DClosest( (zNURBS3D*)body, p, &nn, NULL, NULL ); }
+/* support map of the convex hull of control points, which contains the surface. */
+static zVec3D *_zShape3DNURBSSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  zNURBS3D *nurbs;
+  zVec3D *v = NULL;
+  double d, d_max = -HUGE_VAL;
+  int i, j;
+  nurbs = (zNURBS3D*)body;
+  for( i=0; i<zNURBS3DCPNum(nurbs,0); i++ )
+    for( j=0; j<zNURBS3DCPNum(nurbs,1); j++ )
+      if( ( d = zVec3DInnerProd( zNURBS3DCP(nurbs,i,j), dir ) ) > d_max ){
+        v = zNURBS3DCP(nurbs,i,j);
+        d_max = d;
+      }
+  return v ? zVec3DCopy( v, sp ) : NULL; }
+/* ray casting against a tessellated surface, which is slow since it is tessellated at every call. */
+static bool _zShape3DNURBSRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  zPH3D ph;
+  bool ret;
+  if( !zNURBS3DToPH( (zNURBS3D*)body, &ph ) ) return false;
+  ret = zPH3DRaycast( &ph, org, dir, tmax, t, normal, NULL );
+  zPH3DDestroy( &ph );
+  return ret; }
 
 /* dummy functions */
 static bool _zShape3DNURBSPointIsInside(void *body, const zVec3D *p, double margin){
@@ -67,6 +89,8 @@ zShape3DCom zeo_shape3d_nurbs_com = {
   _zShape3DNURBSClosest,
   _zShape3DNURBSDistFromPoint,
   _zShape3DNURBSPointIsInside,
+  _zShape3DNURBSSupportMap,
+  _zShape3DNURBSRaycast,
   _zShape3DNURBSVolume,
   _zShape3DNURBSBarycenter,
   _zShape3DNURBSBaryInertiaMass,
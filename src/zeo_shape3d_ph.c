@@ -36,6 +36,11 @@ static double _zShape3DPHDistFromPoint(void *body, const zVec3D *p){
   return zPH3DDistFromPoint( (zPH3D*)body, p ); }
 static bool _zShape3DPHPointIsInside(void *body, const zVec3D *p, double margin){
   return zPH3DPointIsInside( (zPH3D*)body, p, margin ); }
+static zVec3D *_zShape3DPHSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  const zVec3D *v;
+  return ( v = zPH3DSupportMap( (zPH3D*)body, dir ) ) ? zVec3DCopy( v, sp ) : NULL; }
+static bool _zShape3DPHRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  return zPH3DRaycast( (zPH3D*)body, org, dir, tmax, t, normal, NULL ); }
 static double _zShape3DPHVolume(void *body){
   return zPH3DVolume( (zPH3D*)body ); }
 static zVec3D *_zShape3DPHBarycenter(void *body, zVec3D *c){
@@ -63,6 +68,8 @@ zShape3DCom zeo_shape3d_ph_com = {
   _zShape3DPHClosest,
   _zShape3DPHDistFromPoint,
   _zShape3DPHPointIsInside,
+  _zShape3DPHSupportMap,
+  _zShape3DPHRaycast,
   _zShape3DPHVolume,
   _zShape3DPHBarycenter,
   _zShape3DPHBaryInertiaMass,
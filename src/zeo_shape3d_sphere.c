@@ -160,6 +160,10 @@ static double _zShape3DSphereDistFromPoint(void *body, const zVec3D *p){
   return zSphere3DDistFromPoint( (zSphere3D*)body, p ); }
 static bool _zShape3DSpherePointIsInside(void *body, const zVec3D *p, double margin){
   return zSphere3DPointIsInside( (zSphere3D*)body, p, margin ); }
+static zVec3D *_zShape3DSphereSupportMap(void *body, const zVec3D *dir, zVec3D *sp){
+  return zSphere3DSupportMap( (zSphere3D*)body, dir, sp ); }
+static bool _zShape3DSphereRaycast(void *body, const zVec3D *org, const zVec3D *dir, double tmax, double *t, zVec3D *normal){
+  return zSphere3DRaycast( (zSphere3D*)body, org, dir, tmax, t, normal ); }
 static double _zShape3DSphereVolume(void *body){
   return zSphere3DVolume( (zSphere3D*)body ); }
 static zVec3D *_zShape3DSphereBarycenter(void *body, zVec3D *c){
@@ -188,6 +192,8 @@ zShape3DCom zeo_shape3d_sphere_com = {
   _zShape3DSphereClosest,
   _zShape3DSphereDistFromPoint,
   _zShape3DSpherePointIsInside,
+  _zShape3DSphereSupportMap,
+  _zShape3DSphereRaycast,
   _zShape3DSphereVolume,
   _zShape3DSphereBarycenter,
   _zShape3DSphereBaryInertiaMass,
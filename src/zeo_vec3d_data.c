@@ -53,3 +53,54 @@ ZEO_VECXD_DATA_FPRINT( 3D )
 
 /* print out values of a set of 3D vectors. */
 ZEO_VECXD_DATA_VALUE_FPRINT( 3D )
+
+/* k-nearest neighbor search */
+
+/* initialize a bounded priority queue of k-nearest neighbors. */
+zVec3DKNN *zVec3DKNNInit(zVec3DKNN *knn, int k, zVec3D *nn[], double dist[])
+{
+  knn->k = k;
+  knn->num = 0;
+  knn->nn = nn;
+  knn->dist = dist;
+  return knn;
+}
+
+/* push a point into a bounded priority queue of k-nearest neighbors. */
+bool zVec3DKNNAdd(zVec3DKNN *knn, const zVec3D *v, double d_sqr)
+{
+  int i;
+
+  if( d_sqr >= zVec3DKNNBound( knn ) ) return false;
+  if( knn->num < knn->k ) knn->num++;
+  for( i=knn->num-1; i>0 && knn->dist[i-1]>d_sqr; i-- ){
+    knn->nn[i] = knn->nn[i-1];
+    knn->dist[i] = knn->dist[i-1];
+  }
+  knn->nn[i] = (zVec3D *)v;
+  knn->dist[i] = d_sqr;
+  return true;
+}
+
+/* finalize a bounded priority queue of k-nearest neighbors. */
+int zVec3DKNNFinish(zVec3DKNN *knn)
+{
+  int i;
+
+  for( i=0; i<knn->num; i++ )
+    knn->dist[i] = sqrt( knn->dist[i] );
+  return knn->num;
+}
+
+/* a naive algorithm to find k-nearest neighbors in a set of 3D vectors. */
+int zVec3DDataKNN(zVec3DData *data, const zVec3D *point, int k, zVec3D *nn[], double dist[])
+{
+  zVec3DKNN knn;
+  zVec3D *v;
+
+  zVec3DKNNInit( &knn, k, nn, dist );
+  zVec3DDataRewind( data );
+  while( ( v = zVec3DDataFetch( data ) ) )
+    zVec3DKNNAdd( &knn, v, zVec3DSqrDist( v, point ) );
+  return zVec3DKNNFinish( &knn );
+}
@@ -345,6 +345,45 @@ double zVec3DOctreeNN(const zVec3DOctree *octree, const zVec3D *point, zVec3D **
   return _zVec3DOctantNN( &octree->root, point, nn, &dmin );
 }
 
+/* find k-nearest neighbors of a 3D point in a 3D leaf octant. */
+static void _zVec3DOctantLeafKNN(const zVec3DOctant *octant, const zVec3D *point, zVec3DKNN *knn)
+{
+  zVec3DListCell *cp;
+
+  zListForEach( &octant->points, cp )
+    zVec3DKNNAdd( knn, &cp->data, zVec3DSqrDist( &cp->data, point ) );
+}
+
+/* find k-nearest neighbors of a 3D point in a 3D octant except an already visited leaf. */
+static void _zVec3DOctantKNN(const zVec3DOctant *octant, const zVec3D *point, const zVec3DOctant *visited, zVec3DKNN *knn)
+{
+  int i;
+
+  if( octant == visited ) return;
+  if( !zListIsEmpty( &octant->points ) ){
+    _zVec3DOctantLeafKNN( octant, point, knn );
+    return;
+  }
+  for( i=0; i<8; i++ ){
+    if( !octant->suboctant[i] ) continue;
+    if( zAABox3DSqrDistFromPoint( &octant->suboctant[i]->region, point ) >= zVec3DKNNBound( knn ) ) continue;
+    _zVec3DOctantKNN( octant->suboctant[i], point, visited, knn );
+  }
+}
+
+/* find k-nearest neighbors of a 3D point in a 3D octree. */
+int zVec3DOctreeKNN(const zVec3DOctree *octree, const zVec3D *point, int k, zVec3D *nn[], double dist[])
+{
+  zVec3DKNN knn;
+  const zVec3DOctant *container;
+
+  zVec3DKNNInit( &knn, k, nn, dist );
+  if( ( container = zVec3DOctreeFindContainer( octree, point ) ) )
+    _zVec3DOctantLeafKNN( container, point, &knn );
+  _zVec3DOctantKNN( &octree->root, point, container, &knn );
+  return zVec3DKNNFinish( &knn );
+}
+
 /* find vicinity of a point in a 3D octant. */
 static zVec3DData *_zVec3DOctantVicinity(const zVec3DOctant *octant, const zVec3D *point, double radius_sqr, zVec3DData *vicinity)
 {
@@ -379,3 +418,306 @@ int zVec3DOctreeToAABox3DList(const zVec3DOctree *octree, zAABox3DList *list)
   num = _zVec3DOctantToAABox3DList( &octree->root, list );
   return num == zListSize(list) ? num : 0;
 }
+
+/* flat octree */
+
+/* initialize a flat octree. */
+zVec3DFlatOctree *zVec3DFlatOctreeInit(zVec3DFlatOctree *tree)
+{
+  tree->resolution = 0;
+  tree->node_num = tree->node_capacity = 0;
+  tree->node = NULL;
+  tree->leaf_num = tree->leaf_capacity = 0;
+  tree->leaf = NULL;
+  tree->point_num = 0;
+  tree->point = NULL;
+  return tree;
+}
+
+/* destroy a flat octree. */
+void zVec3DFlatOctreeDestroy(zVec3DFlatOctree *tree)
+{
+  zFree( tree->node );
+  zFree( tree->leaf );
+  zFree( tree->point );
+  zVec3DFlatOctreeInit( tree );
+}
+
+/* allocate consecutive nodes of a flat octree. */
+static int _zVec3DFlatOctreeAllocNode(zVec3DFlatOctree *tree, int num)
+{
+  zVec3DFlatOctreeNode *node;
+  int capacity;
+
+  if( tree->node_num + num > tree->node_capacity ){
+    for( capacity=_zMax(tree->node_capacity,8); capacity<tree->node_num+num; capacity*=2 );
+    if( !( node = zRealloc( tree->node, zVec3DFlatOctreeNode, capacity ) ) ){
+      ZALLOCERROR();
+      return -1;
+    }
+    tree->node = node;
+    tree->node_capacity = capacity;
+  }
+  tree->node_num += num;
+  return tree->node_num - num;
+}
+
+/* allocate a leaf of a flat octree. */
+static int _zVec3DFlatOctreeAllocLeaf(zVec3DFlatOctree *tree)
+{
+  zVec3DFlatOctreeLeaf *leaf;
+  int capacity;
+
+  if( tree->leaf_num >= tree->leaf_capacity ){
+    capacity = _zMax( tree->leaf_capacity * 2, 8 );
+    if( !( leaf = zRealloc( tree->leaf, zVec3DFlatOctreeLeaf, capacity ) ) ){
+      ZALLOCERROR();
+      return -1;
+    }
+    tree->leaf = leaf;
+    tree->leaf_capacity = capacity;
+  }
+  return tree->leaf_num++;
+}
+
+/* index of a suboctant that contains a point. */
+#define _zVec3DFlatOctreeSuboctant(point,center) \
+  ( ( (point)->c.x > (center)->c.x ? 0x1 : 0 ) | \
+    ( (point)->c.y > (center)->c.y ? 0x2 : 0 ) | \
+    ( (point)->c.z > (center)->c.z ? 0x4 : 0 ) )
+
+/* create a leaf of a flat octree. */
+static bool _zVec3DFlatOctreeCreateLeaf(zVec3DFlatOctree *tree, int node, int start, int end)
+{
+  zVec3DFlatOctreeLeaf *leaf;
+  zVec3D center, p, dir;
+  int i;
+
+  if( ( tree->node[node].leaf = _zVec3DFlatOctreeAllocLeaf( tree ) ) < 0 ) return false;
+  leaf = &tree->leaf[tree->node[node].leaf];
+  leaf->start = start;
+  leaf->num = end - start;
+  zAABox3DCenter( &tree->node[node].region, &center );
+  zMat3DZero( &leaf->ncov );
+  zVec3DZero( &dir );
+  for( i=start; i<end; i++ ){
+    _zVec3DSub( &tree->point[i], &center, &p );
+    _zMat3DAddDyad( &leaf->ncov, &p, &p );
+    _zVec3DAddDRC( &dir, &tree->point[i] );
+  }
+  zMat3DSymEigMin( &leaf->ncov, &leaf->norm );
+  /* orient the normal vector outward from the center of the whole region */
+  if( leaf->num > 0 ){
+    zVec3DDivDRC( &dir, leaf->num );
+    zAABox3DCenter( &tree->node[0].region, &center );
+    _zVec3DSubDRC( &dir, &center );
+    if( _zVec3DInnerProd( &leaf->norm, &dir ) < 0 ) zVec3DRevDRC( &leaf->norm );
+  }
+  return true;
+}
+
+/* build a subtree of a flat octree. */
+static bool _zVec3DFlatOctreeBuild(zVec3DFlatOctree *tree, int node, int start, int end, zVec3D *buf)
+{
+  zAABox3D region;
+  zVec3D center;
+  int count[8], offset[8], child[8];
+  int i, b, n;
+
+  zAABox3DCopy( &tree->node[node].region, &region );
+  tree->node[node].child = -1;
+  tree->node[node].child_num = 0;
+  tree->node[node].leaf = -1;
+  if( zAABox3DDepth(&region)  < tree->resolution + zTOL &&
+      zAABox3DWidth(&region)  < tree->resolution + zTOL &&
+      zAABox3DHeight(&region) < tree->resolution + zTOL )
+    return _zVec3DFlatOctreeCreateLeaf( tree, node, start, end );
+  /* counting sort of points into suboctants */
+  zAABox3DCenter( &region, &center );
+  for( b=0; b<8; b++ ) count[b] = 0;
+  for( i=start; i<end; i++ )
+    count[_zVec3DFlatOctreeSuboctant(&tree->point[i],&center)]++;
+  for( offset[0]=start, b=1; b<8; b++ )
+    offset[b] = offset[b-1] + count[b-1];
+  for( i=start; i<end; i++ ){
+    b = _zVec3DFlatOctreeSuboctant(&tree->point[i],&center);
+    zVec3DCopy( &tree->point[i], &buf[offset[b]++] );
+  }
+  memcpy( &tree->point[start], &buf[start], sizeof(zVec3D)*(end-start) );
+  /* allocate non-empty suboctants contiguously */
+  for( n=0, b=0; b<8; b++ )
+    if( count[b] > 0 ) child[n++] = b;
+  if( ( tree->node[node].child = _zVec3DFlatOctreeAllocNode( tree, n ) ) < 0 ) return false;
+  tree->node[node].child_num = n;
+  for( offset[0]=start, b=1; b<8; b++ )
+    offset[b] = offset[b-1] + count[b-1];
+  for( i=0; i<n; i++ ){
+    b = child[i];
+    zAABox3DCreate( &tree->node[tree->node[node].child+i].region,
+      b & 0x1 ? center.c.x : zAABox3DXMin(&region),
+      b & 0x2 ? center.c.y : zAABox3DYMin(&region),
+      b & 0x4 ? center.c.z : zAABox3DZMin(&region),
+      b & 0x1 ? zAABox3DXMax(&region) : center.c.x,
+      b & 0x2 ? zAABox3DYMax(&region) : center.c.y,
+      b & 0x4 ? zAABox3DZMax(&region) : center.c.z );
+  }
+  for( i=0; i<n; i++ ){
+    b = child[i];
+    if( !_zVec3DFlatOctreeBuild( tree, tree->node[node].child+i, offset[b], offset[b]+count[b], buf ) )
+      return false;
+  }
+  return true;
+}
+
+/* convert a set of 3D vectors to a flat octree. */
+zVec3DFlatOctree *zVec3DDataToFlatOctree(zVec3DData *pointdata, zVec3DFlatOctree *tree, double xmin, double ymin, double zmin, double xmax, double ymax, double zmax, double resolution)
+{
+  zVec3D *v, *buf = NULL;
+  int root;
+
+  zVec3DFlatOctreeInit( tree );
+  tree->resolution = resolution;
+  if( ( root = _zVec3DFlatOctreeAllocNode( tree, 1 ) ) < 0 ) goto FAILURE;
+  zAABox3DCreate( &tree->node[root].region, xmin, ymin, zmin, xmax, ymax, zmax );
+  if( zVec3DDataSize(pointdata) > 0 ){
+    tree->point = zAlloc( zVec3D, zVec3DDataSize(pointdata) );
+    buf = zAlloc( zVec3D, zVec3DDataSize(pointdata) );
+    if( !tree->point || !buf ){
+      ZALLOCERROR();
+      goto FAILURE;
+    }
+  }
+  zVec3DDataRewind( pointdata );
+  while( ( v = zVec3DDataFetch( pointdata ) ) ){
+    if( !zAABox3DPointIsInside( &tree->node[root].region, v, zTOL ) ){
+      ZRUNERROR( ZEO_ERR_OCTREE_POINT_OUTOFREGION );
+      goto FAILURE;
+    }
+    zVec3DCopy( v, &tree->point[tree->point_num++] );
+  }
+  if( !_zVec3DFlatOctreeBuild( tree, root, 0, tree->point_num, buf ) ) goto FAILURE;
+  zFree( buf );
+  return tree;
+
+ FAILURE:
+  zFree( buf );
+  zVec3DFlatOctreeDestroy( tree );
+  return NULL;
+}
+
+/* find a leaf that contains a 3D point in a flat octree. */
+const zVec3DFlatOctreeLeaf *zVec3DFlatOctreeFindContainer(const zVec3DFlatOctree *tree, const zVec3D *point)
+{
+  const zVec3DFlatOctreeNode *node;
+  int i;
+
+  if( tree->node_num == 0 || !zAABox3DPointIsInside( &tree->node[0].region, point, zTOL ) ) return NULL;
+  for( node=&tree->node[0]; node->child_num > 0; ){
+    for( i=0; i<node->child_num; i++ )
+      if( zAABox3DPointIsInside( &tree->node[node->child+i].region, point, zTOL ) ) break;
+    if( i == node->child_num ) return NULL;
+    node = &tree->node[node->child+i];
+  }
+  return node->leaf >= 0 ? &tree->leaf[node->leaf] : NULL;
+}
+
+/* find nearest neighbor of a 3D point in a leaf of a flat octree. */
+static void _zVec3DFlatOctreeLeafNN(const zVec3DFlatOctree *tree, const zVec3DFlatOctreeLeaf *leaf, const zVec3D *point, zVec3D **nn, double *dmin_sqr)
+{
+  int i;
+  double d_sqr;
+
+  for( i=0; i<leaf->num; i++ )
+    if( ( d_sqr = zVec3DSqrDist( zVec3DFlatOctreeLeafPoint(tree,leaf,i), point ) ) < *dmin_sqr ){
+      *nn = zVec3DFlatOctreeLeafPoint(tree,leaf,i);
+      *dmin_sqr = d_sqr;
+    }
+}
+
+/* find nearest neighbor of a 3D point in a subtree of a flat octree. */
+static void _zVec3DFlatOctreeNN(const zVec3DFlatOctree *tree, int node, const zVec3D *point, zVec3D **nn, double *dmin_sqr)
+{
+  int i;
+
+  if( zAABox3DSqrDistFromPoint( &tree->node[node].region, point ) > *dmin_sqr ) return;
+  if( tree->node[node].leaf >= 0 ){
+    _zVec3DFlatOctreeLeafNN( tree, &tree->leaf[tree->node[node].leaf], point, nn, dmin_sqr );
+    return;
+  }
+  for( i=0; i<tree->node[node].child_num; i++ )
+    _zVec3DFlatOctreeNN( tree, tree->node[node].child+i, point, nn, dmin_sqr );
+}
+
+/* find nearest neighbor of a 3D point in a flat octree. */
+double zVec3DFlatOctreeNN(const zVec3DFlatOctree *tree, const zVec3D *point, zVec3D **nn)
+{
+  double dmin_sqr = HUGE_VAL;
+  const zVec3DFlatOctreeLeaf *container;
+
+  *nn = NULL;
+  if( tree->node_num == 0 ) return HUGE_VAL;
+  if( ( container = zVec3DFlatOctreeFindContainer( tree, point ) ) )
+    _zVec3DFlatOctreeLeafNN( tree, container, point, nn, &dmin_sqr );
+  _zVec3DFlatOctreeNN( tree, 0, point, nn, &dmin_sqr );
+  return sqrt( dmin_sqr );
+}
+
+/* find k-nearest neighbors of a 3D point in a subtree of a flat octree except an already visited leaf. */
+static void _zVec3DFlatOctreeKNN(const zVec3DFlatOctree *tree, int node, const zVec3D *point, const zVec3DFlatOctreeLeaf *visited, zVec3DKNN *knn)
+{
+  const zVec3DFlatOctreeLeaf *leaf;
+  int i;
+
+  if( zAABox3DSqrDistFromPoint( &tree->node[node].region, point ) >= zVec3DKNNBound( knn ) ) return;
+  if( tree->node[node].leaf >= 0 ){
+    if( ( leaf = &tree->leaf[tree->node[node].leaf] ) == visited ) return;
+    for( i=0; i<leaf->num; i++ )
+      zVec3DKNNAdd( knn, zVec3DFlatOctreeLeafPoint(tree,leaf,i), zVec3DSqrDist( zVec3DFlatOctreeLeafPoint(tree,leaf,i), point ) );
+    return;
+  }
+  for( i=0; i<tree->node[node].child_num; i++ )
+    _zVec3DFlatOctreeKNN( tree, tree->node[node].child+i, point, visited, knn );
+}
+
+/* find k-nearest neighbors of a 3D point in a flat octree. */
+int zVec3DFlatOctreeKNN(const zVec3DFlatOctree *tree, const zVec3D *point, int k, zVec3D *nn[], double dist[])
+{
+  zVec3DKNN knn;
+  const zVec3DFlatOctreeLeaf *container = NULL;
+  int i;
+
+  zVec3DKNNInit( &knn, k, nn, dist );
+  if( tree->node_num == 0 ) return 0;
+  if( ( container = zVec3DFlatOctreeFindContainer( tree, point ) ) )
+    for( i=0; i<container->num; i++ )
+      zVec3DKNNAdd( &knn, zVec3DFlatOctreeLeafPoint(tree,container,i), zVec3DSqrDist( zVec3DFlatOctreeLeafPoint(tree,container,i), point ) );
+  _zVec3DFlatOctreeKNN( tree, 0, point, container, &knn );
+  return zVec3DKNNFinish( &knn );
+}
+
+/* find vicinity of a point in a subtree of a flat octree. */
+static zVec3DData *_zVec3DFlatOctreeVicinity(const zVec3DFlatOctree *tree, int node, const zVec3D *point, double radius_sqr, zVec3DData *vicinity)
+{
+  const zVec3DFlatOctreeLeaf *leaf;
+  int i;
+
+  if( zAABox3DSqrDistFromPoint( &tree->node[node].region, point ) >= radius_sqr ) return vicinity;
+  if( tree->node[node].leaf >= 0 ){
+    leaf = &tree->leaf[tree->node[node].leaf];
+    for( i=0; i<leaf->num; i++ )
+      if( zVec3DSqrDist( zVec3DFlatOctreeLeafPoint(tree,leaf,i), point ) < radius_sqr )
+        if( !zVec3DDataAdd( vicinity, zVec3DFlatOctreeLeafPoint(tree,leaf,i) ) ) return NULL;
+    return vicinity;
+  }
+  for( i=0; i<tree->node[node].child_num; i++ )
+    if( !_zVec3DFlatOctreeVicinity( tree, tree->node[node].child+i, point, radius_sqr, vicinity ) ) return NULL;
+  return vicinity;
+}
+
+/* find vicinity of a point in a flat octree. */
+zVec3DData *zVec3DFlatOctreeVicinity(const zVec3DFlatOctree *tree, const zVec3D *point, double radius, zVec3DData *vicinity)
+{
+  zVec3DDataInitAddrList( vicinity );
+  if( tree->node_num == 0 ) return vicinity;
+  return _zVec3DFlatOctreeVicinity( tree, 0, point, _zSqr(radius), vicinity );
+}
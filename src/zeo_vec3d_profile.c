@@ -27,24 +27,24 @@ static zVec3D *_zVec3DDataNormalVecFromVicinity(zVec3DData *vicinity, const zVec
 /* normal vector cloud of a 3D point cloud that uses kd-tree with k=3. */
 zVec3DData *zVec3DDataNormalVec_Tree(zVec3DData *pointdata, double radius, zVec3DData *normaldata)
 {
-  zVec3DTree tree;
+  zVec3DFlatTree tree;
   zVec3DData vicinity, *retval = NULL;
   zVec3D *v, normal, center;
 
-  if( !zVec3DDataToTree( pointdata, &tree ) ) goto TERMINATE;
+  if( !zVec3DDataToFlatTree( pointdata, &tree, 0 ) ) return NULL;
   zVec3DDataBarycenter( pointdata, &center );
   zVec3DDataInitList( normaldata );
   zVec3DDataRewind( pointdata );
   while( ( v = zVec3DDataFetch( pointdata ) ) ){
     zVec3DDataInitAddrList( &vicinity );
-    if( !zVec3DTreeVicinity( &tree, v, radius, &vicinity ) ) goto TERMINATE;
+    if( !zVec3DFlatTreeVicinity( &tree, v, radius, &vicinity ) ) goto TERMINATE;
     _zVec3DDataNormalVecFromVicinity( &vicinity, v, &center, &normal );
     if( !zVec3DDataAdd( normaldata, &normal ) ) goto TERMINATE;
     zVec3DDataDestroy( &vicinity );
   }
   retval = normaldata;
  TERMINATE:
-  zVec3DTreeDestroy( &tree );
+  zVec3DFlatTreeDestroy( &tree );
   return retval;
 }
 
@@ -77,16 +77,435 @@ zVec3DData *zVec3DDataNormalVec_Octree(zVec3DData *pointdata, double radius, zVe
 
 zVec3DData *(* zVec3DDataNormalVec)(zVec3DData*, double, zVec3DData*) = zVec3DDataNormalVec_Octree;
 
+/* normal vector cloud of a 3D point cloud from k-nearest neighbors. */
+zVec3DData *zVec3DDataNormalVec_KNN(zVec3DData *pointdata, int k, zVec3DData *normaldata)
+{
+  zVec3DFlatTree tree;
+  zVec3DData vicinity, *retval = NULL;
+  zVec3D *v, normal, center, **nn;
+  double *dist;
+  int i, n;
+
+  nn = zAlloc( zVec3D*, k );
+  dist = zAlloc( double, k );
+  if( !nn || !dist ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  if( !zVec3DDataToFlatTree( pointdata, &tree, 0 ) ) goto TERMINATE;
+  zVec3DDataBarycenter( pointdata, &center );
+  zVec3DDataInitList( normaldata );
+  zVec3DDataRewind( pointdata );
+  while( ( v = zVec3DDataFetch( pointdata ) ) ){
+    n = zVec3DFlatTreeKNN( &tree, v, k, nn, dist );
+    zVec3DDataInitAddrList( &vicinity );
+    for( i=0; i<n; i++ )
+      if( !zVec3DDataAdd( &vicinity, nn[i] ) ){
+        zVec3DDataDestroy( &vicinity );
+        goto TERMINATE2;
+      }
+    _zVec3DDataNormalVecFromVicinity( &vicinity, v, &center, &normal );
+    zVec3DDataDestroy( &vicinity );
+    if( !zVec3DDataAdd( normaldata, &normal ) ) goto TERMINATE2;
+  }
+  retval = normaldata;
+ TERMINATE2:
+  if( !retval ) zVec3DDataDestroy( normaldata );
+  zVec3DFlatTreeDestroy( &tree );
+ TERMINATE:
+  zFree( nn );
+  zFree( dist );
+  return retval;
+}
+
+/* parallel normal vector estimation */
+
+typedef struct{
+  const zVec3DFlatTree *tree;
+  zVec3D center;
+  double radius;
+  int k;
+  zVec3D **nn;    /* k neighbors for each thread */
+  double *dist;   /* k distances for each thread */
+  int *fewcount;  /* number of points with too few neighbors for each thread */
+  zVec3DArray *normalarray;
+} _zVec3DDataNormalVecParallel;
+
+/* estimate normal vectors of a chunk of points. */
+static void _zVec3DDataNormalVecParallelChunk(void *util, int id, int start, int end)
+{
+  _zVec3DDataNormalVecParallel *nv;
+  zVec3D **nn, *p, *normal, d, eigval;
+  double *dist;
+  zMat3D cov, eigbase;
+  int i, j, n;
+
+  nv = (_zVec3DDataNormalVecParallel *)util;
+  nn = nv->nn + id * nv->k;
+  dist = nv->dist + id * nv->k;
+  for( i=start; i<end; i++ ){
+    p = &nv->tree->point[i];
+    normal = zArrayElemNC( nv->normalarray, nv->tree->boxtree.index[i] );
+    n = zVec3DFlatTreeKNN( nv->tree, p, nv->k, nn, dist );
+    if( nv->radius > 0 )
+      while( n > 0 && dist[n-1] >= nv->radius ) n--;
+    if( n < ZEO_VEC3DDATA_NORMALVEC_NUM_MIN ) nv->fewcount[id]++;
+    zMat3DZero( &cov );
+    for( j=0; j<n; j++ ){
+      zVec3DSub( nn[j], p, &d );
+      zMat3DAddDyad( &cov, &d, &d );
+    }
+    zMat3DSymEig( &cov, &eigval, &eigbase );
+    zVec3DCopy( &eigbase.v[_zMat3DEigMinID( eigval.e )], normal );
+    zVec3DSub( p, &nv->center, &d );
+    if( zVec3DInnerProd( normal, &d ) < 0 )
+      zVec3DRevDRC( normal ); /* flip the normal vector to be outward (not a strict way) */
+  }
+}
+
+/* normal vector cloud of a 3D point cloud computed in parallel. */
+zVec3DArray *zVec3DDataNormalVec_Parallel(zVec3DData *pointdata, double radius, int k, zVec3DArray *normalarray, int thread_num)
+{
+  _zVec3DDataNormalVecParallel nv;
+  zVec3DFlatTree tree;
+  zVec3DArray *retval = NULL;
+  int i, fewcount = 0;
+
+  zArrayInit( normalarray );
+  if( !zVec3DDataBarycenter( pointdata, &nv.center ) ) return NULL;
+  if( k <= 0 ) k = ZEO_VEC3DDATA_NORMALVEC_NUM_MAX;
+  thread_num = zParallelThreadNum( thread_num );
+  nv.tree = &tree;
+  nv.radius = radius;
+  nv.k = k;
+  nv.nn = zAlloc( zVec3D*, thread_num * k );
+  nv.dist = zAlloc( double, thread_num * k );
+  nv.fewcount = zAlloc( int, thread_num );
+  nv.normalarray = normalarray;
+  zVec3DFlatTreeInit( &tree );
+  if( !nv.nn || !nv.dist || !nv.fewcount ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  zArrayAlloc( normalarray, zVec3D, zVec3DDataSize(pointdata) );
+  if( zArraySize(normalarray) != zVec3DDataSize(pointdata) ) goto TERMINATE;
+  if( !zVec3DDataToFlatTree( pointdata, &tree, 0 ) ) goto TERMINATE;
+  zParallelFor( tree.point_num, thread_num, _zVec3DDataNormalVecParallelChunk, &nv );
+  for( i=0; i<thread_num; i++ ) fewcount += nv.fewcount[i];
+  if( fewcount > 0 )
+    ZRUNWARN( ZEO_WARN_VEC3DDATA_NORMAL_TOOFEWPOINTS );
+  retval = normalarray;
+ TERMINATE:
+  if( !retval ) zArrayFree( normalarray );
+  zVec3DFlatTreeDestroy( &tree );
+  zFree( nv.nn );
+  zFree( nv.dist );
+  zFree( nv.fewcount );
+  return retval;
+}
+
+/* voxel-grid downsampling */
+
+typedef struct{
+  zVec3D **point;  /* points */
+  zVec3D origin;   /* origin of the grid */
+  double pitch;    /* size of voxels */
+  int *cell;       /* voxel coordinates of points */
+  int *head;       /* head of points in each voxel in order */
+  int *order;      /* indices of points sorted by voxels */
+  bool centroid;   /* flag to take the centroid */
+  zVec3D *rep;     /* representative points of voxels */
+} _zVec3DDataVoxel;
+
+/* voxel coordinates of a chunk of points. */
+static void _zVec3DDataVoxelCellChunk(void *util, int id, int start, int end)
+{
+  _zVec3DDataVoxel *vg;
+  int i, k;
+
+  vg = (_zVec3DDataVoxel *)util;
+  for( i=start; i<end; i++ )
+    for( k=0; k<3; k++ )
+      vg->cell[3*i+k] = (int)( ( vg->point[i]->e[k] - vg->origin.e[k] ) / vg->pitch );
+}
+
+/* representative points of a chunk of voxels. */
+static void _zVec3DDataVoxelRepChunk(void *util, int id, int start, int end)
+{
+  _zVec3DDataVoxel *vg;
+  int i, j;
+
+  vg = (_zVec3DDataVoxel *)util;
+  for( i=start; i<end; i++ ){
+    zVec3DCopy( vg->point[vg->order[vg->head[i]]], &vg->rep[i] );
+    if( !vg->centroid ) continue;
+    for( j=vg->head[i]+1; j<vg->head[i+1]; j++ )
+      zVec3DAddDRC( &vg->rep[i], vg->point[vg->order[j]] );
+    zVec3DDivDRC( &vg->rep[i], vg->head[i+1] - vg->head[i] );
+  }
+}
+
+/* hash value of voxel coordinates. */
+#define _zVec3DDataVoxelHash(c) \
+  ( (unsigned int)(c)[0] * 73856093u ^ (unsigned int)(c)[1] * 19349663u ^ (unsigned int)(c)[2] * 83492791u )
+
+/* assign voxels to points by an open-addressing hash table. */
+static int _zVec3DDataVoxelAssign(_zVec3DDataVoxel *vg, int num, int *voxel, int *first)
+{
+  int *table;
+  unsigned int size, h;
+  int i, voxel_num = 0;
+
+  for( size=1; size<2*(unsigned int)num; size<<=1 );
+  if( !( table = zAlloc( int, size ) ) ){
+    ZALLOCERROR();
+    return -1;
+  }
+  for( h=0; h<size; h++ ) table[h] = -1;
+  for( i=0; i<num; i++ ){
+    for( h=_zVec3DDataVoxelHash(&vg->cell[3*i])&(size-1); table[h]>=0; h=(h+1)&(size-1) )
+      if( memcmp( &vg->cell[3*first[table[h]]], &vg->cell[3*i], sizeof(int)*3 ) == 0 ) break;
+    if( table[h] < 0 ){
+      first[voxel_num] = i;
+      table[h] = voxel_num++;
+    }
+    voxel[i] = table[h];
+  }
+  zFree( table );
+  return voxel_num;
+}
+
+/* downsample a 3D point cloud by a voxel grid. */
+zVec3DData *zVec3DDataVoxelDownsample(zVec3DData *src, double pitch, bool centroid, zVec3DData *dest, int thread_num)
+{
+  _zVec3DDataVoxel vg;
+  zAABox3D box;
+  zVec3D *v;
+  int *voxel, *first;
+  int i, k, num, voxel_num;
+  zVec3DData *retval = NULL;
+
+  if( pitch <= 0 ){
+    ZRUNERROR( ZEO_ERR_VEC3DDATA_VOXEL_INVALIDPITCH, pitch );
+    return NULL;
+  }
+  if( ( num = zVec3DDataSize(src) ) == 0 ) return zVec3DDataInitArray( dest, 1 );
+  zVec3DDataAABB( src, &box, NULL );
+  for( k=0; k<3; k++ )
+    if( ( box.max.e[k] - box.min.e[k] ) / pitch >= INT_MAX ){
+      ZRUNERROR( ZEO_ERR_VEC3DDATA_VOXEL_INVALIDPITCH, pitch );
+      return NULL;
+    }
+  zVec3DCopy( &box.min, &vg.origin );
+  vg.pitch = pitch;
+  vg.centroid = centroid;
+  vg.point = zAlloc( zVec3D*, num );
+  vg.cell = zAlloc( int, num*3 );
+  vg.order = zAlloc( int, num );
+  vg.head = zAlloc( int, num+1 );
+  vg.rep = NULL;
+  voxel = zAlloc( int, num );
+  first = zAlloc( int, num );
+  if( !vg.point || !vg.cell || !vg.order || !vg.head || !voxel || !first ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  zVec3DDataRewind( src );
+  for( i=0; ( v = zVec3DDataFetch( src ) ); i++ ) vg.point[i] = v;
+  zParallelFor( num, thread_num, _zVec3DDataVoxelCellChunk, &vg );
+  if( ( voxel_num = _zVec3DDataVoxelAssign( &vg, num, voxel, first ) ) < 0 ) goto TERMINATE;
+  /* sort points by voxels (stable counting sort) */
+  memset( vg.head, 0, sizeof(int)*(voxel_num+1) );
+  for( i=0; i<num; i++ ) vg.head[voxel[i]+1]++;
+  for( i=0; i<voxel_num; i++ ) vg.head[i+1] += vg.head[i];
+  for( i=0; i<num; i++ ) vg.order[vg.head[voxel[i]]++] = i;
+  for( i=voxel_num; i>0; i-- ) vg.head[i] = vg.head[i-1];
+  vg.head[0] = 0;
+  if( !( vg.rep = zAlloc( zVec3D, voxel_num ) ) ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  zParallelFor( voxel_num, thread_num, _zVec3DDataVoxelRepChunk, &vg );
+  if( !zVec3DDataInitArray( dest, voxel_num ) ) goto TERMINATE;
+  for( i=0; i<voxel_num; i++ ) zVec3DDataAdd( dest, &vg.rep[i] );
+  retval = dest;
+ TERMINATE:
+  zFree( vg.point );
+  zFree( vg.cell );
+  zFree( vg.order );
+  zFree( vg.head );
+  zFree( vg.rep );
+  zFree( voxel );
+  zFree( first );
+  return retval;
+}
+
+/* outlier removal */
+
+typedef struct{
+  const zVec3DFlatTree *tree;
+  int k;          /* number of neighbors to be found */
+  double radius;  /* radius of vicinity */
+  zVec3D **nn;    /* k neighbors for each thread */
+  double *dist;   /* k distances for each thread */
+  double *mean;   /* mean distances to neighbors in the order of the tree */
+  bool *inlier;   /* inlier mask in the original order */
+} _zVec3DDataOutlier;
+
+/* prepare a flat kd-tree and working buffers for outlier removal. */
+static bool _zVec3DDataOutlierInit(_zVec3DDataOutlier *ol, zVec3DData *data, zVec3DFlatTree *tree, int k, bool inlier[], int thread_num)
+{
+  ol->tree = tree;
+  ol->k = k;
+  ol->inlier = inlier;
+  ol->nn = zAlloc( zVec3D*, thread_num * k );
+  ol->dist = zAlloc( double, thread_num * k );
+  ol->mean = NULL;
+  zVec3DFlatTreeInit( tree );
+  if( !ol->nn || !ol->dist ){
+    ZALLOCERROR();
+    return false;
+  }
+  return zVec3DDataToFlatTree( data, tree, 0 ) ? true : false;
+}
+
+/* destroy working buffers for outlier removal. */
+static void _zVec3DDataOutlierDestroy(_zVec3DDataOutlier *ol, zVec3DFlatTree *tree)
+{
+  zVec3DFlatTreeDestroy( tree );
+  zFree( ol->nn );
+  zFree( ol->dist );
+  zFree( ol->mean );
+}
+
+/* mean distances from a chunk of points to their neighbors. */
+static void _zVec3DDataStatisticalOutlierChunk(void *util, int id, int start, int end)
+{
+  _zVec3DDataOutlier *ol;
+  zVec3D **nn;
+  double *dist, s;
+  int i, j, n;
+
+  ol = (_zVec3DDataOutlier *)util;
+  nn = ol->nn + id * ol->k;
+  dist = ol->dist + id * ol->k;
+  for( i=start; i<end; i++ ){
+    /* the first neighbor is the point itself */
+    n = zVec3DFlatTreeKNN( ol->tree, &ol->tree->point[i], ol->k, nn, dist );
+    for( s=0, j=1; j<n; j++ ) s += dist[j];
+    ol->mean[i] = n > 1 ? s / ( n - 1 ) : 0;
+  }
+}
+
+/* statistical outlier removal of a 3D point cloud. */
+int zVec3DDataStatisticalOutlierMask(zVec3DData *data, int k, double std_ratio, bool inlier[], int thread_num)
+{
+  _zVec3DDataOutlier ol;
+  zVec3DFlatTree tree;
+  double mu = 0, sigma = 0, bound;
+  int i, num, count = -1;
+
+  if( ( num = zVec3DDataSize(data) ) == 0 ) return 0;
+  if( k <= 0 ) k = ZEO_VEC3DDATA_OUTLIER_NUM;
+  thread_num = zParallelThreadNum( thread_num );
+  if( !_zVec3DDataOutlierInit( &ol, data, &tree, k+1, inlier, thread_num ) ) goto TERMINATE;
+  if( !( ol.mean = zAlloc( double, num ) ) ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  zParallelFor( num, thread_num, _zVec3DDataStatisticalOutlierChunk, &ol );
+  for( i=0; i<num; i++ ) mu += ol.mean[i];
+  mu /= num;
+  for( i=0; i<num; i++ ) sigma += zSqr( ol.mean[i] - mu );
+  sigma = sqrt( sigma / num );
+  bound = mu + std_ratio * sigma;
+  for( count=0, i=0; i<num; i++ )
+    if( ( inlier[tree.boxtree.index[i]] = ol.mean[i] <= bound ? true : false ) ) count++;
+ TERMINATE:
+  _zVec3DDataOutlierDestroy( &ol, &tree );
+  return count;
+}
+
+/* check if a chunk of points have enough neighbors within a radius. */
+static void _zVec3DDataRadiusOutlierChunk(void *util, int id, int start, int end)
+{
+  _zVec3DDataOutlier *ol;
+  zVec3D **nn;
+  double *dist;
+  int i, n;
+
+  ol = (_zVec3DDataOutlier *)util;
+  nn = ol->nn + id * ol->k;
+  dist = ol->dist + id * ol->k;
+  for( i=start; i<end; i++ ){
+    /* the first neighbor is the point itself */
+    n = zVec3DFlatTreeKNN( ol->tree, &ol->tree->point[i], ol->k, nn, dist );
+    ol->inlier[ol->tree->boxtree.index[i]] = n == ol->k && dist[n-1] <= ol->radius ? true : false;
+  }
+}
+
+/* radius outlier removal of a 3D point cloud. */
+int zVec3DDataRadiusOutlierMask(zVec3DData *data, double radius, int min_num, bool inlier[], int thread_num)
+{
+  _zVec3DDataOutlier ol;
+  zVec3DFlatTree tree;
+  int i, num, count = -1;
+
+  if( ( num = zVec3DDataSize(data) ) == 0 ) return 0;
+  if( min_num <= 0 ){
+    for( i=0; i<num; i++ ) inlier[i] = true;
+    return num;
+  }
+  thread_num = zParallelThreadNum( thread_num );
+  if( !_zVec3DDataOutlierInit( &ol, data, &tree, min_num+1, inlier, thread_num ) ) goto TERMINATE;
+  ol.radius = radius;
+  zParallelFor( num, thread_num, _zVec3DDataRadiusOutlierChunk, &ol );
+  for( count=0, i=0; i<num; i++ )
+    if( inlier[i] ) count++;
+ TERMINATE:
+  _zVec3DDataOutlierDestroy( &ol, &tree );
+  return count;
+}
+
+/* extract points of a 3D point cloud by a mask. */
+zVec3DData *zVec3DDataMask(zVec3DData *src, const bool mask[], zVec3DData *dest)
+{
+  zVec3D *v;
+  int i, count = 0;
+
+  for( i=0; i<zVec3DDataSize(src); i++ )
+    if( mask[i] ) count++;
+  if( !zVec3DDataInitArray( dest, _zMax( count, 1 ) ) ) return NULL;
+  zVec3DDataRewind( src );
+  for( i=0; ( v = zVec3DDataFetch( src ) ); i++ )
+    if( mask[i] ) zVec3DDataAdd( dest, v );
+  return dest;
+}
+
 /* iterative closest point method */
 
 #define ZEO_VEC3DDATA_IDENT_FRAME_MINSIZ 3
 
+/* identify a transformation frame from a covariance matrix and barycenters of two sets of 3D points. */
+static zFrame3D *_zVec3DIdentFrameSVD(zMat3D *cov, double so, const zVec3D *pgo, const zVec3D *pg, zFrame3D *frame)
+{
+  zVec3D dp, d;
+  zMat3D u, v;
+
+  zMat3DSVD( cov, &u, &d, &v );
+  zMulMat3DMat3DT( &v, &u, zFrame3DAtt(frame) );
+  zMulMat3DVec3D( zFrame3DAtt(frame), pgo, &dp );
+  zVec3DMulDRC( &dp, ( d.c.x + d.c.y + d.c.z ) / so );
+  zVec3DSub( pg, &dp, zFrame3DPos(frame) );
+  return frame;
+}
+
 /* identify a transformation frame from two sets of 3D points. */
 zFrame3D *zVec3DDataIdentFrame(zVec3DData *src, zVec3DData *dest, zFrame3D *frame)
 {
   zVec3D *po, *p;
-  zVec3D pgo, pg, dpo, dp, d;
-  zMat3D cov, u, v;
+  zVec3D pgo, pg, dpo, dp;
+  zMat3D cov;
   double so = 0;
 
   if( zVec3DDataSize(src) != zVec3DDataSize(dest) ){
@@ -110,12 +529,35 @@ zFrame3D *zVec3DDataIdentFrame(zVec3DData *src, zVec3DData *dest, zFrame3D *fram
   }
   so /= zVec3DDataSize(src);
   zMat3DDivDRC( &cov, zVec3DDataSize(src) );
-  zMat3DSVD( &cov, &u, &d, &v );
-  zMulMat3DMat3DT( &v, &u, zFrame3DAtt(frame) );
-  zMulMat3DVec3D( zFrame3DAtt(frame), &pgo, &dp );
-  zVec3DMulDRC( &dp, ( d.c.x + d.c.y + d.c.z ) / so );
-  zVec3DSub( &pg, &dp, zFrame3DPos(frame) );
-  return frame;
+  return _zVec3DIdentFrameSVD( &cov, so, &pgo, &pg, frame );
+}
+
+/* identify a transformation frame from two arrays of 3D points. */
+static zFrame3D *_zVec3DIdentFrameArray(const zVec3D src[], const zVec3D dest[], int num, zFrame3D *frame)
+{
+  zVec3D pgo, pg, dpo, dp;
+  zMat3D cov;
+  double so = 0;
+  int i;
+
+  zVec3DZero( &pgo );
+  zVec3DZero( &pg );
+  for( i=0; i<num; i++ ){
+    zVec3DAddDRC( &pgo, &src[i] );
+    zVec3DAddDRC( &pg, &dest[i] );
+  }
+  zVec3DDivDRC( &pgo, num );
+  zVec3DDivDRC( &pg, num );
+  zMat3DZero( &cov );
+  for( i=0; i<num; i++ ){
+    zVec3DSub( &src[i], &pgo, &dpo );
+    zVec3DSub( &dest[i], &pg, &dp );
+    so += zVec3DSqrNorm( &dpo );
+    zMat3DAddDyad( &cov, &dpo, &dp );
+  }
+  so /= num;
+  zMat3DDivDRC( &cov, num );
+  return _zVec3DIdentFrameSVD( &cov, so, &pgo, &pg, frame );
 }
 
 /* initialize transformation frame based on barycenters of two point clouds. */
@@ -130,39 +572,678 @@ static zFrame3D *_zVec3DDataICPInit(zVec3DData *src, zVec3DData *dest, zFrame3D
   return frame;
 }
 
+/* initialize an ICP engine. */
+zVec3DICP *zVec3DICPInit(zVec3DICP *icp)
+{
+  zVec3DFlatTreeInit( &icp->tree );
+  icp->capacity = 0;
+  icp->src = icp->dest = NULL;
+  icp->dist = NULL;
+  icp->reject_dist = 0;
+  icp->thread_num = 1;
+  icp->iter_num = 0;
+  zVec3DICPSetSeed( icp, 0 );
+  return icp;
+}
+
+/* create an ICP engine for a destination point cloud. */
+zVec3DICP *zVec3DICPCreate(zVec3DICP *icp, zVec3DData *dest, int thread_num)
+{
+  zVec3DICPInit( icp );
+  if( zVec3DDataSize(dest) < ZEO_VEC3DDATA_IDENT_FRAME_MINSIZ ){
+    ZRUNERROR( ZEO_ERR_VEC3DDATA_IDENTFRAME_TOOFEWPOINTS, zVec3DDataSize(dest) );
+    return NULL;
+  }
+  icp->thread_num = zParallelThreadNum( thread_num );
+  return zVec3DDataToFlatTree( dest, &icp->tree, 0 ) ? icp : NULL;
+}
+
+/* destroy an ICP engine. */
+void zVec3DICPDestroy(zVec3DICP *icp)
+{
+  zVec3DFlatTreeDestroy( &icp->tree );
+  zFree( icp->src );
+  zFree( icp->dest );
+  zFree( icp->dist );
+  zVec3DICPInit( icp );
+}
+
+/* enlarge arrays of corresponding points of an ICP engine. */
+static bool _zVec3DICPReserve(zVec3DICP *icp, int num)
+{
+  zVec3D *src, *dest;
+  double *dist;
+
+  if( num <= icp->capacity ) return true;
+  if( !( src = zRealloc( icp->src, zVec3D, num ) ) ) goto FAILURE;
+  icp->src = src;
+  if( !( dest = zRealloc( icp->dest, zVec3D, num ) ) ) goto FAILURE;
+  icp->dest = dest;
+  if( !( dist = zRealloc( icp->dist, double, num ) ) ) goto FAILURE;
+  icp->dist = dist;
+  icp->capacity = num;
+  return true;
+ FAILURE:
+  ZALLOCERROR();
+  return false;
+}
+
+typedef struct{
+  zVec3DICP *icp;
+  const zFrame3D *frame;
+} _zVec3DICPCorrespond;
+
+/* find corresponding points of a chunk of sampled points. */
+static void _zVec3DICPCorrespondChunk(void *util, int id, int start, int end)
+{
+  _zVec3DICPCorrespond *corr;
+  zVec3D p, *nn;
+  int i;
+
+  corr = (_zVec3DICPCorrespond *)util;
+  for( i=start; i<end; i++ ){
+    zXform3D( corr->frame, &corr->icp->src[i], &p );
+    corr->icp->dist[i] = zVec3DFlatTreeNN( &corr->icp->tree, &p, &nn );
+    zVec3DCopy( nn, &corr->icp->dest[i] );
+  }
+}
+
+/* run an ICP engine. */
+zFrame3D *zVec3DICPRun(zVec3DICP *icp, zVec3DData *src, zFrame3D *frame, double sample_rate, double tol)
+{
+  _zVec3DICPCorrespond corr;
+  zVec3DICPStat *stat;
+  zVec3D *po;
+  int i, num, inlier_num;
+
+  if( !_zVec3DICPReserve( icp, zVec3DDataSize(src) ) ) return NULL;
+  corr.icp = icp;
+  corr.frame = frame;
+  for( icp->iter_num=0; icp->iter_num<ZEO_VEC3DDATA_ICP_MAXITERNUM; ){
+    /* sampling */
+    zVec3DDataRewind( src );
+    for( num=0; ( po = zVec3DDataFetch( src ) ); )
+      if( zRandFMT( &icp->rand, 0, 1 ) <= sample_rate ) zVec3DCopy( po, &icp->src[num++] );
+    /* correspondence */
+    zParallelFor( num, icp->thread_num, _zVec3DICPCorrespondChunk, &corr );
+    /* rejection */
+    stat = &icp->stat[icp->iter_num++];
+    stat->num = num;
+    stat->rms = stat->error_max = 0;
+    for( inlier_num=0, i=0; i<num; i++ ){
+      if( icp->reject_dist > 0 && icp->dist[i] > icp->reject_dist ) continue;
+      stat->rms += zSqr( icp->dist[i] );
+      if( icp->dist[i] > stat->error_max ) stat->error_max = icp->dist[i];
+      if( inlier_num < i ){
+        zVec3DCopy( &icp->src[i], &icp->src[inlier_num] );
+        zVec3DCopy( &icp->dest[i], &icp->dest[inlier_num] );
+      }
+      inlier_num++;
+    }
+    if( ( stat->inlier_num = inlier_num ) < ZEO_VEC3DDATA_IDENT_FRAME_MINSIZ ){
+      ZRUNERROR( ZEO_ERR_VEC3DDATA_IDENTFRAME_TOOFEWPOINTS, inlier_num );
+      return NULL;
+    }
+    stat->rms = sqrt( stat->rms / inlier_num );
+    if( stat->error_max < tol ) return frame;
+    _zVec3DIdentFrameArray( icp->src, icp->dest, inlier_num, frame );
+  }
+  ZITERWARN( ZEO_VEC3DDATA_ICP_MAXITERNUM );
+  return frame;
+}
+
 /* iterative closest point method */
 zFrame3D *zVec3DDataICP(zVec3DData *src, zVec3DData *dest, zFrame3D *frame, double sample_rate, double tol)
 {
-  zVec3DTree dest_tree, *nn;
-  zVec3DData sample_src, sample_dest;
-  zVec3D *po, p;
+  zVec3DICP icp;
+  zFrame3D *retval = NULL;
+
+  if( zVec3DICPCreate( &icp, dest, 1 ) ){
+    zVec3DICPSetSeed( &icp, zRandI(0,INT_MAX) );
+    _zVec3DDataICPInit( src, dest, frame );
+    retval = zVec3DICPRun( &icp, src, frame, sample_rate, tol );
+  }
+  zVec3DICPDestroy( &icp );
+  return retval;
+}
+
+/* coarse-to-fine iterative closest point method */
+
+/* run the iterative closest point method at a level of a pyramid. */
+static zFrame3D *_zVec3DDataICPPyramidLevel(zVec3DData *src, zVec3DData *dest, zFrame3D *frame, double sample_rate, double tol, int thread_num)
+{
+  zVec3DICP icp;
+  zFrame3D *retval = NULL;
+
+  if( zVec3DICPCreate( &icp, dest, thread_num ) ){
+    zVec3DICPSetSeed( &icp, zRandI(0,INT_MAX) );
+    retval = zVec3DICPRun( &icp, src, frame, sample_rate, tol );
+  }
+  zVec3DICPDestroy( &icp );
+  return retval;
+}
+
+/* coarse-to-fine iterative closest point method */
+zFrame3D *zVec3DDataICPPyramid(zVec3DData *src, zVec3DData *dest, zFrame3D *frame, double pitch, int level_num, double sample_rate, double tol, int thread_num)
+{
+  zVec3DData src_level, dest_level;
+  zFrame3D *retval;
+  double pitch_level;
+  int i;
+
+  _zVec3DDataICPInit( src, dest, frame );
+  for( i=level_num-1; i>0; i-- ){
+    pitch_level = ldexp( pitch, i-1 );
+    if( !zVec3DDataVoxelDownsample( src, pitch_level, true, &src_level, thread_num ) ) return NULL;
+    if( !zVec3DDataVoxelDownsample( dest, pitch_level, true, &dest_level, thread_num ) ){
+      zVec3DDataDestroy( &src_level );
+      return NULL;
+    }
+    /* skip a level too coarse to identify the frame */
+    if( zVec3DDataSize(&src_level) < ZEO_VEC3DDATA_IDENT_FRAME_MINSIZ ||
+        zVec3DDataSize(&dest_level) < ZEO_VEC3DDATA_IDENT_FRAME_MINSIZ )
+      retval = frame;
+    else
+      retval = _zVec3DDataICPPyramidLevel( &src_level, &dest_level, frame, 1.0, tol + pitch_level, thread_num );
+    zVec3DDataDestroy( &src_level );
+    zVec3DDataDestroy( &dest_level );
+    if( !retval ) return NULL;
+  }
+  return _zVec3DDataICPPyramidLevel( src, dest, frame, sample_rate, tol, thread_num );
+}
+
+/* point-to-plane iterative closest point method */
+
+/* weight of a residual by a robust kernel. */
+static double _zVec3DDataICPWeight(zVec3DDataICPKernel kernel, double e, double width)
+{
+  double a;
+
+  if( width <= 0 ) return 1;
+  switch( kernel ){
+  case ZEO_VEC3DDATA_ICP_KERNEL_HUBER:
+    return ( a = fabs( e ) ) <= width ? 1 : width / a;
+  case ZEO_VEC3DDATA_ICP_KERNEL_TUKEY:
+    return ( a = zSqr( e / width ) ) < 1 ? zSqr( 1 - a ) : 0;
+  default: ;
+  }
+  return 1;
+}
+
+/* update a transformation frame by a small displacement (rotation in the first three components). */
+static zFrame3D *_zVec3DDataICPUpdate(zFrame3D *frame, zVec dx)
+{
+  zVec3D aa, dp;
+  zMat3D r;
+
+  zVec3DCreate( &aa, zVecElemNC(dx,0), zVecElemNC(dx,1), zVecElemNC(dx,2) );
+  zVec3DCreate( &dp, zVecElemNC(dx,3), zVecElemNC(dx,4), zVecElemNC(dx,5) );
+  zMat3DFromAA( &r, &aa );
+  zMulMat3DMat3D( &r, zFrame3DAtt(frame), zFrame3DAtt(frame) );
+  zMulMat3DVec3DDRC( &r, zFrame3DPos(frame) );
+  zVec3DAddDRC( zFrame3DPos(frame), &dp );
+  return frame;
+}
+
+/* Gauss-Newton method for a 6-DoF transformation frame */
+
+/* size of a buffer for each thread to accumulate the Hessian, the gradient, the cost and the number */
+#define _ZEO_VEC3DDATA_GN_BUFSIZ 44
+
+typedef struct{
+  int thread_num;
+  double *buf; /* buffers of threads */
+  zMat h;
+  zVec g, dx;
+} _zVec3DGN;
+
+#define _zVec3DGNBuf(gn,id) ( (gn)->buf + (id) * _ZEO_VEC3DDATA_GN_BUFSIZ )
+#define _zVec3DGNCost(gn)   (gn)->buf[42]
+#define _zVec3DGNNum(gn)    (int)(gn)->buf[43]
+
+/* allocate workspace of the Gauss-Newton method. */
+static bool _zVec3DGNAlloc(_zVec3DGN *gn, int thread_num)
+{
+  gn->thread_num = thread_num;
+  gn->buf = zAlloc( double, thread_num * _ZEO_VEC3DDATA_GN_BUFSIZ );
+  gn->h = zMatAllocSqr( 6 );
+  gn->g = zVecAlloc( 6 );
+  gn->dx = zVecAlloc( 6 );
+  if( !gn->buf || !gn->h || !gn->g || !gn->dx ){
+    ZALLOCERROR();
+    return false;
+  }
+  return true;
+}
+
+/* free workspace of the Gauss-Newton method. */
+static void _zVec3DGNFree(_zVec3DGN *gn)
+{
+  zFree( gn->buf );
+  zMatFree( gn->h );
+  zVecFree( gn->g );
+  zVecFree( gn->dx );
+}
+
+/* clear buffers of threads of the Gauss-Newton method. */
+static void _zVec3DGNClear(_zVec3DGN *gn)
+{
+  memset( gn->buf, 0, sizeof(double)*gn->thread_num*_ZEO_VEC3DDATA_GN_BUFSIZ );
+}
+
+/* accumulate w J^T M J and -w J^T M r of a transformed point p with a residual r to a buffer,
+ * where J is the Jacobian of p with respect to a small rotation and translation. */
+static void _zVec3DGNAccumulate(double *buf, const zVec3D *p, const zMat3D *m, const zVec3D *r, double w, double cost)
+{
+  zVec3D c[6], mc[6], mr;
+  int j, k;
+
+  for( j=0; j<3; j++ ){
+    zVec3DOuterProd( ZMAT3DIDENT->v+j, p, &c[j] );
+    zVec3DCopy( ZMAT3DIDENT->v+j, &c[j+3] );
+  }
+  for( j=0; j<6; j++ )
+    zMulMat3DVec3D( m, &c[j], &mc[j] );
+  zMulMat3DVec3D( m, r, &mr );
+  for( j=0; j<6; j++ ){
+    for( k=0; k<6; k++ )
+      buf[j*6+k] += w * zVec3DInnerProd( &c[j], &mc[k] );
+    buf[36+j] -= w * zVec3DInnerProd( &c[j], &mr );
+  }
+  buf[42] += cost;
+  buf[43]++;
+}
+
+/* reduce buffers of threads, solve the normal equation and update a transformation frame. */
+static zFrame3D *_zVec3DGNUpdate(_zVec3DGN *gn, zFrame3D *frame)
+{
+  int i, j;
+
+  for( i=1; i<gn->thread_num; i++ )
+    for( j=0; j<_ZEO_VEC3DDATA_GN_BUFSIZ; j++ )
+      gn->buf[j] += gn->buf[i*_ZEO_VEC3DDATA_GN_BUFSIZ+j];
+  if( _zVec3DGNNum(gn) < 6 ){
+    ZRUNERROR( ZEO_ERR_VEC3DDATA_IDENTFRAME_TOOFEWPOINTS, _zVec3DGNNum(gn) );
+    return NULL;
+  }
+  for( i=0; i<6; i++ ){
+    for( j=0; j<6; j++ )
+      zMatElemNC(gn->h,i,j) = gn->buf[i*6+j];
+    zMatElemNC(gn->h,i,i) += zTOL; /* regularization against degenerate scenes */
+    zVecElemNC(gn->g,i) = gn->buf[36+i];
+  }
+  if( !zLESolveGauss( gn->h, gn->g, gn->dx ) ) return NULL;
+  return _zVec3DDataICPUpdate( frame, gn->dx );
+}
+
+/* point-to-plane iterative closest point method */
+zFrame3D *zVec3DDataICPPointToPlane(zVec3DData *src, zVec3DData *dest, zVec3DData *normal, zFrame3D *frame, zVec3DDataICPKernel kernel, double width, double reject_dist, double tol)
+{
+  zVec3DFlatTree dest_tree;
+  zVec3D *po, p, *nn, *n, *nvec = NULL, dp;
+  zMat3D m;
+  _zVec3DGN gn;
+  double d, e, w;
   int i, iter = ZEO_VEC3DDATA_ICP_MAXITERNUM;
-  double error_max, error;
+  zFrame3D *retval = NULL;
 
-  if( !zVec3DDataToTree( dest, &dest_tree ) ){
-    zVec3DTreeDestroy( &dest_tree );
+  if( zVec3DDataSize(normal) != zVec3DDataSize(dest) ){
+    ZRUNERROR( ZEO_ERR_VEC3DDATA_SIZEMISMATCH, zVec3DDataSize(dest), zVec3DDataSize(normal) );
     return NULL;
   }
+  zVec3DFlatTreeInit( &dest_tree );
+  if( !_zVec3DGNAlloc( &gn, 1 ) ) goto TERMINATE;
+  if( !( nvec = zAlloc( zVec3D, zVec3DDataSize(normal) ) ) ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  if( !zVec3DDataToFlatTree( dest, &dest_tree, 0 ) ) goto TERMINATE;
+  /* normal vectors are referred by original indices of points in the tree */
+  zVec3DDataRewind( normal );
+  for( i=0; ( n = zVec3DDataFetch( normal ) ); i++ )
+    zVec3DCopy( n, &nvec[i] );
   _zVec3DDataICPInit( src, dest, frame );
   for( i=0; i<iter; i++ ){
-    zVec3DDataInitAddrList( &sample_src );
-    zVec3DDataInitAddrList( &sample_dest );
+    _zVec3DGNClear( &gn );
     zVec3DDataRewind( src );
-    error_max = 0;
     while( ( po = zVec3DDataFetch( src ) ) ){
-      if( zRandF(0,1) > sample_rate ) continue;
       zXform3D( frame, po, &p );
-      if( ( error = zVec3DTreeNN( &dest_tree, &p, &nn ) ) > error_max ) error_max = error;
-      zVec3DDataAdd( &sample_src, po );
-      zVec3DDataAdd( &sample_dest, &nn->data.point );
+      d = zVec3DFlatTreeNN( &dest_tree, &p, &nn );
+      if( !nn || ( reject_dist > 0 && d > reject_dist ) ) continue;
+      n = &nvec[zVec3DFlatTreePointID(&dest_tree,nn)];
+      zVec3DSub( &p, nn, &dp );
+      e = zVec3DInnerProd( n, &dp );
+      if( ( w = _zVec3DDataICPWeight( kernel, e, width ) ) == 0 ) continue;
+      /* the residual along the normal vector */
+      zMat3DDyad( &m, n, n );
+      _zVec3DGNAccumulate( _zVec3DGNBuf(&gn,0), &p, &m, &dp, w, w*e*e );
     }
-    if( error_max < tol ) break;
-    zVec3DDataIdentFrame( &sample_src, &sample_dest, frame );
-    zVec3DDataDestroy( &sample_src );
-    zVec3DDataDestroy( &sample_dest );
+    if( !_zVec3DGNUpdate( &gn, frame ) ) goto TERMINATE;
+    if( zVecIsTol( gn.dx, tol ) ) break;
   }
   if( i == iter )
     ZITERWARN( iter );
-  zVec3DTreeDestroy( &dest_tree );
-  return frame;
+  retval = frame;
+ TERMINATE:
+  zVec3DFlatTreeDestroy( &dest_tree );
+  zFree( nvec );
+  _zVec3DGNFree( &gn );
+  return retval;
+}
+
+/* normal distributions transform */
+
+/* create a Gaussian of a leaf of a flat octree. */
+static void _zVec3DNDTCellCreate(const zVec3DFlatOctree *tree, const zVec3DFlatOctreeNode *node, zVec3DNDTCell *cell)
+{
+  const zVec3DFlatOctreeLeaf *leaf;
+  zVec3D center, d, eigval, w;
+  zMat3D cov, eigbase;
+  double lmax;
+  int i;
+
+  cell->valid = false;
+  leaf = &tree->leaf[node->leaf];
+  if( leaf->num < ZEO_VEC3DDATA_NDT_CELL_MINSIZ ) return;
+  zVec3DZero( &cell->mean );
+  for( i=0; i<leaf->num; i++ )
+    zVec3DAddDRC( &cell->mean, zVec3DFlatOctreeLeafPoint(tree,leaf,i) );
+  zVec3DDivDRC( &cell->mean, leaf->num );
+  /* the covariance about the mean from that about the center of the leaf */
+  zAABox3DCenter( &node->region, &center );
+  zVec3DSub( &cell->mean, &center, &d );
+  zMat3DDiv( &leaf->ncov, leaf->num, &cov );
+  zMat3DSubDyad( &cov, &d, &d );
+  if( !zMat3DSymEig( &cov, &eigval, &eigbase ) ) return;
+  if( zIsTiny( ( lmax = _zMax( _zMax( eigval.c.x, eigval.c.y ), eigval.c.z ) ) ) ) return;
+  lmax *= ZEO_VEC3DDATA_NDT_EIG_RATIO; /* regularization of flat distributions */
+  zMat3DZero( &cell->icov );
+  for( i=0; i<3; i++ ){
+    zVec3DDiv( &eigbase.v[i], _zMax( eigval.e[i], lmax ), &w );
+    zMat3DAddDyad( &cell->icov, &w, &eigbase.v[i] );
+  }
+  cell->valid = true;
+}
+
+/* initialize an NDT map. */
+zVec3DNDT *zVec3DNDTInit(zVec3DNDT *ndt)
+{
+  zVec3DFlatOctreeInit( &ndt->tree );
+  ndt->cell = NULL;
+  ndt->thread_num = 1;
+  ndt->iter_num = 0;
+  ndt->num = 0;
+  ndt->score = 0;
+  return ndt;
+}
+
+/* create an NDT map of a destination point cloud. */
+zVec3DNDT *zVec3DNDTCreate(zVec3DNDT *ndt, zVec3DData *dest, double resolution, int thread_num)
+{
+  zAABox3D box;
+  int i;
+
+  zVec3DNDTInit( ndt );
+  if( zVec3DDataSize(dest) < ZEO_VEC3DDATA_NDT_CELL_MINSIZ ){
+    ZRUNERROR( ZEO_ERR_VEC3DDATA_IDENTFRAME_TOOFEWPOINTS, zVec3DDataSize(dest) );
+    return NULL;
+  }
+  ndt->thread_num = zParallelThreadNum( thread_num );
+  zVec3DDataAABB( dest, &box, NULL );
+  if( !zVec3DDataToFlatOctree( dest, &ndt->tree, zAABox3DXMin(&box), zAABox3DYMin(&box), zAABox3DZMin(&box), zAABox3DXMax(&box), zAABox3DYMax(&box), zAABox3DZMax(&box), resolution ) )
+    return NULL;
+  if( !( ndt->cell = zAlloc( zVec3DNDTCell, ndt->tree.leaf_num ) ) ){
+    ZALLOCERROR();
+    zVec3DNDTDestroy( ndt );
+    return NULL;
+  }
+  for( i=0; i<ndt->tree.node_num; i++ )
+    if( ndt->tree.node[i].leaf >= 0 )
+      _zVec3DNDTCellCreate( &ndt->tree, &ndt->tree.node[i], &ndt->cell[ndt->tree.node[i].leaf] );
+  return ndt;
+}
+
+/* destroy an NDT map. */
+void zVec3DNDTDestroy(zVec3DNDT *ndt)
+{
+  zVec3DFlatOctreeDestroy( &ndt->tree );
+  zFree( ndt->cell );
+  zVec3DNDTInit( ndt );
+}
+
+typedef struct{
+  const zVec3DNDT *ndt;
+  const zVec3D *point;
+  const zFrame3D *frame;
+  _zVec3DGN *gn;
+} _zVec3DNDTStep;
+
+/* accumulate the Hessian and the gradient of the score of a chunk of points. */
+static void _zVec3DNDTStepChunk(void *util, int id, int start, int end)
+{
+  _zVec3DNDTStep *step;
+  const zVec3DFlatOctreeLeaf *leaf;
+  const zVec3DNDTCell *cell;
+  zVec3D p, q, aq;
+  double e;
+  int i;
+
+  step = (_zVec3DNDTStep *)util;
+  for( i=start; i<end; i++ ){
+    zXform3D( step->frame, &step->point[i], &p );
+    if( !( leaf = zVec3DFlatOctreeFindContainer( &step->ndt->tree, &p ) ) ) continue;
+    cell = &step->ndt->cell[leaf-step->ndt->tree.leaf];
+    if( !cell->valid ) continue;
+    zVec3DSub( &p, &cell->mean, &q );
+    zMulMat3DVec3D( &cell->icov, &q, &aq );
+    e = exp( -0.5 * zVec3DInnerProd( &q, &aq ) );
+    _zVec3DGNAccumulate( _zVec3DGNBuf(step->gn,id), &p, &cell->icov, &q, e, e );
+  }
+}
+
+/* run registration of a point cloud to an NDT map. */
+zFrame3D *zVec3DNDTRun(zVec3DNDT *ndt, zVec3DData *src, zFrame3D *frame, double tol)
+{
+  _zVec3DNDTStep step;
+  _zVec3DGN gn;
+  zVec3D *v, *point = NULL;
+  int i, num;
+  zFrame3D *retval = NULL;
+
+  if( !_zVec3DGNAlloc( &gn, ndt->thread_num ) ) goto TERMINATE;
+  num = zVec3DDataSize(src);
+  if( !( point = zAlloc( zVec3D, num ) ) ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  zVec3DDataRewind( src );
+  for( i=0; ( v = zVec3DDataFetch( src ) ); i++ )
+    zVec3DCopy( v, &point[i] );
+  step.ndt = ndt;
+  step.point = point;
+  step.frame = frame;
+  step.gn = &gn;
+  for( ndt->iter_num=0; ndt->iter_num<ZEO_VEC3DDATA_NDT_MAXITERNUM; ){
+    ndt->iter_num++;
+    _zVec3DGNClear( &gn );
+    zParallelFor( num, ndt->thread_num, _zVec3DNDTStepChunk, &step );
+    retval = _zVec3DGNUpdate( &gn, frame );
+    ndt->score = _zVec3DGNCost(&gn);
+    ndt->num = _zVec3DGNNum(&gn);
+    if( !retval ) goto TERMINATE;
+    if( zVecIsTol( gn.dx, tol ) ) break;
+  }
+  if( ndt->iter_num == ZEO_VEC3DDATA_NDT_MAXITERNUM )
+    ZITERWARN( ZEO_VEC3DDATA_NDT_MAXITERNUM );
+  retval = frame;
+ TERMINATE:
+  zFree( point );
+  _zVec3DGNFree( &gn );
+  return retval;
+}
+
+/* generalized iterative closest point method */
+
+typedef struct{
+  zVec3DGICPCloud *cloud;
+  int k;
+  zVec3D **nn;  /* k neighbors for each thread */
+  double *dist; /* k distances for each thread */
+} _zVec3DGICPCov;
+
+/* regularized covariance of a point on a plane from that of its neighbors. */
+static zMat3D *_zVec3DGICPCovRegularize(const zMat3D *cov, zMat3D *reg)
+{
+  zVec3D eigval, w;
+  zMat3D eigbase;
+  int i, imin;
+
+  zMat3DSymEig( cov, &eigval, &eigbase );
+  imin = _zMat3DEigMinID( eigval.e );
+  zMat3DZero( reg );
+  for( i=0; i<3; i++ )
+    if( i == imin ){
+      zVec3DMul( &eigbase.v[i], ZEO_VEC3DDATA_GICP_EPSILON, &w );
+      zMat3DAddDyad( reg, &w, &eigbase.v[i] );
+    } else
+      zMat3DAddDyad( reg, &eigbase.v[i], &eigbase.v[i] );
+  return reg;
+}
+
+/* compute covariances of a chunk of points from their neighbors. */
+static void _zVec3DGICPCovChunk(void *util, int id, int start, int end)
+{
+  _zVec3DGICPCov *gc;
+  zVec3D **nn, mean, d;
+  double *dist;
+  zMat3D cov;
+  int i, j, n;
+
+  gc = (_zVec3DGICPCov *)util;
+  nn = gc->nn + id * gc->k;
+  dist = gc->dist + id * gc->k;
+  for( i=start; i<end; i++ ){
+    if( ( n = zVec3DFlatTreeKNN( &gc->cloud->tree, &gc->cloud->tree.point[i], gc->k, nn, dist ) ) < ZEO_VEC3DDATA_IDENT_FRAME_MINSIZ ){
+      zMat3DIdent( &gc->cloud->cov[i] ); /* isolated point */
+      continue;
+    }
+    zVec3DZero( &mean );
+    for( j=0; j<n; j++ ) zVec3DAddDRC( &mean, nn[j] );
+    zVec3DDivDRC( &mean, n );
+    zMat3DZero( &cov );
+    for( j=0; j<n; j++ ){
+      zVec3DSub( nn[j], &mean, &d );
+      zMat3DAddDyad( &cov, &d, &d );
+    }
+    zMat3DDivDRC( &cov, n );
+    _zVec3DGICPCovRegularize( &cov, &gc->cloud->cov[i] );
+  }
+}
+
+/* initialize a point cloud for the generalized iterative closest point method. */
+zVec3DGICPCloud *zVec3DGICPCloudInit(zVec3DGICPCloud *cloud)
+{
+  zVec3DFlatTreeInit( &cloud->tree );
+  cloud->cov = NULL;
+  return cloud;
+}
+
+/* create a point cloud with covariances for the generalized iterative closest point method. */
+zVec3DGICPCloud *zVec3DGICPCloudCreate(zVec3DGICPCloud *cloud, zVec3DData *data, int k, int thread_num)
+{
+  _zVec3DGICPCov gc;
+  zVec3DGICPCloud *retval = NULL;
+
+  zVec3DGICPCloudInit( cloud );
+  if( k <= 0 ) k = ZEO_VEC3DDATA_GICP_NUM;
+  thread_num = zParallelThreadNum( thread_num );
+  gc.cloud = cloud;
+  gc.k = k;
+  gc.nn = zAlloc( zVec3D*, thread_num * k );
+  gc.dist = zAlloc( double, thread_num * k );
+  if( !gc.nn || !gc.dist ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  if( !zVec3DDataToFlatTree( data, &cloud->tree, 0 ) ) goto TERMINATE;
+  if( !( cloud->cov = zAlloc( zMat3D, _zMax( cloud->tree.point_num, 1 ) ) ) ){
+    ZALLOCERROR();
+    zVec3DGICPCloudDestroy( cloud );
+    goto TERMINATE;
+  }
+  zParallelFor( cloud->tree.point_num, thread_num, _zVec3DGICPCovChunk, &gc );
+  retval = cloud;
+ TERMINATE:
+  zFree( gc.nn );
+  zFree( gc.dist );
+  return retval;
+}
+
+/* destroy a point cloud for the generalized iterative closest point method. */
+void zVec3DGICPCloudDestroy(zVec3DGICPCloud *cloud)
+{
+  zVec3DFlatTreeDestroy( &cloud->tree );
+  zFree( cloud->cov );
+  zVec3DGICPCloudInit( cloud );
+}
+
+typedef struct{
+  const zVec3DGICPCloud *src;
+  const zVec3DGICPCloud *dest;
+  const zFrame3D *frame;
+  double reject_dist;
+  _zVec3DGN *gn;
+} _zVec3DGICPStep;
+
+/* accumulate the Hessian and the gradient of the error of a chunk of points. */
+static void _zVec3DGICPStepChunk(void *util, int id, int start, int end)
+{
+  _zVec3DGICPStep *step;
+  zVec3D p, *nn, r, mr;
+  zMat3D rc, m;
+  double d;
+  int i;
+
+  step = (_zVec3DGICPStep *)util;
+  for( i=start; i<end; i++ ){
+    zXform3D( step->frame, &step->src->tree.point[i], &p );
+    d = zVec3DFlatTreeNN( &step->dest->tree, &p, &nn );
+    if( !nn || ( step->reject_dist > 0 && d > step->reject_dist ) ) continue;
+    /* inverse of the covariance of the residual */
+    zMulMat3DMat3D( zFrame3DAtt(step->frame), &step->src->cov[i], &rc );
+    zMulMat3DMat3DT( &rc, zFrame3DAtt(step->frame), &rc );
+    zMat3DAddDRC( &rc, &step->dest->cov[nn-step->dest->tree.point] );
+    if( !zMat3DInv( &rc, &m ) ) continue;
+    zVec3DSub( &p, nn, &r );
+    zMulMat3DVec3D( &m, &r, &mr );
+    _zVec3DGNAccumulate( _zVec3DGNBuf(step->gn,id), &p, &m, &r, 1, zVec3DInnerProd( &r, &mr ) );
+  }
+}
+
+/* generalized iterative closest point method */
+zFrame3D *zVec3DGICPRun(const zVec3DGICPCloud *src, const zVec3DGICPCloud *dest, zFrame3D *frame, double reject_dist, double tol, int thread_num)
+{
+  _zVec3DGICPStep step;
+  _zVec3DGN gn;
+  int iter;
+  zFrame3D *retval = NULL;
+
+  if( !_zVec3DGNAlloc( &gn, zParallelThreadNum( thread_num ) ) ) goto TERMINATE;
+  step.src = src;
+  step.dest = dest;
+  step.frame = frame;
+  step.reject_dist = reject_dist;
+  step.gn = &gn;
+  for( iter=0; iter<ZEO_VEC3DDATA_GICP_MAXITERNUM; iter++ ){
+    _zVec3DGNClear( &gn );
+    zParallelFor( src->tree.point_num, gn.thread_num, _zVec3DGICPStepChunk, &step );
+    if( !_zVec3DGNUpdate( &gn, frame ) ) goto TERMINATE;
+    if( zVecIsTol( gn.dx, tol ) ) break;
+  }
+  if( iter == ZEO_VEC3DDATA_GICP_MAXITERNUM )
+    ZITERWARN( ZEO_VEC3DDATA_GICP_MAXITERNUM );
+  retval = frame;
+ TERMINATE:
+  _zVec3DGNFree( &gn );
+  return retval;
 }
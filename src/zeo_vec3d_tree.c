@@ -134,6 +134,30 @@ double zVec3DTreeNN(const zVec3DTree *tree, const zVec3D *point, zVec3DTree **nn
   return _zVec3DTreeNN( tree, point, nn, &dmin );
 }
 
+/* an internal recursive call of the k-nearest neighbor search. */
+static void _zVec3DTreeKNN(const zVec3DTree *node, const zVec3D *point, zVec3DKNN *knn)
+{
+  int b;
+
+  if( zAABox3DSqrDistFromPoint( &node->data.region, point ) >= zVec3DKNNBound( knn ) ) return;
+  if( node->child[( b = _zVec3DTreeChooseBranch( node, point ) )] )
+    _zVec3DTreeKNN( node->child[b], point, knn );
+  zVec3DKNNAdd( knn, &node->data.point, zVec3DSqrDist( &node->data.point, point ) );
+  if( node->child[1-b] )
+    _zVec3DTreeKNN( node->child[1-b], point, knn );
+}
+
+/* find k-nearest neighbors of a 3D vector in a tree. */
+int zVec3DTreeKNN(const zVec3DTree *tree, const zVec3D *point, int k, zVec3D *nn[], double dist[])
+{
+  zVec3DKNN knn;
+
+  zVec3DKNNInit( &knn, k, nn, dist );
+  if( tree->data.split != zAxisInvalid )
+    _zVec3DTreeKNN( tree, point, &knn );
+  return zVec3DKNNFinish( &knn );
+}
+
 /* test if a node is in the vicinity of a 3D vector. */
 static bool _zVec3DTreeVicinityTest(const zVec3DTree *node, const zVec3D *p, double radius_sqr, zVec3DData *vicinity)
 {
@@ -301,3 +325,154 @@ void zVec3DTreeValueFPrint(FILE *fp, const zVec3DTree *tree)
   if( tree->child[1] )
     zVec3DTreeValueFPrint( fp, tree->child[1] );
 }
+
+/* flat kd-tree */
+
+/* initialize a flat kd-tree. */
+zVec3DFlatTree *zVec3DFlatTreeInit(zVec3DFlatTree *tree)
+{
+  zAABox3DTreeInit( &tree->boxtree );
+  tree->point_num = 0;
+  tree->point = NULL;
+  tree->leafsize = ZEO_VEC3D_FLATTREE_DEFAULT_LEAFSIZE;
+  return tree;
+}
+
+/* destroy a flat kd-tree. */
+void zVec3DFlatTreeDestroy(zVec3DFlatTree *tree)
+{
+  zAABox3DTreeDestroy( &tree->boxtree );
+  zFree( tree->point );
+  zVec3DFlatTreeInit( tree );
+}
+
+/* build a balanced kd-tree from a set of 3D vectors. */
+zVec3DFlatTree *zVec3DDataToFlatTree(zVec3DData *pointdata, zVec3DFlatTree *tree, int leafsize)
+{
+  zVec3D *v, *point;
+  int i;
+
+  zVec3DFlatTreeInit( tree );
+  if( leafsize > 0 ) tree->leafsize = leafsize;
+  if( zVec3DDataIsEmpty( pointdata ) ) return tree;
+  point = zAlloc( zVec3D, zVec3DDataSize(pointdata) );
+  tree->point = zAlloc( zVec3D, zVec3DDataSize(pointdata) );
+  if( !point || !tree->point ){
+    ZALLOCERROR();
+    goto FAILURE;
+  }
+  zVec3DDataRewind( pointdata );
+  while( ( v = zVec3DDataFetch( pointdata ) ) )
+    zVec3DCopy( v, &point[tree->point_num++] );
+  if( !zAABox3DTreeCreate( &tree->boxtree, NULL, point, tree->point_num, tree->leafsize ) ) goto FAILURE;
+  for( i=0; i<tree->point_num; i++ )
+    zVec3DCopy( &point[tree->boxtree.index[i]], &tree->point[i] );
+  zFree( point );
+  return tree;
+
+ FAILURE:
+  zFree( point );
+  zVec3DFlatTreeDestroy( tree );
+  return NULL;
+}
+
+/* find the nearest neighbor of a 3D point in a subtree of a flat kd-tree. */
+static void _zVec3DFlatTreeNN(const zVec3DFlatTree *tree, int n, const zVec3D *point, zVec3D **nn, double *dmin_sqr)
+{
+  const zAABox3DTreeNode *node;
+  double d0, d1, d_sqr;
+  int i;
+
+  node = &tree->boxtree.node[n];
+  if( zAABox3DTreeNodeIsLeaf( node ) ){
+    for( i=node->start; i<node->start+node->num; i++ )
+      if( ( d_sqr = zVec3DSqrDist( &tree->point[i], point ) ) < *dmin_sqr ){
+        *nn = &tree->point[i];
+        *dmin_sqr = d_sqr;
+      }
+    return;
+  }
+  /* visit the nearer child first */
+  d0 = zAABox3DSqrDistFromPoint( &tree->boxtree.node[node->child[0]].box, point );
+  d1 = zAABox3DSqrDistFromPoint( &tree->boxtree.node[node->child[1]].box, point );
+  if( d0 <= d1 ){
+    if( d0 < *dmin_sqr ) _zVec3DFlatTreeNN( tree, node->child[0], point, nn, dmin_sqr );
+    if( d1 < *dmin_sqr ) _zVec3DFlatTreeNN( tree, node->child[1], point, nn, dmin_sqr );
+  } else{
+    if( d1 < *dmin_sqr ) _zVec3DFlatTreeNN( tree, node->child[1], point, nn, dmin_sqr );
+    if( d0 < *dmin_sqr ) _zVec3DFlatTreeNN( tree, node->child[0], point, nn, dmin_sqr );
+  }
+}
+
+/* find the nearest neighbor of a 3D point in a flat kd-tree. */
+double zVec3DFlatTreeNN(const zVec3DFlatTree *tree, const zVec3D *point, zVec3D **nn)
+{
+  double dmin_sqr = HUGE_VAL;
+
+  *nn = NULL;
+  if( tree->boxtree.node_num == 0 ) return HUGE_VAL;
+  _zVec3DFlatTreeNN( tree, 0, point, nn, &dmin_sqr );
+  return sqrt( dmin_sqr );
+}
+
+/* find vicinity of a 3D point in a subtree of a flat kd-tree. */
+static zVec3DData *_zVec3DFlatTreeVicinity(const zVec3DFlatTree *tree, int n, const zVec3D *point, double radius_sqr, zVec3DData *vicinity)
+{
+  const zAABox3DTreeNode *node;
+  int i;
+
+  node = &tree->boxtree.node[n];
+  if( zAABox3DSqrDistFromPoint( &node->box, point ) >= radius_sqr ) return vicinity;
+  if( zAABox3DTreeNodeIsLeaf( node ) ){
+    for( i=node->start; i<node->start+node->num; i++ )
+      if( zVec3DSqrDist( &tree->point[i], point ) < radius_sqr )
+        if( !zVec3DDataAdd( vicinity, &tree->point[i] ) ) return NULL;
+    return vicinity;
+  }
+  if( !_zVec3DFlatTreeVicinity( tree, node->child[0], point, radius_sqr, vicinity ) ) return NULL;
+  return _zVec3DFlatTreeVicinity( tree, node->child[1], point, radius_sqr, vicinity );
+}
+
+/* find vicinity of a 3D point in a flat kd-tree. */
+zVec3DData *zVec3DFlatTreeVicinity(const zVec3DFlatTree *tree, const zVec3D *point, double radius, zVec3DData *vicinity)
+{
+  zVec3DDataInitAddrList( vicinity );
+  if( tree->boxtree.node_num == 0 ) return vicinity;
+  return _zVec3DFlatTreeVicinity( tree, 0, point, _zSqr(radius), vicinity );
+}
+
+/* find k-nearest neighbors of a 3D point in a subtree of a flat kd-tree. */
+static void _zVec3DFlatTreeKNN(const zVec3DFlatTree *tree, int n, const zVec3D *point, zVec3DKNN *knn)
+{
+  const zAABox3DTreeNode *node;
+  double d0, d1;
+  int i;
+
+  node = &tree->boxtree.node[n];
+  if( zAABox3DTreeNodeIsLeaf( node ) ){
+    for( i=node->start; i<node->start+node->num; i++ )
+      zVec3DKNNAdd( knn, &tree->point[i], zVec3DSqrDist( &tree->point[i], point ) );
+    return;
+  }
+  /* visit the nearer child first */
+  d0 = zAABox3DSqrDistFromPoint( &tree->boxtree.node[node->child[0]].box, point );
+  d1 = zAABox3DSqrDistFromPoint( &tree->boxtree.node[node->child[1]].box, point );
+  if( d0 <= d1 ){
+    if( d0 < zVec3DKNNBound( knn ) ) _zVec3DFlatTreeKNN( tree, node->child[0], point, knn );
+    if( d1 < zVec3DKNNBound( knn ) ) _zVec3DFlatTreeKNN( tree, node->child[1], point, knn );
+  } else{
+    if( d1 < zVec3DKNNBound( knn ) ) _zVec3DFlatTreeKNN( tree, node->child[1], point, knn );
+    if( d0 < zVec3DKNNBound( knn ) ) _zVec3DFlatTreeKNN( tree, node->child[0], point, knn );
+  }
+}
+
+/* find k-nearest neighbors of a 3D point in a flat kd-tree. */
+int zVec3DFlatTreeKNN(const zVec3DFlatTree *tree, const zVec3D *point, int k, zVec3D *nn[], double dist[])
+{
+  zVec3DKNN knn;
+
+  zVec3DKNNInit( &knn, k, nn, dist );
+  if( tree->boxtree.node_num > 0 )
+    _zVec3DFlatTreeKNN( tree, 0, point, &knn );
+  return zVec3DKNNFinish( &knn );
+}
@@ -113,11 +113,57 @@ void assert_inside(void)
   zAssert( zBox3DPointIsInside, nitest == ni && notest == no );
 }
 
+#define N 200
+
+bool check_aabox_tree(const zAABox3DTree *tree, int n, const zAABox3D box[], int start, int num, int leafsize)
+{
+  const zAABox3DTreeNode *node;
+  int i;
+
+  node = &tree->node[n];
+  if( node->start != start || node->num != num ) return false;
+  for( i=node->start; i<node->start+node->num; i++ )
+    if( !zAABox3DPointIsInside( &node->box, &box[tree->index[i]].min, zTOL ) ||
+        !zAABox3DPointIsInside( &node->box, &box[tree->index[i]].max, zTOL ) ) return false;
+  if( zAABox3DTreeNodeIsLeaf( node ) ) return node->num <= leafsize;
+  return check_aabox_tree( tree, node->child[0], box, start, tree->node[node->child[0]].num, leafsize ) &&
+         check_aabox_tree( tree, node->child[1], box, start + tree->node[node->child[0]].num, num - tree->node[node->child[0]].num, leafsize );
+}
+
+void assert_aabox_tree(void)
+{
+  zAABox3DTree tree;
+  zAABox3D box[N];
+  zVec3D center[N], v;
+  bool count[N];
+  bool result = true;
+  int i;
+
+  for( i=0; i<N; i++ ){
+    zVec3DCreate( &box[i].min, zRandF(-10,10), zRandF(-10,10), zRandF(-10,10) );
+    zVec3DCopy( &box[i].min, &box[i].max );
+    zVec3DCreate( &v, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DAddDRC( &v, &box[i].min );
+    zAABox3DEnlarge( &box[i], &v );
+    zAABox3DCenter( &box[i], &center[i] );
+    count[i] = false;
+  }
+  zAABox3DTreeCreate( &tree, box, center, N, 4 );
+  for( i=0; i<N; i++ ){
+    if( count[tree.index[i]] ) result = false;
+    count[tree.index[i]] = true;
+  }
+  zAssert( zAABox3DTreeCreate (permutation), result );
+  zAssert( zAABox3DTreeCreate (nodes), check_aabox_tree( &tree, 0, box, 0, N, 4 ) );
+  zAABox3DTreeDestroy( &tree );
+}
+
 int main(void)
 {
   zRandInit();
   assert_vert();
   assert_volume_inertia();
   assert_inside();
+  assert_aabox_tree();
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,217 @@
+#include <zeo/zeo.h>
+
+#define N 200
+
+void box_rand(zAABox3D *box)
+{
+  zVec3D center;
+
+  zVec3DCreate( &center, zRandF(-5,5), zRandF(-5,5), zRandF(-5,5) );
+  zAABox3DCreateFromSize( box, &center, zRandF(0.1,1), zRandF(0.1,1), zRandF(0.1,1) );
+}
+
+bool pair_find(zColPairSet *ps, int id1, int id2)
+{
+  int i;
+
+  for( i=0; i<zColPairSetNum(ps); i++ )
+    if( zColPairSetElem(ps,i)->id1 == id1 && zColPairSetElem(ps,i)->id2 == id2 ) return true;
+  return false;
+}
+
+int pair_brute(zAABox3D box[], zColPairSet *ps)
+{
+  int i, j;
+
+  zColPairSetClear( ps );
+  for( i=0; i<N; i++ )
+    for( j=i+1; j<N; j++ )
+      if( zColChkAABox3D( &box[i], &box[j] ) ) zColPairSetAdd( ps, i, j );
+  return zColPairSetNum(ps);
+}
+
+bool pair_include(zColPairSet *ps, zColPairSet *ps_sub)
+{
+  int i;
+
+  for( i=0; i<zColPairSetNum(ps_sub); i++ )
+    if( !pair_find( ps, zColPairSetElem(ps_sub,i)->id1, zColPairSetElem(ps_sub,i)->id2 ) ) return false;
+  return true;
+}
+
+void assert_sap(void)
+{
+  zAABox3D box[N];
+  zColSAP sap;
+  zColPairSet ps, ps_brute;
+  zVec3D d;
+  int i, k;
+  bool result = true;
+
+  zColPairSetInit( &ps );
+  zColPairSetInit( &ps_brute );
+  zColSAPAlloc( &sap, N );
+  for( i=0; i<N; i++ ){
+    box_rand( &box[i] );
+    zColSAPSetBox( &sap, i, &box[i] );
+  }
+  for( k=0; k<10; k++ ){
+    if( zColSAPPair( &sap, &ps ) != pair_brute( box, &ps_brute ) ||
+        !pair_include( &ps, &ps_brute ) ) result = false;
+    for( i=0; i<N; i++ ){ /* move bodies slightly */
+      zVec3DCreate( &d, zRandF(-0.1,0.1), zRandF(-0.1,0.1), zRandF(-0.1,0.1) );
+      zVec3DAddDRC( &box[i].min, &d );
+      zVec3DAddDRC( &box[i].max, &d );
+      zColSAPSetBox( &sap, i, &box[i] );
+    }
+  }
+  zAssert( zColSAPPair, result );
+  zColSAPDestroy( &sap );
+  zColPairSetDestroy( &ps );
+  zColPairSetDestroy( &ps_brute );
+}
+
+void assert_aabbtree(void)
+{
+  zAABox3D box[N], qbox;
+  zColAABBTree tree;
+  zColPairSet ps, ps_brute;
+  zVec3D d;
+  int leaf[N], id[N];
+  int i, j, k, n;
+  bool result_pair = true, result_query = true;
+
+  zColPairSetInit( &ps );
+  zColPairSetInit( &ps_brute );
+  zColAABBTreeInit( &tree, 0.05 );
+  for( i=0; i<N; i++ ){
+    box_rand( &box[i] );
+    leaf[i] = zColAABBTreeInsert( &tree, &box[i], i );
+  }
+  for( k=0; k<10; k++ ){
+    zColAABBTreePair( &tree, &ps );
+    pair_brute( box, &ps_brute );
+    if( !pair_include( &ps, &ps_brute ) ) result_pair = false;
+    box_rand( &qbox );
+    n = zColAABBTreeQuery( &tree, &qbox, id, N );
+    for( i=0; i<N; i++ ){
+      if( !zColChkAABox3D( &box[i], &qbox ) ) continue;
+      for( j=0; j<n; j++ )
+        if( id[j] == i ) break;
+      if( j == n ) result_query = false;
+    }
+    for( i=0; i<N; i++ ){ /* move bodies */
+      zVec3DCreate( &d, zRandF(-0.1,0.1), zRandF(-0.1,0.1), zRandF(-0.1,0.1) );
+      zVec3DAddDRC( &box[i].min, &d );
+      zVec3DAddDRC( &box[i].max, &d );
+      zColAABBTreeMove( &tree, leaf[i], &box[i] );
+    }
+  }
+  for( i=0; i<N; i+=2 ) zColAABBTreeRemove( &tree, leaf[i] );
+  zColAABBTreePair( &tree, &ps );
+  for( i=0; i<zColPairSetNum(&ps); i++ )
+    if( zColPairSetElem(&ps,i)->id1 % 2 == 0 || zColPairSetElem(&ps,i)->id2 % 2 == 0 ) result_pair = false;
+  zAssert( zColAABBTreePair, result_pair );
+  zAssert( zColAABBTreeQuery, result_query );
+  zColAABBTreeDestroy( &tree );
+  zColPairSetDestroy( &ps );
+  zColPairSetDestroy( &ps_brute );
+}
+
+#define NB 20
+
+void shape_rand(zShape3D *shape, int i)
+{
+  zVec3D center, p;
+
+  zVec3DCreate( &center, zRandF(-1.5,1.5), zRandF(-1.5,1.5), zRandF(-1.5,1.5) );
+  switch( i % 3 ){
+  case 0:
+    zShape3DSphereCreate( shape, &center, zRandF(0.1,0.5), 0 ); break;
+  case 1:
+    zShape3DBoxCreateAlign( shape, &center, zRandF(0.1,1), zRandF(0.1,1), zRandF(0.1,1) ); break;
+  default:
+    zVec3DCreate( &p, zRandF(-0.5,0.5), zRandF(-0.5,0.5), zRandF(-0.5,0.5) );
+    zVec3DAddDRC( &p, &center );
+    zShape3DCapsuleCreate( shape, &center, &p, zRandF(0.1,0.3), 0 );
+  }
+}
+
+bool batch_check_shape(zShape3D shape[], zColPairSet *ps, zColResult result[])
+{
+  zColPair *pair;
+  zVec3D c1, c2;
+  int i;
+
+  for( i=0; i<zColPairSetNum(ps); i++ ){
+    pair = zColPairSetElem(ps,i);
+    if( result[i].flag != zColChkShape3D( &shape[pair->id1], &shape[pair->id2] ) ) return false;
+    if( zColShape3D( &shape[pair->id1], &shape[pair->id2], &c1, &c2 ) ) continue;
+    if( !zIsTol( zVec3DDist( &result[i].c1, &result[i].c2 ) - zVec3DDist( &c1, &c2 ), 1.0e-6 ) ) return false;
+  }
+  return true;
+}
+
+bool batch_check_ph(zPH3D ph[], zColPairSet *ps, zColResult result[])
+{
+  zColPair *pair;
+  zVec3D c1, c2;
+  int i;
+
+  for( i=0; i<zColPairSetNum(ps); i++ ){
+    pair = zColPairSetElem(ps,i);
+    if( result[i].flag != zColChkPH3D( &ph[pair->id1], &ph[pair->id2], &c1, &c2 ) ) return false;
+    if( !result[i].flag &&
+        !zIsTol( zVec3DDist( &result[i].c1, &result[i].c2 ) - zVec3DDist( &c1, &c2 ), 1.0e-6 ) ) return false;
+  }
+  return true;
+}
+
+void assert_batch(void)
+{
+  zShape3D shape[NB], shape_ph[NB];
+  zPH3D ph[NB];
+  zColPairSet ps;
+  zColResult result[NB*(NB-1)/2];
+  int i, j, k, count;
+  int thread_num[] = { 1, 4 };
+  bool result_shape = true, result_ph = true;
+
+  zColPairSetInit( &ps );
+  for( i=0; i<NB; i++ ){
+    shape_rand( &shape[i], i );
+    zShape3DClone( &shape[i], &shape_ph[i], NULL );
+    zShape3DToPH( &shape_ph[i] );
+    zCopy( zPH3D, zShape3DPH(&shape_ph[i]), &ph[i] );
+  }
+  for( i=0; i<NB; i++ )
+    for( j=i+1; j<NB; j++ ) zColPairSetAdd( &ps, i, j );
+  for( k=0; k<2; k++ ){
+    count = zColBatchShape3D( shape, NULL, &ps, ZEO_COL_GJK, result, thread_num[k] );
+    if( !batch_check_shape( shape, &ps, result ) ) result_shape = false;
+    for( j=0, i=0; i<zColPairSetNum(&ps); i++ )
+      if( result[i].flag ) j++;
+    if( count != j ) result_shape = false;
+    count = zColBatchPH3D( ph, NULL, &ps, ZEO_COL_GJK, result, thread_num[k] );
+    if( !batch_check_ph( ph, &ps, result ) ) result_ph = false;
+    for( j=0, i=0; i<zColPairSetNum(&ps); i++ )
+      if( result[i].flag ) j++;
+    if( count != j ) result_ph = false;
+  }
+  zAssert( zColBatchShape3D (single/multiple threads), result_shape );
+  zAssert( zColBatchPH3D (single/multiple threads), result_ph );
+  for( i=0; i<NB; i++ ){
+    zShape3DDestroy( &shape[i] );
+    zShape3DDestroy( &shape_ph[i] );
+  }
+  zColPairSetDestroy( &ps );
+}
+
+int main(void)
+{
+  zRandInit();
+  assert_sap();
+  assert_aabbtree();
+  assert_batch();
+  return 0;
+}
@@ -89,10 +89,45 @@ void assert_inside(void)
   zAssert( zEllips3DPointIsInside, nitest == ni && notest == no );
 }
 
+/* closest point test */
+
+void assert_closest(void)
+{
+  zEllips3D ellips;
+  zVec3D p[100], cp[100], c, d, n, e;
+  double dist[100], l[3], r;
+  int i, k, n_test = 100;
+  bool result = true, result_batch = true;
+
+  generate_ellips_rand( &ellips );
+  for( i=0; i<n_test; i++ ){
+    while( ellips_cat( &ellips, zRandF(-10,10), zRandF(-10,10), zRandF(-10,10), &p[i] ) );
+    zEllips3DClosest( &ellips, &p[i], &c );
+    /* the closest point lies on the surface, and the normal there directs to the point */
+    zVec3DSub( &c, zEllips3DCenter(&ellips), &d );
+    for( r=0, k=0; k<3; k++ ){
+      l[k] = zVec3DInnerProd( &d, zEllips3DAxis(&ellips,k) );
+      r += zSqr( l[k] / zEllips3DRadius(&ellips,k) );
+    }
+    zVec3DZero( &n );
+    for( k=0; k<3; k++ )
+      zVec3DCatDRC( &n, l[k]/zSqr(zEllips3DRadius(&ellips,k)), zEllips3DAxis(&ellips,k) );
+    zVec3DSub( &p[i], &c, &d );
+    zVec3DOuterProd( &n, &d, &e );
+    if( !zIsTol( r - 1, 1.0e-6 ) || !zIsTol( zVec3DNorm(&e) / ( zVec3DNorm(&n) * zVec3DNorm(&d) ), 1.0e-6 ) ) result = false;
+  }
+  zEllips3DClosestBatch( &ellips, p, n_test, cp, dist, 0 );
+  for( i=0; i<n_test; i++ )
+    if( !zIsTiny( zEllips3DClosest( &ellips, &p[i], &c ) - dist[i] ) || !zVec3DEqual( &c, &cp[i] ) ) result_batch = false;
+  zAssert( zEllips3DClosest, result );
+  zAssert( zEllips3DClosestBatch, result_batch );
+}
+
 int main(void)
 {
   zRandInit();
   assert_volume_inertia();
   assert_inside();
+  assert_closest();
   return EXIT_SUCCESS;
 }
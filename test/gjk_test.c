@@ -125,9 +125,343 @@ void assert_point_plane(void)
   zAssert( zGJKPoint (plane case 4), zGJKPoint( &data, &p, &c ) == false && zVec3DEqual( &c, &c_answer ) );
 }
 
+void assert_shape(void)
+{
+  zShape3D sphere1, sphere2;
+  zFrame3D frame1, frame2;
+  zVec3D c1, c2, p;
+  double r1, r2, d;
+  int i;
+  bool result = true;
+
+  zShape3DSphereCreate( &sphere1, ZVEC3DZERO, ( r1 = zRandF(0.1,1) ), 0 );
+  zShape3DSphereCreate( &sphere2, ZVEC3DZERO, ( r2 = zRandF(0.1,1) ), 0 );
+  zFrame3DIdent( &frame1 );
+  zFrame3DIdent( &frame2 );
+  for( i=0; i<100; i++ ){
+    zVec3DCreate( &p, zRandF(-3,3), zRandF(-3,3), zRandF(-3,3) );
+    zFrame3DSetPos( &frame2, &p );
+    d = zVec3DNorm( &p ) - r1 - r2;
+    if( zGJKShape3D( &sphere1, &frame1, &sphere2, &frame2, &c1, &c2 ) != ( d <= 0 ) ) result = false;
+    if( d > 0 && !zIsTol( zVec3DDist( &c1, &c2 ) - d, 1.0e-4 ) ) result = false;
+  }
+  zAssert( zGJKShape3D (sphere-sphere), result );
+  zShape3DDestroy( &sphere1 );
+  zShape3DDestroy( &sphere2 );
+}
+
+void assert_shape_ellips(void)
+{
+  zShape3D ellips, box;
+  zVec3D center, c1, c2;
+  double r[3], gap, size;
+  int i, k;
+  bool result = true;
+
+  for( i=0; i<100; i++ ){
+    r[0] = zRandF(0.1,1); r[1] = zRandF(0.1,1); r[2] = zRandF(0.1,1);
+    zShape3DEllipsCreateAlign( &ellips, ZVEC3DZERO, r[0], r[1], r[2], 0 );
+    /* a box facing an end of a principal axis of the ellipsoid */
+    k = zRandI(0,2);
+    gap = zRandF(-0.05,0.5);
+    size = zRandF(0.1,1);
+    zVec3DZero( &center );
+    center.e[k] = r[k] + gap + 0.5*size;
+    zShape3DBoxCreateAlign( &box, &center, size, size, size );
+    if( zGJKShape3D( &ellips, NULL, &box, NULL, &c1, &c2 ) != ( gap <= 0 ) ) result = false;
+    if( gap > 0 && !zIsTol( zVec3DDist( &c1, &c2 ) - gap, 1.0e-4 ) ) result = false;
+    zShape3DDestroy( &ellips );
+    zShape3DDestroy( &box );
+  }
+  zAssert( zGJKShape3D (box-ellipsoid), result );
+}
+
+void assert_shape_degenerate(void)
+{
+  zShape3D box1, box2, sphere1, sphere2;
+  zPH3D empty;
+  zColSupport sup1, sup2;
+  zVec3D center, c1, c2, dir;
+  double depth;
+  bool result_touch, result_concentric, result_empty;
+
+  /* boxes touching at faces */
+  zShape3DBoxCreateAlign( &box1, ZVEC3DZERO, 1, 1, 1 );
+  zVec3DCreate( &center, 1, 0.3, -0.2 );
+  zShape3DBoxCreateAlign( &box2, &center, 1, 1, 1 );
+  result_touch = zGJKShape3D( &box1, NULL, &box2, NULL, &c1, &c2 ) &&
+    zIsTol( c1.c.x - 0.5, 1.0e-6 ) && zIsTol( c2.c.x - 0.5, 1.0e-6 );
+  /* concentric spheres */
+  zShape3DSphereCreate( &sphere1, ZVEC3DZERO, 0.5, 0 );
+  zShape3DSphereCreate( &sphere2, ZVEC3DZERO, 0.2, 0 );
+  result_concentric = zGJKShape3D( &sphere1, NULL, &sphere2, NULL, &c1, &c2 );
+  /* an empty polyhedron, whose support map fails */
+  zPH3DInit( &empty );
+  zColSupportAssignShape3D( &sup1, &sphere1, NULL );
+  zColSupportAssignPH3D( &sup2, &empty, NULL );
+  result_empty = !zMPRSupport( &sup1, &sup2 ) && !zMPRSupport( &sup2, &sup1 ) &&
+    !zMPRDepthSupport( &sup1, &sup2, &depth, &c1, &dir );
+  zShape3DDestroy( &box1 );
+  zShape3DDestroy( &box2 );
+  zShape3DDestroy( &sphere1 );
+  zShape3DDestroy( &sphere2 );
+  zAssert( zGJKShape3D (touching boxes), result_touch );
+  zAssert( zGJKShape3D (concentric spheres), result_concentric );
+  zAssert( zMPRSupport (empty polyhedron), result_empty );
+}
+
+void assert_warmstart(void)
+{
+  zShape3D box, ellips;
+  zFrame3D frame1, frame2;
+  zColSupport sup1, sup2;
+  zGJKCache cache;
+  zVec3D c1, c2, cw1, cw2;
+  double t;
+  int i;
+  bool flag, result = true;
+
+  zShape3DBoxCreateAlign( &box, ZVEC3DZERO, 1, 1, 1 );
+  zShape3DEllipsCreateAlign( &ellips, ZVEC3DZERO, 0.3, 0.2, 0.4, 0 );
+  zFrame3DFromPosZYX( &frame1, 0, 0, 0, zDeg2Rad(30), zDeg2Rad(20), zDeg2Rad(10) );
+  zGJKCacheInit( &cache );
+  /* the ellipsoid moves around the box by small steps */
+  for( i=0; i<200; i++ ){
+    t = zPIx2 * i / 200;
+    zFrame3DFromPosZYX( &frame2, 1.2*cos(t), 1.2*sin(t), 0.2*sin(3*t), t, 0.5*t, 0 );
+    zColSupportAssignShape3D( &sup1, &box, &frame1 );
+    zColSupportAssignShape3D( &sup2, &ellips, &frame2 );
+    flag = zGJKSupport( &sup1, &sup2, &c1, &c2 );
+    if( zGJKSupportWarmStart( &sup1, &sup2, &cache, &cw1, &cw2 ) != flag ){
+      result = false;
+      continue;
+    }
+    if( !flag &&
+        ( !zVec3DIsTol( zVec3DSub( &c1, &cw1, &c1 ), 1.0e-4 ) ||
+          !zVec3DIsTol( zVec3DSub( &c2, &cw2, &c2 ), 1.0e-4 ) ) ) result = false;
+  }
+  zShape3DDestroy( &box );
+  zShape3DDestroy( &ellips );
+  zAssert( zGJKSupportWarmStart (cold start vs. warm start), result );
+}
+
+void assert_toi(void)
+{
+  zShape3D sphere1, sphere2;
+  zFrame3D frame1_s, frame1_e, frame2;
+  zVec3D c1, c2, v, dp;
+  double r1, r2, t[2], toi;
+  int i, n;
+  bool result = true;
+
+  zShape3DSphereCreate( &sphere1, ZVEC3DZERO, ( r1 = zRandF(0.1,0.5) ), 0 );
+  zShape3DSphereCreate( &sphere2, ZVEC3DZERO, ( r2 = zRandF(0.1,0.5) ), 0 );
+  zFrame3DIdent( &frame1_s );
+  zFrame3DIdent( &frame1_e );
+  zFrame3DIdent( &frame2 );
+  for( i=0; i<100; i++ ){
+    zVec3DCreate( &v, zRandF(-3,3), zRandF(-3,3), zRandF(-3,3) );
+    zFrame3DSetPos( &frame1_s, &v );
+    zVec3DCreate( &v, zRandF(-3,3), zRandF(-3,3), zRandF(-3,3) );
+    zFrame3DSetPos( &frame1_e, &v );
+    zVec3DSub( zFrame3DPos(&frame1_e), zFrame3DPos(&frame1_s), &dp );
+    n = zQuadraticRealRoots( zVec3DSqrNorm(&dp), zVec3DInnerProd(zFrame3DPos(&frame1_s),&dp), zVec3DSqrNorm(zFrame3DPos(&frame1_s)) - zSqr(r1+r2), t );
+    if( n > 0 && t[0] < 0 && t[n-1] >= 0 ) continue; /* initially in contact */
+    if( zColTOIShape3D( &sphere1, &frame1_s, &frame1_e, &sphere2, &frame2, &frame2, &toi, &c1, &c2 ) ){
+      if( n == 0 || !zIsTol( toi - t[0], 1.0e-3 ) ) result = false;
+    } else
+      if( n > 0 && t[0] >= 0 && t[0] <= 1 ) result = false;
+  }
+  zAssert( zColTOIShape3D, result );
+  zShape3DDestroy( &sphere1 );
+  zShape3DDestroy( &sphere2 );
+}
+
+void assert_col_shape(void)
+{
+  zShape3D cap1, cap2, sphere, box;
+  zVec3D p1, p2, p3, p4, c1, c2, g1, g2;
+  int i;
+  bool flag, result_cap = true, result_box = true;
+
+  for( i=0; i<100; i++ ){
+    zVec3DCreate( &p1, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DCreate( &p2, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DCreate( &p3, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DCreate( &p4, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zShape3DCapsuleCreate( &cap1, &p1, &p2, zRandF(0.1,0.3), 0 );
+    zShape3DCapsuleCreate( &cap2, &p3, &p4, zRandF(0.1,0.3), 0 );
+    flag = zColShape3D( &cap1, &cap2, &c1, &c2 );
+    if( flag != zGJKShape3D( &cap1, NULL, &cap2, NULL, &g1, &g2 ) ||
+        flag != zColChkShape3D( &cap1, &cap2 ) ||
+        ( !flag && !zIsTol( zVec3DDist(&c1,&c2) - zVec3DDist(&g1,&g2), 1.0e-6 ) ) ) result_cap = false;
+    zShape3DSphereCreate( &sphere, &p1, zRandF(0.1,0.5), 0 );
+    zShape3DBoxCreateAlign( &box, &p3, zRandF(0.1,1), zRandF(0.1,1), zRandF(0.1,1) );
+    flag = zColShape3D( &box, &sphere, &c1, &c2 );
+    if( flag != zGJKShape3D( &box, NULL, &sphere, NULL, &g1, &g2 ) ||
+        ( !flag && !zIsTol( zVec3DDist(&c1,&c2) - zVec3DDist(&g1,&g2), 1.0e-6 ) ) ) result_box = false;
+    zShape3DDestroy( &cap1 );
+    zShape3DDestroy( &cap2 );
+    zShape3DDestroy( &sphere );
+    zShape3DDestroy( &box );
+  }
+  zAssert( zColShape3D (capsule-capsule), result_cap );
+  zAssert( zColShape3D (sphere-box), result_box );
+}
+
+bool col_shape_common_point(const zShape3D *s1, const zShape3D *s2, const zVec3D *c1, const zVec3D *c2)
+{
+  return zVec3DEqual( c1, c2 ) &&
+    zShape3DPointIsInside( s1, c1, zTOL ) && zShape3DPointIsInside( s2, c2, zTOL );
+}
+
+void assert_col_shape_kernel(void)
+{
+  zShape3D sphere1, sphere2, cap, box1, box2;
+  zVec3D p1, p2, p3, c1, c2, g1, g2, ax, ay, az, tmp;
+  int i;
+  bool flag, result_sphere = true, result_contain, result_cap = true, result_box = true;
+
+  for( i=0; i<100; i++ ){
+    zVec3DCreate( &p1, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DCreate( &p2, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DCreate( &p3, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    /* sphere-sphere */
+    zShape3DSphereCreate( &sphere1, &p1, zRandF(0.1,1), 0 );
+    zShape3DSphereCreate( &sphere2, &p2, zRandF(0.1,1), 0 );
+    flag = zColShape3D( &sphere1, &sphere2, &c1, &c2 );
+    if( flag != zColChkShape3D( &sphere1, &sphere2 ) ||
+        flag != zGJKShape3D( &sphere1, NULL, &sphere2, NULL, &g1, &g2 ) ||
+        ( flag && !col_shape_common_point( &sphere1, &sphere2, &c1, &c2 ) ) ||
+        ( !flag && !zIsTol( zVec3DDist(&c1,&c2) - zVec3DDist(&g1,&g2), 1.0e-6 ) ) ) result_sphere = false;
+    /* sphere-capsule */
+    zShape3DCapsuleCreate( &cap, &p2, &p3, zRandF(0.1,0.5), 0 );
+    flag = zColShape3D( &sphere1, &cap, &c1, &c2 );
+    if( flag != zColChkShape3D( &sphere1, &cap ) ||
+        flag != zGJKShape3D( &sphere1, NULL, &cap, NULL, &g1, &g2 ) ||
+        ( flag && !col_shape_common_point( &sphere1, &cap, &c1, &c2 ) ) ||
+        ( !flag && !zIsTol( zVec3DDist(&c1,&c2) - zVec3DDist(&g1,&g2), 1.0e-6 ) ) ) result_cap = false;
+    /* box-box by the separating axis test */
+    zVec3DCreate( &ax, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DCreate( &tmp, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DOrthogonalize( &tmp, &ax, &ay );
+    zVec3DOuterProd( &ax, &ay, &az );
+    zVec3DNormalizeDRC( &ax );
+    zVec3DNormalizeDRC( &ay );
+    zVec3DNormalizeDRC( &az );
+    zShape3DBoxCreate( &box1, &p1, &ax, &ay, &az, zRandF(0.1,1), zRandF(0.1,1), zRandF(0.1,1) );
+    zShape3DBoxCreateAlign( &box2, &p3, zRandF(0.1,1), zRandF(0.1,1), zRandF(0.1,1) );
+    if( zColChkShape3D( &box1, &box2 ) != zGJKShape3D( &box1, NULL, &box2, NULL, &g1, &g2 ) ) result_box = false;
+    zShape3DDestroy( &sphere1 );
+    zShape3DDestroy( &sphere2 );
+    zShape3DDestroy( &cap );
+    zShape3DDestroy( &box1 );
+    zShape3DDestroy( &box2 );
+  }
+  /* a ball contains another */
+  zVec3DCreate( &p1, 1, 0, 0 );
+  zShape3DSphereCreate( &sphere1, &p1, 1, 0 );
+  zShape3DSphereCreate( &sphere2, ZVEC3DZERO, 10, 0 );
+  result_contain = zColShape3D( &sphere1, &sphere2, &c1, &c2 ) &&
+    col_shape_common_point( &sphere1, &sphere2, &c1, &c2 ) &&
+    zColShape3D( &sphere2, &sphere1, &c1, &c2 ) &&
+    col_shape_common_point( &sphere2, &sphere1, &c1, &c2 );
+  zShape3DDestroy( &sphere1 );
+  zShape3DDestroy( &sphere2 );
+  zAssert( zColShape3D (sphere-sphere), result_sphere );
+  zAssert( zColShape3D (containment), result_contain );
+  zAssert( zColShape3D (sphere-capsule), result_cap );
+  zAssert( zColChkShape3D (box-box), result_box );
+}
+
+void assert_manifold(void)
+{
+  zShape3D box1, box2, sphere;
+  zColManifold manifold;
+  zFrame3D frame;
+  zVec3D center, ax, ay;
+  double theta, r, depth_min, depth_max;
+  int i, j;
+  bool result_box = true, result_persist = true, result_sphere = true, result_tilt = true, result_carry = true;
+
+  zShape3DBoxCreateAlign( &box1, ZVEC3DZERO, 1, 1, 1 );
+  zColManifoldInit( &manifold );
+  for( i=0; i<10; i++ ){
+    theta = zRandF(-zPI,zPI);
+    zVec3DCreate( &center, zRandF(-0.2,0.2), zRandF(-0.2,0.2), 0.99 );
+    zVec3DCreate( &ax, cos(theta), sin(theta), 0 );
+    zVec3DCreate( &ay,-sin(theta), cos(theta), 0 );
+    zShape3DBoxCreate( &box2, &center, &ax, &ay, ZVEC3DZ, 1, 1, 1 );
+    zColManifoldInit( &manifold );
+    if( !zColManifoldShape3D( &box1, NULL, &box2, NULL, &manifold ) ||
+        zColManifoldNum(&manifold) != ZEO_COL_MANIFOLD_NUM ) result_box = false;
+    for( j=0; j<zColManifoldNum(&manifold); j++ )
+      if( !zIsTol( zColManifoldContact(&manifold,j)->depth - 0.01, 1.0e-4 ) ||
+          !zIsTol( zColManifoldContact(&manifold,j)->pos.c.z - 0.495, 1.0e-4 ) ) result_box = false;
+    zColManifoldShape3D( &box1, NULL, &box2, NULL, &manifold );
+    for( j=0; j<zColManifoldNum(&manifold); j++ )
+      if( zColManifoldContact(&manifold,j)->lifetime != 1 ) result_persist = false;
+    zShape3DDestroy( &box2 );
+  }
+  zVec3DCreate( &center, 0, 0, 0.7 );
+  zShape3DSphereCreate( &sphere, &center, 0.25, 0 );
+  zColManifoldInit( &manifold );
+  if( !zColManifoldShape3D( &box1, NULL, &sphere, NULL, &manifold ) ||
+      zColManifoldNum(&manifold) != 1 ||
+      !zIsTol( zColManifoldContact(&manifold,0)->depth - 0.05, 1.0e-4 ) ) result_sphere = false;
+  zShape3DDestroy( &sphere );
+  /* tilted face-to-face contact */
+  theta = 5.0e-4;
+  zShape3DBoxCreateAlign( &box2, ZVEC3DZERO, 1, 1, 1 );
+  zFrame3DFromPosZYX( &frame, 0, 0, 0.49+0.5*(sin(theta)+cos(theta)), 0, theta, 0 );
+  zColManifoldInit( &manifold );
+  if( !zColManifoldShape3D( &box1, NULL, &box2, &frame, &manifold ) ||
+      zColManifoldNum(&manifold) != ZEO_COL_MANIFOLD_NUM ) result_tilt = false;
+  for( depth_min=HUGE_VAL, depth_max=-HUGE_VAL, j=0; j<zColManifoldNum(&manifold); j++ ){
+    depth_min = _zMin( depth_min, zColManifoldContact(&manifold,j)->depth );
+    depth_max = _zMax( depth_max, zColManifoldContact(&manifold,j)->depth );
+  }
+  if( !zIsTol( depth_max - 0.01, 5.0e-5 ) || !zIsTol( depth_min - ( 0.01 - sin(theta) ), 5.0e-5 ) ) result_tilt = false;
+  zShape3DDestroy( &box2 );
+  /* a rolling sphere keeps the previous contact point */
+  r = 0.1;
+  theta = 0.2;
+  zShape3DSphereCreate( &sphere, ZVEC3DZERO, r, 0 );
+  zFrame3DFromPosZYX( &frame, 0, 0, 0.59, 0, 0, 0 );
+  zColManifoldInit( &manifold );
+  zColManifoldShape3D( &box1, NULL, &sphere, &frame, &manifold );
+  zFrame3DFromPosZYX( &frame, r*theta, 0, 0.59, 0, theta, 0 );
+  if( !zColManifoldShape3D( &box1, NULL, &sphere, &frame, &manifold ) ||
+      zColManifoldNum(&manifold) != 2 ) result_carry = false;
+  for( j=0; j<zColManifoldNum(&manifold); j++ ){
+    if( zColManifoldContact(&manifold,j)->lifetime == 0 ){
+      if( !zIsTol( zColManifoldContact(&manifold,j)->pos.c.x - r*theta, 1.0e-3 ) ||
+          !zIsTol( zColManifoldContact(&manifold,j)->depth - 0.01, 1.0e-4 ) ) result_carry = false;
+    } else
+    if( !zIsTol( zColManifoldContact(&manifold,j)->pos.c.x, 1.0e-3 ) ||
+        !zIsTol( zColManifoldContact(&manifold,j)->depth - ( 0.01 - r*(1-cos(theta)) ), 1.0e-4 ) ) result_carry = false;
+  }
+  zShape3DDestroy( &sphere );
+  zShape3DDestroy( &box1 );
+  zAssert( zColManifoldShape3D (box-box), result_box );
+  zAssert( zColManifoldShape3D (persistence), result_persist );
+  zAssert( zColManifoldShape3D (sphere-box), result_sphere );
+  zAssert( zColManifoldShape3D (depth of tilted faces), result_tilt );
+  zAssert( zColManifoldShape3D (carry-over of a single point), result_carry );
+}
+
 int main(int argc, char *argv[])
 {
+  zRandInit();
   assert_box();
+  assert_shape();
+  assert_shape_ellips();
+  assert_shape_degenerate();
+  assert_warmstart();
+  assert_toi();
+  assert_col_shape();
+  assert_col_shape_kernel();
+  assert_manifold();
   assert_point_volume();
   assert_point_plane();
   return 0;
@@ -19,9 +19,46 @@ void assert_dir(void)
     zDirRev(ZEO_DIR_CCW) == ZEO_DIR_CW );
 }
 
+typedef struct{
+  int *count;
+  int *id;
+} parallel_util;
+
+void parallel_visit(void *util, int id, int start, int end)
+{
+  int i;
+
+  for( i=start; i<end; i++ ){
+    ((parallel_util *)util)->count[i]++;
+    ((parallel_util *)util)->id[i] = id;
+  }
+}
+
+void assert_parallel_for(void)
+{
+  parallel_util util;
+  int count[100], id[100];
+  int num[] = { 0, 1, 3, 100 };
+  int thread_num[] = { 1, 2, 8, 200 };
+  int i, j, k;
+  bool result = true;
+
+  util.count = count;
+  util.id = id;
+  for( i=0; i<4; i++ )
+    for( j=0; j<4; j++ ){
+      memset( count, 0, sizeof(count) );
+      zParallelFor( num[i], thread_num[j], parallel_visit, &util );
+      for( k=0; k<num[i]; k++ )
+        if( count[k] != 1 || id[k] < 0 || id[k] >= _zMin( thread_num[j], num[i] ) ) result = false;
+    }
+  zAssert( zParallelFor, result );
+}
+
 int main(void)
 {
   assert_3denum();
   assert_dir();
+  assert_parallel_for();
   return EXIT_SUCCESS;
 }
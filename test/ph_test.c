@@ -53,10 +53,210 @@ void assert_ph3d_aabb(void)
   zAssert( zPH3DAABB, zAABox3DEqual( &aabb1, &aabb2 ) );
 }
 
+void assert_ph3d_adj_supportmap(void)
+{
+  zVec3DData data;
+  zVec3D p, dir;
+  zPH3D ph;
+  zPH3DAdj adj;
+  int i;
+  const int pointnum = 1000, testnum = 1000;
+  bool result = true;
+
+  zVec3DDataInitList( &data );
+  for( i=0; i<pointnum; i++ ){
+    zVec3DCreate( &p, zRandF(-10,10), zRandF(-10,10), zRandF(-10,10) );
+    zVec3DDataAdd( &data, &p );
+  }
+  zVec3DDataConvexHull( &data, &ph );
+  zPH3DAdjCreate( &adj, &ph );
+  for( i=0; i<testnum; i++ ){
+    zVec3DCreate( &dir, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    if( !zIsTiny( zVec3DInnerProd( zPH3DAdjSupportMap( &adj, &dir ), &dir ) - zVec3DInnerProd( zPH3DSupportMap( &ph, &dir ), &dir ) ) )
+      result = false;
+  }
+  zPH3DAdjDestroy( &adj );
+  zVec3DDataDestroy( &data );
+  zPH3DDestroy( &ph );
+  zAssert( zPH3DAdjSupportMap, result );
+}
+
+void assert_ph3d_adj_isolated(void)
+{
+  zPH3D ph;
+  zPH3DAdj adj;
+  zVec3D dir;
+  int i, face[4][3] = { {1,2,3}, {1,3,4}, {1,4,2}, {2,4,3} };
+  const int testnum = 100;
+  bool result = true;
+
+  /* a tetrahedron with a vertex referred by no face */
+  zPH3DAlloc( &ph, 5, 4 );
+  zVec3DZero( zPH3DVert(&ph,0) );
+  zVec3DCreate( zPH3DVert(&ph,1), 1, 1, 1 );
+  zVec3DCreate( zPH3DVert(&ph,2), 1,-1,-1 );
+  zVec3DCreate( zPH3DVert(&ph,3),-1, 1,-1 );
+  zVec3DCreate( zPH3DVert(&ph,4),-1,-1, 1 );
+  for( i=0; i<4; i++ )
+    zTri3DCreate( zPH3DFace(&ph,i), zPH3DVert(&ph,face[i][0]), zPH3DVert(&ph,face[i][1]), zPH3DVert(&ph,face[i][2]) );
+  zPH3DAdjCreate( &adj, &ph );
+  for( i=0; i<testnum; i++ ){
+    zVec3DCreate( &dir, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    if( i % 2 == 0 ) adj.hint = 0; /* isolated vertex as a hint */
+    if( !zIsTiny( zVec3DInnerProd( zPH3DAdjSupportMap( &adj, &dir ), &dir ) - zVec3DInnerProd( zPH3DSupportMap( &ph, &dir ), &dir ) ) )
+      result = false;
+  }
+  zPH3DAdjDestroy( &adj );
+  zPH3DDestroy( &ph );
+  zAssert( zPH3DAdjSupportMap (isolated vertex), result );
+}
+
+void assert_ph3d_bvh(void)
+{
+  zVec3DData data;
+  zVec3D loop[4], p, cp1, cp2;
+  zPH3D torus, ph;
+  zPH3DBVH bvh;
+  double d, dmin;
+  int i, j;
+  const int pointnum = 1000, testnum = 1000;
+  bool result_closest = true, result_sign = true;
+
+  /* non-convex polyhedron */
+  zVec3DCreate( &loop[0], 2, 0,-0.5 );
+  zVec3DCreate( &loop[1], 3, 0,-0.5 );
+  zVec3DCreate( &loop[2], 3, 0, 0.5 );
+  zVec3DCreate( &loop[3], 2, 0, 0.5 );
+  zPH3DCreateTorus( &torus, loop, 4, 64, ZVEC3DZERO, ZVEC3DZ );
+  zPH3DBVHCreate( &bvh, &torus, 0 );
+  for( i=0; i<testnum; i++ ){
+    zVec3DCreate( &p, zRandF(-4,4), zRandF(-4,4), zRandF(-1,1) );
+    for( dmin=HUGE_VAL, j=0; j<zPH3DFaceNum(&torus); j++ )
+      if( ( d = zTri3DClosest( zPH3DFace(&torus,j), &p, &cp2 ) ) < dmin ) dmin = d;
+    if( !zIsTiny( zPH3DBVHClosest( &bvh, &p, &cp1, NULL ) - dmin ) ) result_closest = false;
+  }
+  zPH3DBVHDestroy( &bvh );
+  zPH3DDestroy( &torus );
+  /* sign of distance */
+  zVec3DDataInitList( &data );
+  for( i=0; i<pointnum; i++ ){
+    zVec3DCreate( &p, zRandF(-10,10), zRandF(-10,10), zRandF(-10,10) );
+    zVec3DDataAdd( &data, &p );
+  }
+  zVec3DDataConvexHull( &data, &ph );
+  zPH3DBVHCreate( &bvh, &ph, 0 );
+  for( i=0; i<testnum; i++ ){
+    zVec3DCreate( &p, zRandF(-12,12), zRandF(-12,12), zRandF(-12,12) );
+    if( ( zPH3DBVHSignedDistFromPoint( &bvh, &p ) < 0 ) != zPH3DPointIsInside( &ph, &p, 0 ) ) result_sign = false;
+  }
+  zPH3DBVHDestroy( &bvh );
+  zVec3DDataDestroy( &data );
+  zPH3DDestroy( &ph );
+  zAssert( zPH3DBVHClosest, result_closest );
+  zAssert( zPH3DBVHSignedDistFromPoint, result_sign );
+}
+
+void assert_ph3d_halfspace(void)
+{
+  zVec3DData data;
+  zVec3D p[1000];
+  zPH3D ph;
+  zPH3DHalfSpace hs;
+  bool inside[1000];
+  int i, count = 0;
+  const int pointnum = 100, testnum = 1000;
+  bool result = true, result_batch = true;
+
+  zVec3DDataInitList( &data );
+  for( i=0; i<pointnum; i++ ){
+    zVec3DCreate( &p[0], zRandF(-10,10), zRandF(-10,10), zRandF(-10,10) );
+    zVec3DDataAdd( &data, &p[0] );
+  }
+  zVec3DDataConvexHull( &data, &ph );
+  zPH3DHalfSpaceCreate( &hs, &ph );
+  for( i=0; i<testnum; i++ ){
+    zVec3DCreate( &p[i], zRandF(-12,12), zRandF(-12,12), zRandF(-12,12) );
+    if( zPH3DHalfSpacePointIsInside( &hs, &p[i], 0 ) != zPH3DPointIsInside( &ph, &p[i], 0 ) ) result = false;
+    if( zPH3DPointIsInside( &ph, &p[i], 0 ) ) count++;
+  }
+  if( zPH3DHalfSpacePointIsInsideBatch( &hs, p, testnum, 0, inside, 0 ) != count ) result_batch = false;
+  for( i=0; i<testnum; i++ )
+    if( inside[i] != zPH3DPointIsInside( &ph, &p[i], 0 ) ) result_batch = false;
+  if( zPH3DHalfSpacePointIsInsideBatch( &hs, p, testnum, 0, NULL, 2 ) != count ) result_batch = false;
+  zPH3DHalfSpaceDestroy( &hs );
+  zVec3DDataDestroy( &data );
+  zPH3DDestroy( &ph );
+  zAssert( zPH3DHalfSpacePointIsInside, result );
+  zAssert( zPH3DHalfSpacePointIsInsideBatch, result_batch );
+}
+
+void ph_rand(zPH3D *ph, double offset)
+{
+  zVec3DData data;
+  zVec3D p;
+  int i;
+
+  zVec3DDataInitList( &data );
+  for( i=0; i<50; i++ ){
+    zVec3DCreate( &p, zRandF(-1,1)+offset, zRandF(-1,1), zRandF(-1,1) );
+    zVec3DDataAdd( &data, &p );
+  }
+  zVec3DDataConvexHull( &data, ph );
+  zVec3DDataDestroy( &data );
+}
+
+bool ph_vert_include(zPH3D *ph, zPH3D *ph_sub)
+{
+  int i, j;
+
+  for( i=0; i<zPH3DVertNum(ph_sub); i++ ){
+    for( j=0; j<zPH3DVertNum(ph); j++ )
+      if( zVec3DDist( zPH3DVert(ph,j), zPH3DVert(ph_sub,i) ) < 1.0e-6 ) break;
+    if( j == zPH3DVertNum(ph) ) return false;
+  }
+  return true;
+}
+
+void assert_ph3d_intersect(void)
+{
+  zPH3D ph1, ph2, ph_ref, ph_brep, ph_fast;
+  double v;
+  int i;
+  bool result_brep = true, result_fast = true;
+
+  for( i=0; i<10; i++ ){
+    ph_rand( &ph1, 0 );
+    ph_rand( &ph2, zRandF(0.2,1.0) );
+    zIntersectPH3D( &ph1, &ph2, &ph_ref );
+    zIntersectPH3DBREP( &ph1, &ph2, &ph_brep );
+    zIntersectPH3DBREPFast( &ph1, &ph2, &ph_fast );
+    v = zPH3DVolume( &ph_ref );
+    /* a closed triangular mesh, which contains all vertices of the intersection */
+    if( !zIsTol( zPH3DVolume( &ph_brep ) - v, 1.0e-6 ) ||
+        zPH3DFaceNum(&ph_brep) != 2*zPH3DVertNum(&ph_brep) - 4 ||
+        !ph_vert_include( &ph_brep, &ph_ref ) ) result_brep = false;
+    if( !zIsTol( zPH3DVolume( &ph_fast ) - v, 1.0e-6 ) ||
+        zPH3DFaceNum(&ph_fast) != 2*zPH3DVertNum(&ph_fast) - 4 ||
+        !ph_vert_include( &ph_fast, &ph_ref ) ) result_fast = false;
+    zPH3DDestroy( &ph1 );
+    zPH3DDestroy( &ph2 );
+    zPH3DDestroy( &ph_ref );
+    zPH3DDestroy( &ph_brep );
+    zPH3DDestroy( &ph_fast );
+  }
+  zAssert( zIntersectPH3DBREP, result_brep );
+  zAssert( zIntersectPH3DBREPFast, result_fast );
+}
+
 int main(int argc, char *argv[])
 {
   zRandInit();
   assert_ph3d_closestpoint();
   assert_ph3d_aabb();
+  assert_ph3d_adj_supportmap();
+  assert_ph3d_adj_isolated();
+  assert_ph3d_bvh();
+  assert_ph3d_halfspace();
+  assert_ph3d_intersect();
   return 0;
 }
@@ -1,4 +1,4 @@
-#include <zeo/zeo_shape3d.h>
+#include <zeo/zeo_multishape3d.h>
 
 void assert_box_to_aabox(void)
 {
@@ -67,9 +67,216 @@ void assert_shape_inertia(void)
   zShape3DDestroy( &ph );
 }
 
+void assert_shape_raycast(void)
+{
+  zShape3D box, ph;
+  zVec3D org, dir, n1, n2;
+  double t1, t2;
+  bool hit1, hit2;
+  int i;
+  bool result = true;
+
+  generate_box_rand( &box );
+  zShape3DClone( &box, &ph, NULL );
+  zShape3DToPH( &ph );
+  for( i=0; i<1000; i++ ){
+    zVec3DCreate( &org, zRandF(-10,10), zRandF(-10,10), zRandF(-10,10) );
+    zVec3DCreate( &dir, zRandF(-5,5), zRandF(-5,5), zRandF(-5,5) );
+    zVec3DSubDRC( &dir, &org );
+    hit1 = zShape3DRaycast( &box, &org, &dir, 1, &t1, &n1 );
+    hit2 = zShape3DRaycast( &ph, &org, &dir, 1, &t2, &n2 );
+    if( hit1 != hit2 || ( hit1 && ( !zIsTiny( t1 - t2 ) || !zVec3DEqual( &n1, &n2 ) ) ) ) result = false;
+  }
+  zAssert( zShape3DRaycast, result );
+  zShape3DDestroy( &box );
+  zShape3DDestroy( &ph );
+}
+
+#define RAYCAST_SHAPE_NUM 8
+
+/* primitives whose sections at z = zc are unit discs (0.75 for the cone) */
+void generate_raycast_shape(zShape3D shape[], double *zc, double *rho, zVec3D *n)
+{
+  zVec3D c1, c2;
+
+  zVec3DCreate( &c1, 0, 0,-1 );
+  zVec3DCreate( &c2, 0, 0, 1 );
+  zShape3DSphereCreate( &shape[0], ZVEC3DZERO, 1, 0 );
+  zShape3DBoxCreateAlign( &shape[1], ZVEC3DZERO, 2, 2, 2 );
+  zShape3DEllipsCreateAlign( &shape[2], ZVEC3DZERO, 1, 2, 3, 0 );
+  zShape3DCylCreate( &shape[3], &c1, &c2, 1, 0 );
+  zShape3DCapsuleCreate( &shape[4], &c1, &c2, 1, 0 );
+  zShape3DECylCreate( &shape[5], &c1, &c2, 1, 2, ZVEC3DX, 0 );
+  zShape3DBoxCreateAlign( &shape[6], ZVEC3DZERO, 2, 2, 2 );
+  zShape3DToPH( &shape[6] );
+  zVec3DCreate( &c2, 0, 0, 2 );
+  zShape3DConeCreate( &shape[7], ZVEC3DZERO, &c2, 1, 0 );
+  zc[0] = zc[1] = zc[2] = zc[3] = zc[4] = zc[5] = zc[6] = 0;
+  rho[0] = rho[1] = rho[2] = rho[3] = rho[4] = rho[5] = rho[6] = 1;
+  zVec3DCreate( &n[0], 1, 0, 0 );
+  n[1] = n[2] = n[3] = n[4] = n[5] = n[6] = n[0];
+  zc[7] = 0.5;
+  rho[7] = 0.75;
+  zVec3DCreate( &n[7], 2, 0, 1 );
+  zVec3DNormalizeDRC( &n[7] );
+}
+
+void assert_primitive_raycast(void)
+{
+  zShape3D shape[RAYCAST_SHAPE_NUM];
+  double zc[RAYCAST_SHAPE_NUM], rho[RAYCAST_SHAPE_NUM];
+  zVec3D n_ans[RAYCAST_SHAPE_NUM], org, dir, n;
+  double t;
+  int i;
+  bool result_hit = true, result_miss = true, result_inside = true, result_null = true;
+
+  generate_raycast_shape( shape, zc, rho, n_ans );
+  zVec3DCreate( &dir, 1, 0, 0 );
+  for( i=0; i<RAYCAST_SHAPE_NUM; i++ ){
+    /* hit from outside */
+    zVec3DCreate( &org, -5, 0, zc[i] );
+    if( !zShape3DRaycast( &shape[i], &org, &dir, 10, &t, &n ) ||
+        !zIsTiny( t - ( 5 - rho[i] ) ) ||
+        !zIsTiny( n.c.x + n_ans[i].c.x ) || !zIsTiny( n.c.y - n_ans[i].c.y ) || !zIsTiny( n.c.z - n_ans[i].c.z ) ){
+      eprintf( "hit failed: %s\n", shape[i].com->typestr );
+      result_hit = false;
+    }
+    if( !zShape3DRaycast( &shape[i], &org, &dir, 10, &t, NULL ) || !zIsTiny( t - ( 5 - rho[i] ) ) )
+      result_null = false;
+    /* miss */
+    if( zShape3DRaycast( &shape[i], &org, &dir, 0.5 * ( 5 - rho[i] ), &t, &n ) ) result_miss = false;
+    zVec3DCreate( &org, -5, 0, 5 );
+    if( zShape3DRaycast( &shape[i], &org, &dir, 10, &t, &n ) ||
+        zShape3DRaycast( &shape[i], &org, &dir, 10, &t, NULL ) ) result_miss = false;
+    /* exit from inside */
+    zVec3DCreate( &org, 0, 0, zc[i] );
+    if( !zShape3DRaycast( &shape[i], &org, &dir, 10, &t, &n ) ||
+        !zIsTiny( t - rho[i] ) || !zVec3DEqual( &n, &n_ans[i] ) ){
+      eprintf( "exit failed: %s\n", shape[i].com->typestr );
+      result_inside = false;
+    }
+    if( !zShape3DRaycast( &shape[i], &org, &dir, 10, &t, NULL ) || !zIsTiny( t - rho[i] ) )
+      result_null = false;
+    zShape3DDestroy( &shape[i] );
+  }
+  zAssert( zShape3DRaycast (hit), result_hit );
+  zAssert( zShape3DRaycast (miss), result_miss );
+  zAssert( zShape3DRaycast (inside origin), result_inside );
+  zAssert( zShape3DRaycast (null normal), result_null );
+}
+
+void assert_multishape_raycast(void)
+{
+  zMultiShape3D ms;
+  zMultiShape3DRaycaster rc;
+  zMultiShape3DRayHit hit, hit_batch[100];
+  zVec3D c, nx, org[100], dir[100];
+  int i, k, count;
+  int thread_num[] = { 1, 4 };
+  bool result = true, result_batch = true;
+
+  /* unit spheres at x = 0, 3, 6 */
+  zMultiShape3DInit( &ms );
+  zMultiShape3DAllocShapeArray( &ms, 3 );
+  for( i=0; i<3; i++ ){
+    zVec3DCreate( &c, 3*i, 0, 0 );
+    zShape3DSphereCreate( zMultiShape3DShape(&ms,i), &c, 1, 0 );
+  }
+  zMultiShape3DRaycasterCreate( &rc, &ms );
+  zVec3DCreate( &nx, -1, 0, 0 );
+  zVec3DCreate( &org[0], -5, 0, 0 ); zVec3DCreate( &dir[0], 1, 0, 0 );
+  if( !zMultiShape3DRaycasterRaycast( &rc, &org[0], &dir[0], 20, &hit ) ||
+      hit.shape != 0 || !zIsTiny( hit.t - 4 ) || !zVec3DEqual( &hit.normal, &nx ) ) result = false;
+  zVec3DCreate( &org[0], 10, 0, 0 ); zVec3DCreate( &dir[0],-1, 0, 0 );
+  if( !zMultiShape3DRaycasterRaycast( &rc, &org[0], &dir[0], 20, &hit ) ||
+      hit.shape != 2 || !zIsTiny( hit.t - 3 ) || !zVec3DEqual( &hit.normal, ZVEC3DX ) ) result = false;
+  zVec3DCreate( &org[0], 3, 0, 0 ); zVec3DCreate( &dir[0], 0, 1, 0 ); /* from inside */
+  if( !zMultiShape3DRaycasterRaycast( &rc, &org[0], &dir[0], 20, &hit ) ||
+      hit.shape != 1 || !zIsTiny( hit.t - 1 ) || !zVec3DEqual( &hit.normal, ZVEC3DY ) ) result = false;
+  zVec3DCreate( &org[0],-5, 5, 0 ); zVec3DCreate( &dir[0], 1, 0, 0 );
+  if( zMultiShape3DRaycasterRaycast( &rc, &org[0], &dir[0], 20, &hit ) || hit.shape != -1 ) result = false;
+  /* batch */
+  for( i=0; i<100; i++ ){
+    zVec3DCreate( &org[i], -5, zRandF(-1.5,1.5), zRandF(-1.5,1.5) );
+    zVec3DCreate( &dir[i], 1, zRandF(-0.1,0.1), zRandF(-0.1,0.1) );
+  }
+  for( k=0; k<2; k++ ){
+    count = zMultiShape3DRaycasterRaycastBatch( &rc, org, dir, 100, 20, hit_batch, thread_num[k] );
+    for( i=0; i<100; i++ ){
+      if( zMultiShape3DRaycasterRaycast( &rc, &org[i], &dir[i], 20, &hit ) ) count--;
+      if( hit.shape != hit_batch[i].shape ||
+          ( hit.shape >= 0 && !zIsTiny( hit.t - hit_batch[i].t ) ) ) result_batch = false;
+    }
+    if( count != 0 ) result_batch = false;
+  }
+  zMultiShape3DRaycasterDestroy( &rc );
+  zMultiShape3DDestroy( &ms );
+  zAssert( zMultiShape3DRaycasterRaycast, result );
+  zAssert( zMultiShape3DRaycasterRaycastBatch, result_batch );
+}
+
+void assert_sdf(void)
+{
+  zShape3D sphere;
+  zSDF3D sdf, sdf_read;
+  zVec3D center, p, grad;
+  FILE *fp;
+  int32_t num_huge[] = { 2000, 2000, 2000 }, num_neg[] = { -1, 4, 4 };
+  double r = 1.0, d;
+  int i;
+  bool result = true, result_grad = true, result_io = false, result_corrupt = false;
+
+  zVec3DCreate( &center, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+  zShape3DSphereCreate( &sphere, &center, r, 32 );
+  zSDF3DFromShape3D( &sdf, &sphere, 0.05, 0.5, 0 );
+  for( i=0; i<1000; i++ ){
+    zVec3DCreate( &p, zRandF(-1.5,1.5), zRandF(-1.5,1.5), zRandF(-1.5,1.5) );
+    zVec3DAddDRC( &p, &center );
+    d = zSDF3DGrad( &sdf, &p, &grad );
+    if( fabs( d - ( zVec3DDist( &p, &center ) - r ) ) > 0.05 ) result = false;
+    zVec3DSubDRC( &p, &center );
+    if( zVec3DNorm( &p ) > 0.5 && zVec3DInnerProd( &p, &grad ) < 0.9 * zVec3DNorm( &p ) * zVec3DNorm( &grad ) ) result_grad = false;
+  }
+  zAssert( zSDF3DFromShape3D + zSDF3DDist, result );
+  zAssert( zSDF3DGrad, result_grad );
+  if( ( fp = tmpfile() ) ){
+    zSDF3DFWrite( fp, &sdf );
+    rewind( fp );
+    if( zSDF3DFRead( fp, &sdf_read ) ){
+      result_io = zSDF3DNum(&sdf_read,zX) == zSDF3DNum(&sdf,zX) &&
+                  zSDF3DNum(&sdf_read,zY) == zSDF3DNum(&sdf,zY) &&
+                  zSDF3DNum(&sdf_read,zZ) == zSDF3DNum(&sdf,zZ) &&
+                  memcmp( sdf_read.val, sdf.val, sizeof(double)*zSDF3DNum(&sdf,zX)*zSDF3DNum(&sdf,zY)*zSDF3DNum(&sdf,zZ) ) == 0;
+      zSDF3DDestroy( &sdf_read );
+    }
+    fclose( fp );
+  }
+  zAssert( zSDF3DFWrite + zSDF3DFRead, result_io );
+  /* corrupt sizes in the header, the former of which overflows int */
+  if( ( fp = tmpfile() ) ){
+    zSDF3DFWrite( fp, &sdf );
+    fseek( fp, 8, SEEK_SET );
+    fwrite( num_huge, sizeof(int32_t), 3, fp );
+    rewind( fp );
+    result_corrupt = !zSDF3DFRead( fp, &sdf_read );
+    fseek( fp, 8, SEEK_SET );
+    fwrite( num_neg, sizeof(int32_t), 3, fp );
+    rewind( fp );
+    result_corrupt = result_corrupt && !zSDF3DFRead( fp, &sdf_read );
+    fclose( fp );
+  }
+  zAssert( zSDF3DFRead (corrupt header), result_corrupt );
+  zSDF3DDestroy( &sdf );
+  zShape3DDestroy( &sphere );
+}
+
 int main(int argc, char *argv[])
 {
   assert_box_to_aabox();
   assert_shape_inertia();
+  assert_shape_raycast();
+  assert_primitive_raycast();
+  assert_multishape_raycast();
+  assert_sdf();
   return 0;
 }
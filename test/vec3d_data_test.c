@@ -270,6 +270,292 @@ void assert_frame_ident(void)
   zAssert( zVec3DDataIdentFrame, result );
 }
 
+void generate_surface(zVec3DData *src, zVec3DData *dest, zVec3DData *normal, zFrame3D *frame, int n)
+{
+  zVec3D po, p, no, nv;
+  double x, y;
+
+  while( --n >= 0 ){
+    x = zRandF(-1,1);
+    y = zRandF(-1,1);
+    zVec3DCreate( &po, x, y, 0.3*sin(3*x)*cos(2*y) );
+    zVec3DCreate( &no, -0.9*cos(3*x)*cos(2*y), 0.6*sin(3*x)*sin(2*y), 1 );
+    zVec3DNormalizeDRC( &no );
+    zXform3D( frame, &po, &p );
+    zMulMat3DVec3D( zFrame3DAtt(frame), &no, &nv );
+    zVec3DDataAdd( src, &po );
+    zVec3DDataAdd( dest, &p );
+    if( normal ) zVec3DDataAdd( normal, &nv );
+  }
+}
+
+void assert_normal_parallel(void)
+{
+  int testnum = 500;
+  zVec3DData src, dest, normal, normal_serial;
+  zVec3DArray normal_parallel;
+  zVec3D *n;
+  zFrame3D frame;
+  int i, k;
+  int thread_num[] = { 1, 4 };
+  bool result = true;
+
+  zVec3DDataInitList( &src );
+  zVec3DDataInitList( &dest );
+  zVec3DDataInitList( &normal );
+  zFrame3DIdent( &frame );
+  generate_surface( &src, &dest, &normal, &frame, testnum );
+  zVec3DDataNormalVec( &src, 0.2, &normal_serial );
+  for( k=0; k<2; k++ ){
+    if( !zVec3DDataNormalVec_Parallel( &src, 0.2, testnum, &normal_parallel, thread_num[k] ) ){
+      result = false;
+      continue;
+    }
+    zVec3DDataRewind( &normal_serial );
+    for( i=0; ( n = zVec3DDataFetch( &normal_serial ) ); i++ )
+      if( !zIsTol( fabs( zVec3DInnerProd( n, zArrayElemNC(&normal_parallel,i) ) ) - 1, 1.0e-6 ) ) result = false;
+    zArrayFree( &normal_parallel );
+  }
+  zVec3DDataDestroy( &normal_serial );
+  zVec3DDataDestroy( &normal );
+  zVec3DDataDestroy( &dest );
+  zVec3DDataDestroy( &src );
+  zAssert( zVec3DDataNormalVec_Parallel, result );
+}
+
+void assert_icp_point_to_plane(void)
+{
+  int i, testnum = 1000;
+  double tol = 1.0e-3;
+  zVec3DData src, dest, normal;
+  zVec3D p;
+  zFrame3D frame, frame_ident;
+  bool result_plain, result_robust;
+
+  zVec3DDataInitList( &src );
+  zVec3DDataInitList( &dest );
+  zVec3DDataInitList( &normal );
+  zVec3DCreate( zFrame3DPos(&frame), zRandF(-0.1,0.1), zRandF(-0.1,0.1), zRandF(-0.1,0.1) );
+  zMat3DFromZYX( zFrame3DAtt(&frame), zRandF(-0.1,0.1), zRandF(-0.1,0.1), zRandF(-0.1,0.1) );
+  generate_surface( &src, &dest, &normal, &frame, testnum );
+  result_plain = zVec3DDataICPPointToPlane( &src, &dest, &normal, &frame_ident, ZEO_VEC3DDATA_ICP_KERNEL_NONE, 0, 0, zTOL ) &&
+    check_frame_error( &frame, &frame_ident, tol );
+  for( i=0; i<testnum/20; i++ ){ /* outliers */
+    zVec3DCreate( &p, zRandF(-1,1), zRandF(-1,1), zRandF(1,2) );
+    zVec3DDataAdd( &src, &p );
+  }
+  result_robust = zVec3DDataICPPointToPlane( &src, &dest, &normal, &frame_ident, ZEO_VEC3DDATA_ICP_KERNEL_TUKEY, 0.3, 0.5, zTOL ) &&
+    check_frame_error( &frame, &frame_ident, tol );
+  zVec3DDataDestroy( &normal );
+  zVec3DDataDestroy( &dest );
+  zVec3DDataDestroy( &src );
+  zAssert( zVec3DDataICPPointToPlane, result_plain );
+  zAssert( zVec3DDataICPPointToPlane (robust kernel), result_robust );
+}
+
+void assert_icp_engine(void)
+{
+  int i, testnum = 1000;
+  zVec3DData src, dest;
+  zVec3D p;
+  zFrame3D frame, frame1, frame2;
+  zVec3DICP icp;
+  bool result_frame, result_thread, result_stat = true;
+
+  zVec3DDataInitList( &src );
+  zVec3DDataInitList( &dest );
+  zVec3DCreate( zFrame3DPos(&frame), zRandF(-0.1,0.1), zRandF(-0.1,0.1), zRandF(-0.1,0.1) );
+  zMat3DFromZYX( zFrame3DAtt(&frame), zRandF(-0.1,0.1), zRandF(-0.1,0.1), zRandF(-0.1,0.1) );
+  generate_points( &src, &dest, &frame, testnum, 0 );
+  for( i=0; i<testnum/20; i++ ){ /* outliers */
+    zVec3DCreate( &p, zRandF(-5,5), zRandF(-5,5), zRandF(10,20) );
+    zVec3DDataAdd( &src, &p );
+  }
+  /* the same seed gives the same result regardless of the number of threads */
+  zVec3DICPCreate( &icp, &dest, 1 );
+  zVec3DICPSetRejectDist( &icp, 1.0 );
+  zVec3DICPSetSeed( &icp, 1 );
+  zFrame3DIdent( &frame1 );
+  result_frame = zVec3DICPRun( &icp, &src, &frame1, 0.5, zTOL ) &&
+    check_frame_error( &frame, &frame1, 1.0e-3 );
+  for( i=0; i<zVec3DICPIterNum(&icp); i++ )
+    if( zVec3DICPIterStat(&icp,i)->inlier_num > zVec3DICPIterStat(&icp,i)->num ||
+        zVec3DICPIterStat(&icp,i)->rms > zVec3DICPIterStat(&icp,i)->error_max ) result_stat = false;
+  if( zVec3DICPIterStat(&icp,zVec3DICPIterNum(&icp)-1)->rms > zVec3DICPIterStat(&icp,0)->rms ) result_stat = false;
+  zVec3DICPDestroy( &icp );
+  zVec3DICPCreate( &icp, &dest, 4 );
+  zVec3DICPSetRejectDist( &icp, 1.0 );
+  zVec3DICPSetSeed( &icp, 1 );
+  zFrame3DIdent( &frame2 );
+  zVec3DICPRun( &icp, &src, &frame2, 0.5, zTOL );
+  result_thread = zFrame3DEqual( &frame1, &frame2 );
+  zVec3DICPDestroy( &icp );
+  zVec3DDataDestroy( &dest );
+  zVec3DDataDestroy( &src );
+  zAssert( zVec3DICPRun, result_frame );
+  zAssert( zVec3DICPRun (thread), result_thread );
+  zAssert( zVec3DICPRun (statistics), result_stat );
+}
+
+void assert_icp_pyramid(void)
+{
+  int testnum = 2000;
+  zVec3DData src, dest;
+  zVec3D po, p;
+  zFrame3D frame, frame_ident;
+  bool result;
+
+  zVec3DDataInitList( &src );
+  zVec3DDataInitList( &dest );
+  zVec3DCreate( zFrame3DPos(&frame), zRandF(-0.2,0.2), zRandF(-0.2,0.2), zRandF(-0.2,0.2) );
+  zMat3DFromZYX( zFrame3DAtt(&frame), zRandF(-0.2,0.2), zRandF(-0.2,0.2), zRandF(-0.2,0.2) );
+  while( --testnum >= 0 ){
+    zVec3DCreate( &po, zRandF(-1,1), zRandF(-0.5,0.5), zRandF(-0.2,0.2) );
+    zXform3D( &frame, &po, &p );
+    zVec3DDataAdd( &src, &po );
+    zVec3DDataAdd( &dest, &p );
+  }
+  result = zVec3DDataICPPyramid( &src, &dest, &frame_ident, 0.1, 3, 1.0, 1.0e-3, 0 ) &&
+    check_frame_error( &frame, &frame_ident, 1.0e-2 );
+  zVec3DDataDestroy( &dest );
+  zVec3DDataDestroy( &src );
+  zAssert( zVec3DDataICPPyramid, result );
+}
+
+void generate_registration(zVec3DData *src, zVec3DData *dest, zFrame3D *frame, int n)
+{
+  zVec3DDataInitList( src );
+  zVec3DDataInitList( dest );
+  zVec3DCreate( zFrame3DPos(frame), zRandF(-0.05,0.05), zRandF(-0.05,0.05), zRandF(-0.05,0.05) );
+  zMat3DFromZYX( zFrame3DAtt(frame), zRandF(-0.05,0.05), zRandF(-0.05,0.05), zRandF(-0.05,0.05) );
+  generate_surface( src, dest, NULL, frame, n );
+}
+
+void assert_ndt(void)
+{
+  zVec3DData src, dest;
+  zFrame3D frame, frame_ident;
+  zVec3DNDT ndt;
+  bool result;
+
+  generate_registration( &src, &dest, &frame, 4000 );
+  zVec3DNDTCreate( &ndt, &dest, 0.25, 0 );
+  zFrame3DIdent( &frame_ident );
+  result = zVec3DNDTRun( &ndt, &src, &frame_ident, zTOL ) && check_frame_error( &frame, &frame_ident, 1.0e-2 );
+  zVec3DNDTDestroy( &ndt );
+  zVec3DDataDestroy( &dest );
+  zVec3DDataDestroy( &src );
+  zAssert( zVec3DNDTRun, result );
+}
+
+void assert_gicp(void)
+{
+  zVec3DData src, dest;
+  zFrame3D frame, frame_ident;
+  zVec3DGICPCloud src_cloud, dest_cloud;
+  bool result;
+
+  generate_registration( &src, &dest, &frame, 2000 );
+  zVec3DGICPCloudCreate( &src_cloud, &src, 10, 0 );
+  zVec3DGICPCloudCreate( &dest_cloud, &dest, 10, 0 );
+  zFrame3DIdent( &frame_ident );
+  result = zVec3DGICPRun( &src_cloud, &dest_cloud, &frame_ident, 0, zTOL, 0 ) &&
+    check_frame_error( &frame, &frame_ident, 1.0e-3 );
+  zVec3DGICPCloudDestroy( &src_cloud );
+  zVec3DGICPCloudDestroy( &dest_cloud );
+  zVec3DDataDestroy( &dest );
+  zVec3DDataDestroy( &src );
+  zAssert( zVec3DGICPRun, result );
+}
+
+void assert_voxel_downsample(void)
+{
+  zVec3DData src, dest1, dest2;
+  zAABox3D box;
+  zVec3D p, *v1, *v2;
+  int i, j, n = 5000, cell[64];
+  double pitch = 0.25;
+  bool result_cell = true, result_thread = true, result_first = true;
+
+  zVec3DDataInitArray( &src, n );
+  for( i=0; i<n; i++ ){
+    zVec3DCreate( &p, zRandF(0,1), zRandF(0,1), zRandF(0,1) );
+    zVec3DDataAdd( &src, &p );
+  }
+  zVec3DDataAABB( &src, &box, NULL );
+  /* centroids lie in distinct voxels */
+  zVec3DDataVoxelDownsample( &src, pitch, true, &dest1, 1 );
+  zVec3DDataVoxelDownsample( &src, pitch, true, &dest2, 4 );
+  if( zVec3DDataSize(&dest1) > 64 ) result_cell = false;
+  for( i=0; i<64; i++ ) cell[i] = 0;
+  zVec3DDataRewind( &dest1 );
+  zVec3DDataRewind( &dest2 );
+  while( ( v1 = zVec3DDataFetch( &dest1 ) ) ){
+    j = (int)( ( v1->c.x - box.min.c.x ) / pitch )
+      + (int)( ( v1->c.y - box.min.c.y ) / pitch ) * 4
+      + (int)( ( v1->c.z - box.min.c.z ) / pitch ) * 16;
+    if( j < 0 || j >= 64 || cell[j]++ > 0 ) result_cell = false;
+    if( !( v2 = zVec3DDataFetch( &dest2 ) ) || !zVec3DMatch( v1, v2 ) ) result_thread = false;
+  }
+  zVec3DDataDestroy( &dest1 );
+  zVec3DDataDestroy( &dest2 );
+  /* representatives are points in the original cloud */
+  zVec3DDataVoxelDownsample( &src, pitch, false, &dest1, 0 );
+  zVec3DDataRewind( &dest1 );
+  while( ( v1 = zVec3DDataFetch( &dest1 ) ) ){
+    zVec3DDataRewind( &src );
+    while( ( v2 = zVec3DDataFetch( &src ) ) )
+      if( zVec3DMatch( v1, v2 ) ) break;
+    if( !v2 ) result_first = false;
+  }
+  zVec3DDataDestroy( &dest1 );
+  zVec3DDataDestroy( &src );
+  zAssert( zVec3DDataVoxelDownsample (centroid), result_cell );
+  zAssert( zVec3DDataVoxelDownsample (thread), result_thread );
+  zAssert( zVec3DDataVoxelDownsample (first point), result_first );
+}
+
+void assert_outlier(void)
+{
+  zVec3DData src, dest;
+  zVec3D p, *v;
+  int i, n = 1000, m = 10, count1, count2;
+  bool inlier1[1010], inlier2[1010];
+  bool result_stat = true, result_radius = true, result_thread = true, result_mask = true;
+
+  zVec3DDataInitArray( &src, n + m );
+  for( i=0; i<n; i++ ){
+    zVec3DCreate( &p, zRandF(-0.1,0.1), zRandF(-0.1,0.1), zRandF(-0.1,0.1) );
+    zVec3DDataAdd( &src, &p );
+  }
+  for( i=0; i<m; i++ ){ /* isolated speckles */
+    zVec3DCreate( &p, 1 + i, zRandF(-1,1), zRandF(-1,1) );
+    zVec3DDataAdd( &src, &p );
+  }
+  count1 = zVec3DDataStatisticalOutlierMask( &src, 8, 1.0, inlier1, 1 );
+  count2 = zVec3DDataStatisticalOutlierMask( &src, 8, 1.0, inlier2, 4 );
+  for( i=n; i<n+m; i++ )
+    if( inlier1[i] ) result_stat = false;
+  for( i=0; i<n+m; i++ )
+    if( inlier1[i] != inlier2[i] ) result_thread = false;
+  if( count1 != count2 ) result_thread = false;
+  count1 = zVec3DDataRadiusOutlierMask( &src, 0.1, 3, inlier1, 0 );
+  for( i=0; i<n+m; i++ )
+    if( inlier1[i] != ( i < n ) ) result_radius = false;
+  if( count1 != n ) result_radius = false;
+  zVec3DDataMask( &src, inlier1, &dest );
+  if( zVec3DDataSize(&dest) != n ) result_mask = false;
+  zVec3DDataRewind( &dest );
+  while( ( v = zVec3DDataFetch( &dest ) ) )
+    if( v->c.x > 0.1 ) result_mask = false;
+  zVec3DDataDestroy( &dest );
+  zVec3DDataDestroy( &src );
+  zAssert( zVec3DDataStatisticalOutlierMask, result_stat );
+  zAssert( zVec3DDataRadiusOutlierMask, result_radius );
+  zAssert( zVec3DDataStatisticalOutlierMask (thread), result_thread );
+  zAssert( zVec3DDataMask, result_mask );
+}
+
 int main(int argc, char *argv[])
 {
   zRandInit();
@@ -283,5 +569,13 @@ int main(int argc, char *argv[])
   assert_vec3ddata_addrlist_ptr();
   assert_vicinity();
   assert_frame_ident();
+  assert_normal_parallel();
+  assert_icp_point_to_plane();
+  assert_icp_engine();
+  assert_icp_pyramid();
+  assert_ndt();
+  assert_gicp();
+  assert_voxel_downsample();
+  assert_outlier();
   return 0;
 }
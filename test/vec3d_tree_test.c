@@ -140,6 +140,162 @@ void assert_vicinity(void)
   zAssert( zVec3DOctreeVicinity, result_octree );
 }
 
+void assert_flattree(void)
+{
+  zVec3DFlatTree tree;
+  zVec3DData pointdata;
+  zVec3DData vicinity1, vicinity2;
+  const int ns = 1000;
+  int i, k;
+  zVec3D v, *nn_tree, *nn_data;
+  bool result_nn = true, result_id = true, result_vicinity = true;
+  const double radius = 5.0;
+
+  zVec3DDataInitArray( &pointdata, ns );
+  for( i=0; i<zVec3DDataCapacity(&pointdata); i++ ){
+    zVec3DCreate( &v, zRandF(-10,10), zRandF(-10,10), zRandF(-10,10) );
+    zVec3DDataAdd( &pointdata, &v );
+  }
+  zVec3DDataToFlatTree( &pointdata, &tree, 0 );
+  for( k=0; k<100; k++ ){
+    zVec3DCreate( &v, zRandF(-10,10), zRandF(-10,10), zRandF(-10,10) );
+    zVec3DFlatTreeNN( &tree, &v, &nn_tree );
+    zVec3DDataNN( &pointdata, &v, &nn_data );
+    if( !zVec3DEqual( nn_tree, nn_data ) ) result_nn = false;
+    if( !zVec3DEqual( nn_tree, zArrayElemNC(pointdata.data.array,zVec3DFlatTreePointID(&tree,nn_tree)) ) ) result_id = false;
+  }
+  zVec3DDataVicinity( &pointdata, &v, radius, &vicinity1 );
+  zVec3DFlatTreeVicinity( &tree, &v, radius, &vicinity2 );
+  result_vicinity = cmp_vec_data( &vicinity1, &vicinity2 );
+  zVec3DDataDestroy( &vicinity1 );
+  zVec3DDataDestroy( &vicinity2 );
+  zVec3DFlatTreeDestroy( &tree );
+  zVec3DDataDestroy( &pointdata );
+  zAssert( zVec3DFlatTreeNN, result_nn );
+  zAssert( zVec3DFlatTreePointID, result_id );
+  zAssert( zVec3DFlatTreeVicinity, result_vicinity );
+}
+
+void assert_flatoctree(void)
+{
+  zVec3DOctree octree;
+  zVec3DFlatOctree tree;
+  zVec3DData pointdata, vicinity1, vicinity2;
+  const zVec3DOctant *octant;
+  const zVec3DFlatOctreeLeaf *leaf;
+  zVec3D v, c;
+  const int ns = 1000;
+  int i, k;
+  bool result_leaf = true, result_norm = true, result_container = true, result_vicinity = true;
+  const double radius = 3.0;
+
+  /* points on a sphere */
+  zVec3DDataInitArray( &pointdata, ns );
+  for( i=0; i<zVec3DDataCapacity(&pointdata); i++ ){
+    zVec3DCreate( &v, zRandF(-1,1), zRandF(-1,1), zRandF(-1,1) );
+    zVec3DNormalizeDRC( &v );
+    zVec3DMulDRC( &v, 5 );
+    zVec3DDataAdd( &pointdata, &v );
+  }
+  zVec3DOctreeInit( &octree, -10, -10, -10, 10, 10, 10, 1 );
+  zVec3DOctreeAddData( &octree, &pointdata );
+  zVec3DOctreeUpdateNormal( &octree );
+  zVec3DDataToFlatOctree( &pointdata, &tree, -10, -10, -10, 10, 10, 10, 1 );
+  /* leaves */
+  for( i=0; i<tree.leaf_num; i++ ){
+    leaf = &tree.leaf[i];
+    octant = zVec3DOctreeFindContainer( &octree, zVec3DFlatOctreeLeafPoint(&tree,leaf,0) );
+    if( !octant || zListSize(&octant->points) != leaf->num ||
+        !zMat3DEqual( &octant->_ncov, &leaf->ncov ) ){
+      result_leaf = false;
+      continue;
+    }
+    if( leaf->num < 5 ) continue;
+    zVec3DZero( &c );
+    for( k=0; k<leaf->num; k++ )
+      zVec3DAddDRC( &c, zVec3DFlatOctreeLeafPoint(&tree,leaf,k) );
+    if( !zIsTol( fabs( zVec3DInnerProd( &octant->_norm, &leaf->norm ) ) - 1, 1.0e-6 ) ||
+        zVec3DInnerProd( &leaf->norm, &c ) < 0 ) result_norm = false;
+  }
+  for( k=0; k<100; k++ ){
+    zVec3DCreate( &v, zRandF(-10,10), zRandF(-10,10), zRandF(-10,10) );
+    /* container */
+    if( ( leaf = zVec3DFlatOctreeFindContainer( &tree, &v ) ) &&
+        ( !( octant = zVec3DOctreeFindContainer( &octree, &v ) ) ||
+          zListSize(&octant->points) != leaf->num ) ) result_container = false;
+    /* vicinity */
+    zVec3DOctreeVicinity( &octree, &v, radius, &vicinity1 );
+    zVec3DFlatOctreeVicinity( &tree, &v, radius, &vicinity2 );
+    if( !cmp_vec_data( &vicinity1, &vicinity2 ) ) result_vicinity = false;
+    zVec3DDataDestroy( &vicinity1 );
+    zVec3DDataDestroy( &vicinity2 );
+  }
+  zVec3DFlatOctreeDestroy( &tree );
+  zVec3DOctreeDestroy( &octree );
+  zVec3DDataDestroy( &pointdata );
+  zAssert( zVec3DDataToFlatOctree (leaves), result_leaf );
+  zAssert( zVec3DDataToFlatOctree (normal vectors), result_norm );
+  zAssert( zVec3DFlatOctreeFindContainer, result_container );
+  zAssert( zVec3DFlatOctreeVicinity, result_vicinity );
+}
+
+#define K 10
+
+bool cmp_knn(int n1, zVec3D *nn1[], double dist1[], int n2, zVec3D *nn2[], double dist2[])
+{
+  int i;
+
+  if( n1 != n2 ) return false;
+  for( i=0; i<n1; i++ )
+    if( !zVec3DEqual( nn1[i], nn2[i] ) || !zIsTiny( dist1[i] - dist2[i] ) ) return false;
+  return true;
+}
+
+void assert_knn(void)
+{
+  zVec3DOctree octree;
+  zVec3DTree tree;
+  zVec3DFlatTree flattree;
+  zVec3DFlatOctree flatoctree;
+  zVec3DData pointdata;
+  const int ns = 1000;
+  int i, k, n;
+  zVec3D v, *nn_data[K], *nn[K];
+  double dist_data[K], dist[K];
+  bool result_kdtree = true, result_octree = true, result_flattree = true, result_flatoctree = true;
+  const double resolution = 0.5;
+  const double xmin = -10, xmax = 10, ymin = -10, ymax = 10, zmin = -10, zmax = 10;
+
+  zVec3DDataInitArray( &pointdata, ns );
+  for( i=0; i<zVec3DDataCapacity(&pointdata); i++ ){
+    zVec3DCreate( &v, zRandF(xmin,xmax), zRandF(ymin,ymax), zRandF(zmin,zmax) );
+    zVec3DDataAdd( &pointdata, &v );
+  }
+  zVec3DOctreeInit( &octree, xmin, ymin , zmin, xmax, ymax, zmax, resolution );
+  zVec3DOctreeAddData( &octree, &pointdata );
+  zVec3DTreeInit( &tree );
+  zVec3DTreeAddData( &tree, &pointdata );
+  zVec3DDataToFlatTree( &pointdata, &flattree, 0 );
+  zVec3DDataToFlatOctree( &pointdata, &flatoctree, xmin, ymin, zmin, xmax, ymax, zmax, resolution );
+  for( k=0; k<100; k++ ){
+    zVec3DCreate( &v, zRandF(xmin,xmax), zRandF(ymin,ymax), zRandF(zmin,zmax) );
+    n = zVec3DDataKNN( &pointdata, &v, K, nn_data, dist_data );
+    if( !cmp_knn( n, nn_data, dist_data, zVec3DTreeKNN( &tree, &v, K, nn, dist ), nn, dist ) ) result_kdtree = false;
+    if( !cmp_knn( n, nn_data, dist_data, zVec3DOctreeKNN( &octree, &v, K, nn, dist ), nn, dist ) ) result_octree = false;
+    if( !cmp_knn( n, nn_data, dist_data, zVec3DFlatTreeKNN( &flattree, &v, K, nn, dist ), nn, dist ) ) result_flattree = false;
+    if( !cmp_knn( n, nn_data, dist_data, zVec3DFlatOctreeKNN( &flatoctree, &v, K, nn, dist ), nn, dist ) ) result_flatoctree = false;
+  }
+  zVec3DTreeDestroy( &tree );
+  zVec3DOctreeDestroy( &octree );
+  zVec3DFlatTreeDestroy( &flattree );
+  zVec3DFlatOctreeDestroy( &flatoctree );
+  zVec3DDataDestroy( &pointdata );
+  zAssert( zVec3DTreeKNN, result_kdtree );
+  zAssert( zVec3DOctreeKNN, result_octree );
+  zAssert( zVec3DFlatTreeKNN, result_flattree );
+  zAssert( zVec3DFlatOctreeKNN, result_flatoctree );
+}
+
 void assert_vec_tree_to_array(void)
 {
   zVec3DArray array1, array2;
@@ -216,6 +372,9 @@ int main(int argc, char *argv[])
   zRandInit();
   assert_nn();
   assert_vicinity();
+  assert_flattree();
+  assert_flatoctree();
+  assert_knn();
   assert_vec_tree_to_array();
   assert_vec_tree_to_list();
   assert_vec_tree_to_data();